@@ -1,46 +1,54 @@
 #version 330 core
 
-const int MAX_BONES = 64;
+#pragma features INSTANCED
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
-uniform mat4 boneTransformation[MAX_BONES];
-uniform mat4 lightSpaceMatrix;
 
 layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 normal;
+layout(location = 1) in vec2 normal;
 layout(location = 2) in vec2 textureCoords;
 layout(location = 3) in vec4 boneWeights;
 layout(location = 4) in vec4 boneIds;
+layout(location = 9) in mat4 instanceModel;
 
 out vec3 fragPosition_o;
 out vec3 position_o;
 out vec3 normal_o;
 out vec2 textureCoords_o;
-out vec4 fragmentPositionLightSpace_o;
+
+#include "include/normals.glsl"
+#include "include/bones.glsl"
 
 void main() {
 
+#ifdef INSTANCED
+    mat4 modelMatrix = instanceModel;
+#else
+    mat4 modelMatrix = model;
+#endif
+
     //Transform the vertex information based on bones.
     //We use vec4(position, 1.0) because boneTransformation is a mat4, and you can't multiply a vec3 with a mat4.
-    vec3 pos =  (boneWeights.x * (boneTransformation[int(boneIds.x)] * vec4(position, 1.0)).xyz) + 
-                (boneWeights.y * (boneTransformation[int(boneIds.y)] * vec4(position, 1.0)).xyz) + 
-                (boneWeights.z * (boneTransformation[int(boneIds.z)] * vec4(position, 1.0)).xyz) + 
-                (boneWeights.w * (boneTransformation[int(boneIds.w)] * vec4(position, 1.0)).xyz);
+    vec3 pos =  (boneWeights.x * (getBoneTransformation(boneIds.x) * vec4(position, 1.0)).xyz) + 
+                (boneWeights.y * (getBoneTransformation(boneIds.y) * vec4(position, 1.0)).xyz) + 
+                (boneWeights.z * (getBoneTransformation(boneIds.z) * vec4(position, 1.0)).xyz) + 
+                (boneWeights.w * (getBoneTransformation(boneIds.w) * vec4(position, 1.0)).xyz);
+
+    vec3 unpackedNormal = decodeNormal(normal);
 
     //Calculate the normals based on bones
-    vec3 norm = (boneWeights.x * (boneTransformation[int(boneIds.x)] * vec4(normal, 0.0)).xyz) + 
-                (boneWeights.y * (boneTransformation[int(boneIds.y)] * vec4(normal, 0.0)).xyz) + 
-                (boneWeights.z * (boneTransformation[int(boneIds.z)] * vec4(normal, 0.0)).xyz) + 
-                (boneWeights.w * (boneTransformation[int(boneIds.w)] * vec4(normal, 0.0)).xyz);
+    vec3 norm = (boneWeights.x * (getBoneTransformation(boneIds.x) * vec4(unpackedNormal, 0.0)).xyz) + 
+                (boneWeights.y * (getBoneTransformation(boneIds.y) * vec4(unpackedNormal, 0.0)).xyz) + 
+                (boneWeights.z * (getBoneTransformation(boneIds.z) * vec4(unpackedNormal, 0.0)).xyz) + 
+                (boneWeights.w * (getBoneTransformation(boneIds.w) * vec4(unpackedNormal, 0.0)).xyz);
 
     //Supply outputs
-    position_o                   = (view * model * vec4(pos, 1.0)).xyz;
-    normal_o                     = mat3(transpose(inverse(model))) * norm;
+    position_o                   = (view * modelMatrix * vec4(pos, 1.0)).xyz;
+    normal_o                     = mat3(transpose(inverse(modelMatrix))) * norm;
     textureCoords_o              = textureCoords;
-    fragPosition_o               = vec3(model * vec4(pos, 1.0f));
-    fragmentPositionLightSpace_o = lightSpaceMatrix * vec4(fragPosition_o, 1.0);
+    fragPosition_o               = vec3(modelMatrix * vec4(pos, 1.0f));
    
-    gl_Position = projection * view * model * vec4(pos, 1.0f);
+    gl_Position = projection * view * modelMatrix * vec4(pos, 1.0f);
 }
@@ -1,8 +1,8 @@
 #version 330 core
 
-in vec3 color_o;
+in vec4 color_o;
 out vec4 color;
 
 void main() {
-    color = vec4(color_o, 1);
+    color = color_o;
 }
\ No newline at end of file
@@ -1,53 +1,23 @@
 #version 330 core
 
-//**********************************************
-//These macros are modified on runtime.
-//the /*TAG*/ before the value tells the
-//compiler what value needs to be set and where.
-//***********************************************
+#pragma features SHADOWS
 
-#define AMOUNT_OF_POINT_LIGHTS /*MAL*/ 4 //
-#define SHADOW_INTENSITY /*SI*/ 5 //
-#define SHADOW_FILTERING /*SF*/ 5 //
-
-const float shadowFade = 1;
+#include "include/lights.glsl"
 
 struct Material {
     sampler2D texture_diffuse1;
     sampler2D texture_specular1;
     float shininess;
 };
-struct DirectionalLight {
-    vec3 direction;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-struct PointLight {
-    vec3 position;
-
-    float constant;
-    float linear;
-    float quadratic;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
 
 uniform PointLight pointLights[AMOUNT_OF_POINT_LIGHTS];
 
 uniform DirectionalLight directionalLight;
 
 uniform Material material;
-uniform samplerCube pointShadowMap;
-uniform sampler2D directionalShadowMap;
-uniform float farPlane;
 uniform vec3 viewPosition;
-uniform vec3 lightPosition;
 
-in vec4 fragmentPositionLightSpace_o;
+in vec3 position_o;
 in vec2 textureCoords_o;
 in vec3 normal_o;
 in vec3 fragPosition_o;
@@ -57,21 +27,9 @@ out vec4 color;
 vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir);
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shadowCalculation);
 
-vec3 sampleOffsetDirections[20] = vec3[](
-    vec3(1, 1, 0), vec3(1, -1, 0), vec3(-1, -1, 0), vec3(-1, 1, 0),
-    vec3(1, 0, 1), vec3(-1, 0, 1), vec3(1, 0, -1), vec3(-1, 0, -1),
-    vec3(0, 1, 1), vec3(0, -1, 1), vec3(0, -1, -1), vec3(0, 1, -1),
-    vec3(1, 1, 1), vec3(1, -1, 1), vec3(-1, -1, 1), vec3(-1, 1, 1),
-    vec3(1, 1, -1), vec3(1, -1, -1), vec3(-1, -1, -1), vec3(-1, 1, -1));
-
-float fadeShadowOverDistance(vec2 shadowCoord) {
-    vec4 coord = vec4(shadowCoord, 1. - shadowCoord);
-    vec4 mu    = clamp(coord / shadowFade, 0., 1.);
-    vec2 mu2   = min(mu.xy, mu.zw);
-    return min(mu2.x, mu2.y);
-}
+#include "include/shadows.glsl"
 
-float directionalShadowCalculation(vec4 fragPosLightSpace) {
+float directionalShadowCalculation(sampler2D directionalShadowMap, vec4 fragPosLightSpace) {
     vec3 projCoords = (fragPosLightSpace.xyz / fragPosLightSpace.w) * 0.5f + 0.5f;
 
     float bias       = max(0.0003 * (1.0 - dot(normal_o, directionalLight.direction)), .00015);
@@ -98,15 +56,15 @@ float directionalShadowCalculation(vec4 fragPosLightSpace) {
     return shadow;
 }
 
-float pointLightShadowCalculation(vec3 fragPos, PointLight pointLight) {
-    vec3 fragToLight   = fragPos - pointLight.position;
+float pointLightShadowCalculation(vec3 fragPos, int light) {
+    vec3 fragToLight   = fragPos - pointLights[light].position;
     float currentDepth = length(fragToLight);
     float shadow       = 0.0;
     float bias         = 0.15;
     float viewDistance = length(viewPosition - fragPos);
     float diskRadius   = 0.05;
     for (int i = 0; i < SHADOW_FILTERING; ++i) {
-        float closestDepth = texture(pointShadowMap, fragToLight + sampleOffsetDirections[i] * diskRadius).r;
+        float closestDepth = samplePointShadowAtlas(light, fragToLight + sampleOffsetDirections[i] * diskRadius);
         closestDepth *= farPlane;
         if (currentDepth - bias > closestDepth) {
             shadow += 1.0;
@@ -133,7 +91,7 @@ vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir) {
     vec3 diffuse  = light.diffuse * diff * vec3(texture(material.texture_diffuse1, textureCoords_o));
     vec3 specular = .04f * light.specular * spec;
 
-    return (ambient + (1.0 - directionalShadowCalculation(fragmentPositionLightSpace_o)) * (diffuse + specular));
+    return (ambient + (1.0 - cascadedShadowCalculation()) * (diffuse + specular));
 }
 
 // Calculates the color when using a point light.
@@ -165,10 +123,9 @@ void main() {
     // Phase 1: Directional lighting
     vec3 result = CalcDirLight(directionalLight, norm, viewDir);
 
-    float pointLightShadow = (1.0f - pointLightShadowCalculation(fragPosition_o, pointLights[0]));
-
     // Phase 2: Point lights
     for (int i = 0; i < AMOUNT_OF_POINT_LIGHTS; i++) {
+        float pointLightShadow = i < amountOfShadowedPointLights ? (1.0f - pointLightShadowCalculation(fragPosition_o, i)) : 1.0f;
         result += CalcPointLight(pointLights[i], norm, fragPosition_o, viewDir, pointLightShadow / AMOUNT_OF_POINT_LIGHTS);
     }
 
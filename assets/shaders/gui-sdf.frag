@@ -0,0 +1,24 @@
+#version 330 core
+
+//Draws text from a signed distance field atlas (see SdfFont.h). Use it with gui-shader.vert.
+//The atlas' alpha is the distance to the glyph's edge, 0.5 being the edge, so the edge stays sharp at any scale.
+
+struct Material {
+    sampler2D texture_diffuse1;
+};
+
+uniform Material material;
+
+in vec2 textureCoords_o;
+
+out vec4 color;
+
+void main() {
+    vec4 texel = texture(material.texture_diffuse1, textureCoords_o);
+
+    //Smooths the edge over about a screen pixel, however much the atlas is scaled.
+    float smoothing = fwidth(texel.a) * 0.75f;
+    float alpha     = smoothstep(0.5f - smoothing, 0.5f + smoothing, texel.a);
+
+    color = vec4(texel.rgb, alpha);
+}
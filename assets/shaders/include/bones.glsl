@@ -0,0 +1,15 @@
+uniform int bonePaletteOffset;
+uniform int bonesPerInstance;
+uniform samplerBuffer bonePalettes;
+
+//Bones are read from the bone palette texture buffer (4 texels per matrix), uploaded once per frame.
+//Instanced draws store the palettes of their instances one after another.
+mat4 getBoneTransformation(float boneId) {
+    int texel = (bonePaletteOffset + gl_InstanceID * bonesPerInstance + int(boneId)) * 4;
+
+    return mat4(
+        texelFetch(bonePalettes, texel),
+        texelFetch(bonePalettes, texel + 1),
+        texelFetch(bonePalettes, texel + 2),
+        texelFetch(bonePalettes, texel + 3));
+}
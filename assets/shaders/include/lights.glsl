@@ -0,0 +1,31 @@
+//The Shader class defines these from the Settings, the values here are only used without them.
+#ifndef AMOUNT_OF_POINT_LIGHTS
+#define AMOUNT_OF_POINT_LIGHTS 4
+#endif
+
+#ifndef SHADOW_INTENSITY
+#define SHADOW_INTENSITY 5
+#endif
+
+#ifndef SHADOW_FILTERING
+#define SHADOW_FILTERING 5
+#endif
+
+struct DirectionalLight {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+struct PointLight {
+    vec3 position;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
@@ -0,0 +1,8 @@
+//Normals are octahedral encoded to save vertex bandwidth (see VertexFormat.cpp).
+vec3 decodeNormal(vec2 encoded) {
+    vec3 n     = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-n.z, 0.0);
+    n.x       += n.x >= 0.0 ? -fold : fold;
+    n.y       += n.y >= 0.0 ? -fold : fold;
+    return normalize(n);
+}
@@ -0,0 +1,90 @@
+//Expects position_o and fragPosition_o to be declared, and directionalShadowCalculation to be defined by the includer.
+//Without the SHADOWS feature nothing is shadowed and the shadow maps are never sampled.
+
+//Must match PointLightShadowMap::MAX_LIGHTS.
+#define MAX_SHADOWED_POINT_LIGHTS 4
+
+//Must match DirectionalLightShadowMap::AMOUNT_OF_CASCADES.
+#define AMOUNT_OF_CASCADES 3
+
+const float shadowFade = 1;
+
+uniform sampler2DArray pointShadowMap;
+uniform float pointShadowScales[MAX_SHADOWED_POINT_LIGHTS];
+uniform sampler2D directionalShadowMaps[AMOUNT_OF_CASCADES];
+uniform mat4 lightSpaceMatrices[AMOUNT_OF_CASCADES];
+uniform float cascadeSplits[AMOUNT_OF_CASCADES];
+uniform float farPlane;
+
+#ifdef SHADOWS
+uniform int amountOfShadowedPointLights;
+#else
+const int amountOfShadowedPointLights = 0;
+#endif
+
+float directionalShadowCalculation(sampler2D directionalShadowMap, vec4 fragPosLightSpace);
+
+// array of offset direction for sampling
+vec3 sampleOffsetDirections[20] = vec3[](
+    vec3(1, 1, 0), vec3(1, -1, 0), vec3(-1, -1, 0), vec3(-1, 1, 0),
+    vec3(1, 0, 1), vec3(-1, 0, 1), vec3(1, 0, -1), vec3(-1, 0, -1),
+    vec3(0, 1, 1), vec3(0, -1, 1), vec3(0, -1, -1), vec3(0, 1, -1),
+    vec3(1, 1, 1), vec3(1, -1, 1), vec3(-1, -1, 1), vec3(-1, 1, 1),
+    vec3(1, 1, -1), vec3(1, -1, -1), vec3(-1, -1, -1), vec3(-1, 1, -1));
+
+float fadeShadowOverDistance(vec2 shadowCoord) {
+    vec4 coord = vec4(shadowCoord, 1. - shadowCoord);
+    vec4 mu    = clamp(coord / shadowFade, 0., 1.);
+    vec2 mu2   = min(mu.xy, mu.zw);
+    return min(mu2.x, mu2.y);
+}
+
+//Picks the cascade covering the fragment's distance from the camera.
+//Arrays of samplers can only be indexed with constants in this version, hence the branches.
+float cascadedShadowCalculation() {
+#ifdef SHADOWS
+    float viewDepth   = -position_o.z;
+    vec4 fragPosition = vec4(fragPosition_o, 1.0);
+
+    if (viewDepth < cascadeSplits[0]) {
+        return directionalShadowCalculation(directionalShadowMaps[0], lightSpaceMatrices[0] * fragPosition);
+    }
+    if (viewDepth < cascadeSplits[1]) {
+        return directionalShadowCalculation(directionalShadowMaps[1], lightSpaceMatrices[1] * fragPosition);
+    }
+    if (viewDepth < cascadeSplits[2]) {
+        return directionalShadowCalculation(directionalShadowMaps[2], lightSpaceMatrices[2] * fragPosition);
+    }
+#endif
+
+    return 0.0;
+}
+
+//The atlas stores the six cube faces of every shadowed light, so the face the direction points at is picked here.
+float samplePointShadowAtlas(int light, vec3 direction) {
+    vec3 absDirection = abs(direction);
+    float majorAxis;
+    vec2 coords;
+    int face;
+
+    if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z) {
+        face      = direction.x > 0.0 ? 0 : 1;
+        majorAxis = absDirection.x;
+        coords    = vec2(direction.x > 0.0 ? -direction.z : direction.z, -direction.y);
+    } else if (absDirection.y >= absDirection.z) {
+        face      = direction.y > 0.0 ? 2 : 3;
+        majorAxis = absDirection.y;
+        coords    = vec2(direction.x, direction.y > 0.0 ? direction.z : -direction.z);
+    } else {
+        face      = direction.z > 0.0 ? 4 : 5;
+        majorAxis = absDirection.z;
+        coords    = vec2(direction.z > 0.0 ? direction.x : -direction.x, -direction.y);
+    }
+
+    //Lights rendered below the atlas resolution only fill the corner of their layers.
+    float scale    = pointShadowScales[light];
+    vec2 halfTexel = 0.5 / (vec2(textureSize(pointShadowMap, 0).xy) * scale);
+    coords         = clamp((coords / majorAxis) * 0.5 + 0.5, halfTexel, 1.0 - halfTexel) * scale;
+
+    return texture(pointShadowMap, vec3(coords, float(light * 6 + face))).r;
+}
@@ -0,0 +1,81 @@
+#version 330 core
+
+//Advances every particle of a GpuFountain emitter by one frame. The outputs are captured with transform feedback,
+//in the same order as the GpuParticle struct (see Particles.h), and nothing is rasterized.
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in float size;
+layout(location = 2) in vec3 speed;
+layout(location = 3) in float lifeTime;
+layout(location = 4) in vec4 color;
+
+//Must match GpuParticleSystem::SpawnBlock.
+layout(std140) uniform ParticleSpawn {
+    vec4 emission; //xyz = position, w = life time
+    vec4 spawnColor;
+    vec4 acceleration; //xyz = half of wind and gravity, w = delta time
+    vec4 spawnParameters; //x = start scale, y = alpha faded per second
+    uvec4 spawnSlots; //x = first slot, y = amount of slots, z = capacity, w = seed
+};
+
+out vec3 position_o;
+out float size_o;
+out vec3 speed_o;
+out float lifeTime_o;
+out vec4 color_o;
+
+uint hash(uint x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+//From 0 (inclusive) to 1 (exclusive).
+float random(inout uint state) {
+    state = hash(state);
+    return float(state >> 8) / 16777216.0;
+}
+
+void main() {
+    uint slot      = uint(gl_VertexID);
+    float dt       = acceleration.w;
+    uint fromFirst = (slot + spawnSlots.z - spawnSlots.x) % spawnSlots.z;
+
+    //Slots in the spawn range are reused even if their particle is still alive, they hold the oldest particles.
+    if (fromFirst < spawnSlots.y) {
+        uint state = slot ^ spawnSlots.w;
+
+        speed_o.x = random(state) * 10.0 - 5.0;
+        speed_o.y = random(state) * 2.0 + 8.0;
+        speed_o.z = random(state) * 10.0 - 5.0;
+
+        position_o = emission.xyz;
+        lifeTime_o = emission.w;
+        size_o     = spawnParameters.x;
+        color_o    = spawnColor;
+        return;
+    }
+
+    lifeTime_o = lifeTime - dt;
+
+    //Dead particles keep a size of 0 so they aren't visible.
+    if (lifeTime_o <= 0.0) {
+        position_o = position;
+        speed_o    = speed;
+        size_o     = 0.0;
+        color_o    = color;
+        return;
+    }
+
+    //Same as FountainParticleSystem::performParticleCalculations.
+    vec3 newSpeed = speed + acceleration.xyz * dt;
+    position_o    = position + newSpeed * dt;
+    newSpeed.y -= dt * 5.0;
+
+    speed_o = newSpeed;
+    size_o  = size + dt * 0.4;
+    color_o = vec4(color.rgb, max(color.a - spawnParameters.y * dt, 0.0));
+}
@@ -1,17 +1,10 @@
 #version 330 core
 
-//**********************************************
-//These macros are modified on runtime.
-//the /*TAG*/ before the value tells the
-//compiler what value needs to be set and where.
-//***********************************************
+#pragma features SHADOWS
 
-#define AMOUNT_OF_POINT_LIGHTS /*MAL*/ 4 //
-#define SHADOW_INTENSITY /*SI*/ 5 //
-#define SHADOW_FILTERING /*SF*/ 5 //
-#define SHADOW_FILTER_DISTANCE /*SFD*/ 1.2 //
+#include "include/lights.glsl"
 
-const float shadowFade = 1;
+#define SHADOW_FILTER_DISTANCE 1.2
 
 struct Material {
     vec3 ambient;
@@ -20,35 +13,13 @@ struct Material {
 
     float shininess;
 };
-struct DirectionalLight {
-    vec3 direction;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-struct PointLight {
-    vec3 position;
-
-    float constant;
-    float linear;
-    float quadratic;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
 
 uniform PointLight pointLights[AMOUNT_OF_POINT_LIGHTS];
 uniform DirectionalLight directionalLight;
 uniform Material material;
-uniform samplerCube pointShadowMap;
-uniform sampler2D directionalShadowMap;
-uniform float farPlane;
 uniform vec3 viewPosition;
-uniform vec3 lightPosition;
 
-in vec4 fragmentPositionLightSpace_o;
+in vec3 position_o;
 in vec2 textureCoords_o;
 in vec3 normal_o;
 in vec3 fragPosition_o;
@@ -58,22 +29,9 @@ out vec4 color;
 vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir);
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shadowCalculation);
 
-// array of offset direction for sampling
-vec3 sampleOffsetDirections[20] = vec3[](
-    vec3(1, 1, 0), vec3(1, -1, 0), vec3(-1, -1, 0), vec3(-1, 1, 0),
-    vec3(1, 0, 1), vec3(-1, 0, 1), vec3(1, 0, -1), vec3(-1, 0, -1),
-    vec3(0, 1, 1), vec3(0, -1, 1), vec3(0, -1, -1), vec3(0, 1, -1),
-    vec3(1, 1, 1), vec3(1, -1, 1), vec3(-1, -1, 1), vec3(-1, 1, 1),
-    vec3(1, 1, -1), vec3(1, -1, -1), vec3(-1, -1, -1), vec3(-1, 1, -1));
-
-float fadeShadowOverDistance(vec2 shadowCoord) {
-    vec4 coord = vec4(shadowCoord, 1. - shadowCoord);
-    vec4 mu    = clamp(coord / shadowFade, 0., 1.);
-    vec2 mu2   = min(mu.xy, mu.zw);
-    return min(mu2.x, mu2.y);
-}
+#include "include/shadows.glsl"
 
-float directionalShadowCalculation(vec4 fragPosLightSpace) {
+float directionalShadowCalculation(sampler2D directionalShadowMap, vec4 fragPosLightSpace) {
     vec3 projCoords  = (fragPosLightSpace.xyz / fragPosLightSpace.w) * 0.5f + 0.5f;
     float bias       = max(0.001f * (1.0f - dot(normalize(normal_o), normalize(directionalLight.direction))), 0.002f);
     float shadow     = 0.0f;
@@ -98,8 +56,8 @@ float directionalShadowCalculation(vec4 fragPosLightSpace) {
     return shadow;
 }
 
-float pointLightShadowCalculation(vec3 fragPos) {
-    vec3 fragToLight   = fragPos - lightPosition;
+float pointLightShadowCalculation(vec3 fragPos, int light) {
+    vec3 fragToLight   = fragPos - pointLights[light].position;
     float currentDepth = length(fragToLight);
     float shadow       = 0.0f;
     float bias         = 0.15f;
@@ -107,7 +65,7 @@ float pointLightShadowCalculation(vec3 fragPos) {
     float diskRadius   = (1.0f + (viewDistance / farPlane)) / 25.0f * SHADOW_FILTER_DISTANCE;
 
     for (int i = 0; i < SHADOW_FILTERING; ++i) {
-        float closestDepth = texture(pointShadowMap, fragToLight + sampleOffsetDirections[i] * diskRadius).r;
+        float closestDepth = samplePointShadowAtlas(light, fragToLight + sampleOffsetDirections[i] * diskRadius);
         closestDepth *= farPlane;
 
         if (currentDepth - bias > closestDepth) {
@@ -130,7 +88,7 @@ vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir) {
     vec3 diffuse  = light.diffuse * (diff * material.diffuse);
     vec3 specular = light.specular * (spec * material.specular);
 
-    return (ambient + (1.0f - directionalShadowCalculation(fragmentPositionLightSpace_o)) * (diffuse + specular));
+    return (ambient + (1.0f - cascadedShadowCalculation()) * (diffuse + specular));
 }
 
 // Calculates the color when using a point light.
@@ -166,8 +124,8 @@ void main() {
     vec3 result = CalcDirLight(directionalLight, norm, viewDir);
 
     // Phase 2: Point lights
-    float pointLightShadow = (1.0f - pointLightShadowCalculation(fragPosition_o) / float(AMOUNT_OF_POINT_LIGHTS));
     for (int i = 0; i < AMOUNT_OF_POINT_LIGHTS; i++) {
+        float pointLightShadow = i < amountOfShadowedPointLights ? (1.0f - pointLightShadowCalculation(fragPosition_o, i) / float(AMOUNT_OF_POINT_LIGHTS)) : 1.0f;
         result += CalcPointLight(pointLights[i], norm, fragPosition_o, viewDir, pointLightShadow);
     }
 
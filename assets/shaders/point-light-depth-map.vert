@@ -1,25 +1,31 @@
 #version 330 core
+
+#pragma features ANIMATED INSTANCED
+
 layout(location = 0) in vec3 position;
 layout(location = 3) in vec4 boneWeights;
 layout(location = 4) in vec4 boneIds;
-
-const int MAX_BONES = 64;
+layout(location = 9) in mat4 instanceModel;
 
 uniform mat4 model;
-uniform bool isAnimated;
-uniform mat4 boneTransformation[MAX_BONES];
+
+#include "include/bones.glsl"
 
 void main() {
     vec3 pos = position;
 
-    //To get rid of this if statement, the vec4(position) will need to be multiplied by one so it does not equal zero.
-    if (isAnimated) {
+#ifdef ANIMATED
+    pos =   (boneWeights.x * (getBoneTransformation(boneIds.x) * vec4(position, 1.0)).xyz) + 
+            (boneWeights.y * (getBoneTransformation(boneIds.y) * vec4(position, 1.0)).xyz) + 
+            (boneWeights.z * (getBoneTransformation(boneIds.z) * vec4(position, 1.0)).xyz) + 
+            (boneWeights.w * (getBoneTransformation(boneIds.w) * vec4(position, 1.0)).xyz);
+#endif
 
-        pos =   (boneWeights.x * (boneTransformation[int(boneIds.x)] * vec4(position, 1.0)).xyz) + 
-                (boneWeights.y * (boneTransformation[int(boneIds.y)] * vec4(position, 1.0)).xyz) + 
-                (boneWeights.z * (boneTransformation[int(boneIds.z)] * vec4(position, 1.0)).xyz) + 
-                (boneWeights.w * (boneTransformation[int(boneIds.w)] * vec4(position, 1.0)).xyz);
-    }
+#ifdef INSTANCED
+    mat4 modelMatrix = instanceModel;
+#else
+    mat4 modelMatrix = model;
+#endif
 
-    gl_Position = model * vec4(pos, 1.0);
+    gl_Position = modelMatrix * vec4(pos, 1.0);
 }
@@ -7,21 +7,39 @@ struct Material {
 uniform Material material;
 uniform int MultisampleCount;
 
+//Below 1 when the scene was rendered at a lower resolution than the window.
+uniform float renderScale;
+
 in vec2 textureCoords_o;
 
 out vec4 FragColor;
 
-void main(){ 
-    vec2 texSize = textureSize(material.texture_diffuse1);
-    ivec2 texCoord = ivec2(textureCoords_o * texSize);
+vec4 resolveTexel(ivec2 texCoord, ivec2 texSize) {
+    texCoord = clamp(texCoord, ivec2(0), texSize - 1);
 
     vec4 color = vec4(0.0);
 
     for (int i = 0; i < MultisampleCount; i++)
         color += texelFetch(material.texture_diffuse1, texCoord, i);
 
-    color /= float(MultisampleCount);
+    return color / float(MultisampleCount);
+}
+
+void main(){ 
+    ivec2 texSize = textureSize(material.texture_diffuse1);
+
+    if (renderScale >= 1.0) {
+        FragColor = resolveTexel(ivec2(textureCoords_o * texSize), texSize);
+        return;
+    }
+
+    //Multisampled textures can't be filtered, so the resolved texels are blended by hand when upscaling.
+    vec2 position  = textureCoords_o * texSize - 0.5;
+    ivec2 texCoord = ivec2(floor(position));
+    vec2 weights   = position - floor(position);
 
+    vec4 top    = mix(resolveTexel(texCoord, texSize), resolveTexel(texCoord + ivec2(1, 0), texSize), weights.x);
+    vec4 bottom = mix(resolveTexel(texCoord + ivec2(0, 1), texSize), resolveTexel(texCoord + ivec2(1, 1), texSize), weights.x);
 
-    FragColor = color;
-}
\ No newline at end of file
+    FragColor = mix(top, bottom, weights.y);
+}
@@ -121,6 +121,12 @@ void Engine::Game::loadScene(unsigned int index) {
     for (unsigned int i = 0; i < subSystemsAsBase.size(); i++) {
         subSystemsAsBase.at(i)->initialize(*scene, *systemVitals);
     }
+    //The new scene's assets are referenced by now, so only the ones the old scene alone used are freed.
+    //Shaders stay loaded for the whole run, components keep copies of them that can't be tracked.
+    ModelLocator::getService().freeUnreferencedModels();
+    TextureLocator::getService().freeUnreferencedTextures();
+    SoundLocator::getService().freeUnreferencedSounds();
+    MusicLocator::getService().freeUnreferencedMusic();
 }
 
 void Engine::Game::readBackendEventQueue() {
@@ -155,6 +161,9 @@ void Engine::Game::render() {
         return;
     }
 
+    //Shaders are compiled together after a scene asked for all of them, the first frame waits for them.
+    ShaderLocator::getService().finishPendingShaders();
+
     renderingSystem.render(*systemVitals);
 }
 
@@ -170,6 +179,8 @@ void Engine::Game::freeEntities() {
 }
 
 void Engine::Game::uninitialize() {
+    renderingSystem.uninitialize();
+
     delete scene;
     delete physicsWorld;
     delete systemVitals;
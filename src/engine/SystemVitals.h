@@ -2,6 +2,7 @@
 #define SYSTEM_VITALS_H
 #include "DirectionalLightShadowMap.h"
 #include "GameState.h"
+#include "GpuProfiler.h"
 #include "LTime.h"
 #include "PhysicsWorld.h"
 #include "PointLightShadowMap.h"
@@ -31,14 +32,16 @@ namespace Engine {
         //!Initializes the text maps.
         void initializeTextMaps() {
             textMap.createMap("assets/fonts/courier-new.FontDat");
+            sdfTextMap.createMap("assets/fonts/courier-new-sdf.FontDat");
         }
 
-        //!Sets shaders for depth map shader tasks and initializes depth maps and render textures.
+        //!Sets shaders for depth map shader tasks and initializes depth maps, render textures and the GPU profiler.
         void initializeDepthMaps() {
 
             directionalLightDepthMap.initialize();
             pointLightDepthMap.initialize();
             renderTexture.initialize(GameInfo::getWindowWidth(), GameInfo::getWindowHeight());
+            gpuProfiler.initialize();
 
             Shader::setShaderTaskShader(SHADER_TASK::Directional_Depth_Task, directionalLightDepthMap.getDepthMapShader());
             Shader::setShaderTaskShader(SHADER_TASK::Omnidirectional_Depth_Task, pointLightDepthMap.getDepthMapShader());
@@ -55,20 +58,25 @@ namespace Engine {
 
         //We can always add more font atlases
         inline TextMap& getTextMap() { return textMap; }
+        //!The glyphs of courier-new-sdf.png, a signed distance field atlas built by the sdf_font_tool.
+        inline TextMap& getSdfTextMap() { return sdfTextMap; }
         inline Settings& getSettings() { return settings; }
         inline PointLightShadowMap& getPointShadowMap() { return pointLightDepthMap; }
         inline DirectionalLightShadowMap& getDirectionalShadowMap() { return directionalLightDepthMap; }
         inline RenderTextureMS& getRenderTexture() { return renderTexture; }
+        inline GpuProfiler& getGpuProfiler() { return gpuProfiler; }
         inline PhysicsWorld& getPhysicsWorld() { return *physicsWorld; }
         inline GameState& getGameState() { return *gameState; }
         inline Time& getTime() { return *currentTime; }
 
     private:
         TextMap textMap;
+        TextMap sdfTextMap;
         Settings settings = Settings(GameInfo::DEFAULT_GRAVITY, glm::vec3(-20, 0, 10));
         PointLightShadowMap pointLightDepthMap;
         DirectionalLightShadowMap directionalLightDepthMap;
         RenderTextureMS renderTexture;
+        GpuProfiler gpuProfiler;
         PhysicsWorld* physicsWorld = nullptr;
         GameState* gameState       = nullptr;
         Time* currentTime          = nullptr;
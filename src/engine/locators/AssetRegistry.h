@@ -0,0 +1,264 @@
+#ifndef ASSET_REGISTRY_H
+#define ASSET_REGISTRY_H
+
+#include "Debug.h"
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class ASSET_STATE {
+    //!Queued or being read on another thread, the asset holds a placeholder.
+    Loading,
+    Loaded,
+    //!The file couldn't be read, the asset holds a placeholder.
+    Failed
+};
+
+//!A 64 bit reference to an asset of type T in an AssetRegistry<T>. Resolving it is an array index.
+//!The low 32 bits are the slot plus one, so a zero handle is never valid. The high 32 bits are the slot's generation,
+//!so a handle to a freed asset doesn't resolve to the asset that reused its slot. A slot whose generation would wrap
+//!is retired instead of reused.
+template <class T>
+class AssetHandle {
+public:
+    AssetHandle() {}
+
+    bool isValid() const { return value != 0; }
+    uint64_t getValue() const { return value; }
+
+    bool operator==(const AssetHandle& other) const { return value == other.value; }
+    bool operator!=(const AssetHandle& other) const { return value != other.value; }
+
+private:
+    AssetHandle(uint32_t slot, uint32_t generation)
+        : value((static_cast<uint64_t>(slot) + 1) | static_cast<uint64_t>(generation) << 32) {}
+
+    uint32_t getSlot() const { return static_cast<uint32_t>((value & 0xffffffff) - 1); }
+    uint32_t getGeneration() const { return static_cast<uint32_t>(value >> 32); }
+
+    uint64_t value = 0;
+
+    template <class U>
+    friend class AssetRegistry;
+};
+
+/*!Owns the assets of one type, keyed by path.
+
+Paths are only looked up when an asset is added or found, after that assets are reached through handles. Every asset
+is reference counted, freeUnreferenced frees the ones nobody holds anymore, so a scene change frees exactly the assets
+the old scene alone used. Assets are allocated with new and deleted by the registry.
+*/
+template <class T>
+class AssetRegistry {
+
+public:
+    AssetRegistry() {}
+    ~AssetRegistry() { clear(); }
+
+    AssetRegistry(const AssetRegistry&) = delete;
+    AssetRegistry(AssetRegistry&&)      = delete;
+    AssetRegistry& operator=(const AssetRegistry&) = delete;
+    AssetRegistry& operator=(AssetRegistry&&) = delete;
+
+    //!FNV-1a. Not used for lookups, so two paths with the same hash never reach each other's assets.
+    static uint64_t hashPath(const std::string& path) {
+        uint64_t hash = 14695981039346656037ull;
+
+        for (char character : path) {
+            hash ^= static_cast<uint8_t>(character);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    //!Returns the handle of the asset added with path, or an invalid handle if there is none.
+    AssetHandle<T> find(const std::string& path) const {
+        typename std::unordered_map<std::string, uint32_t>::const_iterator itr = slotsByPath.find(path);
+
+        if (itr == slotsByPath.end()) {
+            return AssetHandle<T>();
+        }
+
+        return AssetHandle<T>(itr->second, slots[itr->second].generation);
+    }
+
+    //!Takes ownership of asset. The asset starts without references.
+    //!If an asset was already added with path, asset is deleted and the handle of the existing one is returned.
+    AssetHandle<T> add(const std::string& path, T* asset, ASSET_STATE state = ASSET_STATE::Loaded) {
+        const AssetHandle<T> existing = find(path);
+
+        if (existing.isValid()) {
+            DBG_LOG("An asset was already added with the path %s (AssetRegistry.h add)\n", path.c_str());
+            delete asset;
+            return existing;
+        }
+
+        uint32_t index;
+
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            index = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot());
+        }
+
+        Slot& slot      = slots[index];
+        slot.asset      = asset;
+        slot.path       = path;
+        slot.references = 0;
+        slot.state      = state;
+
+        slotsByPath[path] = index;
+
+        return AssetHandle<T>(index, slot.generation);
+    }
+
+    //!Returns nullptr if the handle is invalid or its asset was freed.
+    T* get(AssetHandle<T> handle) const {
+        const Slot* slot = getSlot(handle);
+
+        return slot ? slot->asset : nullptr;
+    }
+
+    const std::string& getPath(AssetHandle<T> handle) const {
+        static const std::string empty;
+
+        const Slot* slot = getSlot(handle);
+
+        return slot ? slot->path : empty;
+    }
+
+    ASSET_STATE getState(AssetHandle<T> handle) const {
+        const Slot* slot = getSlot(handle);
+
+        return slot ? slot->state : ASSET_STATE::Failed;
+    }
+
+    void setState(AssetHandle<T> handle, ASSET_STATE state) {
+        if (Slot* slot = getSlot(handle)) {
+            slot->state = state;
+        }
+    }
+
+    void acquire(AssetHandle<T> handle) {
+        if (Slot* slot = getSlot(handle)) {
+            slot->references++;
+        }
+    }
+
+    void release(AssetHandle<T> handle) {
+        Slot* slot = getSlot(handle);
+
+        if (slot && slot->references > 0) {
+            slot->references--;
+        }
+    }
+
+    uint32_t getReferences(AssetHandle<T> handle) const {
+        const Slot* slot = getSlot(handle);
+
+        return slot ? slot->references : 0;
+    }
+
+    //!Calls function(handle, asset) for every asset.
+    template <typename Function>
+    void forEach(Function function) const {
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            if (slots[i].asset) {
+                function(AssetHandle<T>(i, slots[i].generation), *slots[i].asset);
+            }
+        }
+    }
+
+    //!Frees every asset without references for which canFree(asset) returns true, and returns how many were freed.
+    template <typename Predicate>
+    unsigned int freeUnreferenced(Predicate canFree) {
+        unsigned int amountFreed = 0;
+
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            Slot& slot = slots[i];
+
+            if (!slot.asset || slot.references > 0 || !canFree(*slot.asset)) {
+                continue;
+            }
+
+            freeSlot(i);
+            amountFreed++;
+        }
+
+        return amountFreed;
+    }
+
+    unsigned int freeUnreferenced() {
+        return freeUnreferenced([](const T&) { return true; });
+    }
+
+    //!Frees every asset, handles stay invalid even if the slots are reused.
+    void clear() {
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            if (slots[i].asset) {
+                freeSlot(i);
+            }
+        }
+    }
+
+    size_t size() const { return slots.size() - freeSlots.size() - amountOfRetiredSlots; }
+
+private:
+    struct Slot {
+        T* asset = nullptr;
+        std::string path;
+        uint32_t references = 0;
+        uint32_t generation = 0;
+        ASSET_STATE state   = ASSET_STATE::Loaded;
+    };
+
+    Slot* getSlot(AssetHandle<T> handle) {
+        return const_cast<Slot*>(static_cast<const AssetRegistry*>(this)->getSlot(handle));
+    }
+
+    const Slot* getSlot(AssetHandle<T> handle) const {
+        if (!handle.isValid() || handle.getSlot() >= slots.size()) {
+            return nullptr;
+        }
+
+        const Slot& slot = slots[handle.getSlot()];
+
+        if (!slot.asset || slot.generation != handle.getGeneration()) {
+            return nullptr;
+        }
+
+        return &slot;
+    }
+
+    void freeSlot(uint32_t index) {
+        Slot& slot = slots[index];
+
+        delete slot.asset;
+        slotsByPath.erase(slot.path);
+
+        slot.asset = nullptr;
+        slot.path.clear();
+        slot.references = 0;
+
+        //A wrapped generation would let the slot's oldest handles resolve again.
+        if (slot.generation == UINT32_MAX) {
+            amountOfRetiredSlots++;
+            return;
+        }
+
+        slot.generation++;
+
+        freeSlots.push_back(index);
+    }
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    size_t amountOfRetiredSlots = 0;
+    std::unordered_map<std::string, uint32_t> slotsByPath;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define LOCATOR_H
 #include "Input.h"
 #include "Lua.h"
+#include "ModelResource.h"
 #include "Shader.h"
 #include "Sound.h"
 #include "Texture.h"
@@ -47,6 +48,7 @@ class SoundHandler;
 class MusicHandler;
 class ShaderHandler;
 class LuaHandler;
+class ModelHandler;
 
 class TextureLocator : public Locator<TextureHandler, TextureHandler> {};
 class InputLocator : public Locator<Input, NullInput> {};
@@ -55,4 +57,5 @@ class SoundLocator : public Locator<SoundHandler, SoundHandler> {};
 class MusicLocator : public Locator<MusicHandler, MusicHandler> {};
 class ShaderLocator : public Locator<ShaderHandler, ShaderHandler> {};
 class LuaLocator : public Locator<LuaHandler, LuaHandler> {};
+class ModelLocator : public Locator<ModelHandler, ModelHandler> {};
 #endif
@@ -130,61 +130,21 @@ Music::~Music() {
 
 //*************************************Begining of SoundHandler Class*****************************************
 
-/************************************************************************************************************************
-*The binarySearchSounds function will return the sound pointer associated with the key if it exists in the sorted vector*
-*************************************************************************************************************************/
-Sound* SoundHandler::binarySearchSounds(const std::string& key) {
-    unsigned int mid   = 0;
-    unsigned int left  = 0;
-    unsigned int right = soundLibrary.size();
-
-    while (left < right) {
-        mid = left + (right - left) / 2;
-
-        if (key > soundLibrary.at(mid)->getLocation()) {
-            left = mid + 1;
-        } else if (key < soundLibrary.at(mid)->getLocation()) {
-            right = mid;
-        } else {
-            return soundLibrary.at(mid);
-        }
-    }
-
-    return nullptr;
-}
-
-/*************************************************************************************************************************
-*The addThenSort function will add the sound passed by reference to the vector of sound pointers, then re-sort the vector*
-**************************************************************************************************************************/
-void SoundHandler::addThenSort(Sound& sound) {
-    //Add sound to library
-    soundLibrary.push_back(&sound);
-
-    //sort the library so I can use a binary search.
-    std::sort(
-        soundLibrary.begin(),
-        soundLibrary.end(),
-        [](Sound* a, Sound* b) //oooooo a fancy Lambda expression :)
-        {
-            return a->getLocation() < b->getLocation();
-        });
-}
-
 /**************************************************************************************************************************
 *The addSoundWithoutChecking function will add a new sound to the library without checking if it is already in the library*
 ***************************************************************************************************************************/
-void SoundHandler::addSoundWithoutChecking(const std::string& location) {
+SoundHandle SoundHandler::addSoundWithoutChecking(const std::string& location) {
 
     Sound* newSound = new Sound();
     newSound->initialize(location);
 
     if (!newSound->isNullSound()) {
-        //add the pointer to the sound library because the location worked.
-        addThenSort(*newSound);
-
 #ifdef DEBUG
         printf("Sound was Succesfully added to library.\n");
 #endif
+
+        //add the pointer to the sound library because the location worked.
+        return soundLibrary.add(location, newSound);
     } else {
 
         DBG_LOG("Audio clip is null, could not Add.\nAudio file location is \"");
@@ -193,20 +153,25 @@ void SoundHandler::addSoundWithoutChecking(const std::string& location) {
 
         //free memory because the location was incorrect.
         delete newSound;
-        return;
+        return SoundHandle();
     }
 }
 
 /**************************************************************************************************************************
 *The addSound function will add a new sound to the library and check to make sure it doesn't already exist in the library *
 ***************************************************************************************************************************/
-void SoundHandler::addSound(const std::string& location) {
-    if (Sound* soundToFind = binarySearchSounds(location)) {
+SoundHandle SoundHandler::addSound(const std::string& location) {
+    SoundHandle soundToFind = soundLibrary.find(location);
+
+    if (soundToFind.isValid()) {
         DBG_LOG("Sound is already in library.\n");
-        return;
     } else {
-        addSoundWithoutChecking(location);
+        soundToFind = addSoundWithoutChecking(location);
     }
+
+    soundLibrary.acquire(soundToFind);
+
+    return soundToFind;
 }
 
 /*************************************************************************************************************
@@ -214,26 +179,46 @@ void SoundHandler::addSound(const std::string& location) {
 **************************************************************************************************************/
 void SoundHandler::playSound(const std::string& location) {
 
-    if (Sound* soundToFind = binarySearchSounds(location)) {
-        soundToFind->play();
+    SoundHandle soundToFind = soundLibrary.find(location);
+
+    if (!soundToFind.isValid()) {
+        soundToFind = addSoundWithoutChecking(location);
+    }
+
+    playSound(soundToFind);
+}
+
+/********************************************************************************************
+*The playSound function will play a sound added with addSound, if it is still in the library*
+********************************************************************************************/
+void SoundHandler::playSound(SoundHandle sound) {
+    if (Sound* soundToPlay = soundLibrary.get(sound)) {
+        soundToPlay->play();
     } else {
-        addSoundWithoutChecking(location);
-        soundToFind = binarySearchSounds(location);
-        soundToFind->play();
+        DBG_LOG("Sound is not in the library, cannot play.\n");
     }
 }
 
+/****************************************************************
+*The releaseSound function removes a reference added by addSound*
+*****************************************************************/
+void SoundHandler::releaseSound(SoundHandle sound) {
+    soundLibrary.release(sound);
+}
+
+/***************************************************************************
+*The freeUnreferencedSounds function frees every sound nobody holds anymore*
+****************************************************************************/
+void SoundHandler::freeUnreferencedSounds() {
+    soundLibrary.freeUnreferenced();
+}
+
 /************************************************************************************
 *The destructor of the sound handler will delete the vector of pointers and clear it*
 *************************************************************************************/
 SoundHandler::~SoundHandler() {
     DBG_LOG("Freeing memory for the sound library\n");
 
-    for (unsigned int i = 0; i < soundLibrary.size(); i++) {
-
-        delete soundLibrary.at(i);
-        soundLibrary.at(i) = nullptr;
-    }
     soundLibrary.clear();
 }
 
@@ -241,61 +226,21 @@ SoundHandler::~SoundHandler() {
 
 //*************************************Begining of MusicHandler Class*****************************************
 
-/************************************************************************************************************************
-*The binarySearchMusic function will return the Music pointer associated with the key if it exists in the sorted vector *
-*************************************************************************************************************************/
-Music* MusicHandler::binarySearchMusic(const std::string& key) {
-    unsigned int mid   = 0;
-    unsigned int left  = 0;
-    unsigned int right = musicLibrary.size();
-
-    while (left < right) {
-        mid = left + (right - left) / 2;
-
-        if (key > musicLibrary.at(mid)->getLocation()) {
-            left = mid + 1;
-        } else if (key < musicLibrary.at(mid)->getLocation()) {
-            right = mid;
-        } else {
-            return musicLibrary.at(mid);
-        }
-    }
-
-    return nullptr;
-}
-
-/*************************************************************************************************************************
-*The addThenSort function will add the music passed by reference to the vector of sound pointers, then re-sort the vector*
-**************************************************************************************************************************/
-void MusicHandler::addThenSort(Music& music) {
-    //Add sound to library
-    musicLibrary.push_back(&music);
-
-    //sort the library so I can use a binary search.
-    std::sort(
-        musicLibrary.begin(),
-        musicLibrary.end(),
-        [](Music* a, Music* b) //oooooo a fancy Lambda expression :)
-        {
-            return a->getLocation() < b->getLocation();
-        });
-}
-
 /**************************************************************************************************************************
 *The addMusicWithoutChecking function will add a new Music to the library without checking if it is already in the library*
 ***************************************************************************************************************************/
-void MusicHandler::addMusicWithoutChecking(const std::string& location) {
+MusicHandle MusicHandler::addMusicWithoutChecking(const std::string& location) {
 
     Music* newMusic = new Music();
     newMusic->initialize(location);
 
     if (!newMusic->isNullSound()) {
-        //add the pointer to the sound library because the location worked.
-        addThenSort(*newMusic);
-
 #ifdef DEBUG
         printf("Music was Succesfully added to library.\n");
 #endif
+
+        //add the pointer to the sound library because the location worked.
+        return musicLibrary.add(location, newMusic);
     } else {
 #ifdef DEBUG
         printf("Music clip is null, could not Add.\nMusic file location is \"");
@@ -305,7 +250,7 @@ void MusicHandler::addMusicWithoutChecking(const std::string& location) {
 
         //free memory because the location was incorrect.
         delete newMusic;
-        return;
+        return MusicHandle();
     }
 }
 
@@ -320,27 +265,45 @@ void MusicHandler::stop(bool fadeOut) {
 /**************************************************************************************************************************
 *The addMusic function will add a new Music to the library and check to make sure it doesn't already exist in the library *
 ***************************************************************************************************************************/
-void MusicHandler::addMusic(const std::string& location) {
-    if (Music* musicToFind = binarySearchMusic(location)) {
+MusicHandle MusicHandler::addMusic(const std::string& location) {
+    MusicHandle musicToFind = musicLibrary.find(location);
+
+    if (musicToFind.isValid()) {
         DBG_LOG("Music is already in library.\n");
-        return;
     } else {
-        addMusicWithoutChecking(location);
+        musicToFind = addMusicWithoutChecking(location);
     }
+
+    musicLibrary.acquire(musicToFind);
+
+    return musicToFind;
 }
 
 /*************************************************************************************************************
 *The playMusic function try to play a music in the library, and if it doesn't exist, it will try to create it*
 **************************************************************************************************************/
 void MusicHandler::playMusic(const std::string& location, bool fadeIn) {
-    currentlyPlaying = binarySearchMusic(location);
+    MusicHandle musicToFind = musicLibrary.find(location);
 
-    if (currentlyPlaying == nullptr) {
+    if (!musicToFind.isValid()) {
 #ifdef DEBUG
         printf("music was not found in library. Creating new clip.\n");
 #endif
-        addMusicWithoutChecking(location);
-        currentlyPlaying = binarySearchMusic(location);
+        musicToFind = addMusicWithoutChecking(location);
+    }
+
+    playMusic(musicToFind, fadeIn);
+}
+
+/********************************************************************************************
+*The playMusic function will play a music added with addMusic, if it is still in the library*
+********************************************************************************************/
+void MusicHandler::playMusic(MusicHandle music, bool fadeIn) {
+    currentlyPlaying = musicLibrary.get(music);
+
+    if (currentlyPlaying == nullptr) {
+        DBG_LOG("Music is not in the library, cannot play.\n");
+        return;
     }
 
     if (fadeIn) {
@@ -378,16 +341,26 @@ bool MusicHandler::isPlayingMusic() {
     return Mix_PlayingMusic() ? true : false;
 }
 
+/****************************************************************
+*The releaseMusic function removes a reference added by addMusic*
+*****************************************************************/
+void MusicHandler::releaseMusic(MusicHandle music) {
+    musicLibrary.release(music);
+}
+
+/********************************************************************************************************
+*The freeUnreferencedMusic function frees every music nobody holds anymore, except the one still playing*
+*********************************************************************************************************/
+void MusicHandler::freeUnreferencedMusic() {
+    musicLibrary.freeUnreferenced([this](const Music& music) { return &music != currentlyPlaying; });
+}
+
 /************************************************************************************
 *The destructor of the music handler will delete the vector of pointers and clear it*
 *************************************************************************************/
 MusicHandler::~MusicHandler() {
     DBG_LOG("Freeing memory for the music library\n");
-    for (unsigned int i = 0; i < musicLibrary.size(); i++) {
 
-        delete musicLibrary.at(i);
-        musicLibrary.at(i) = nullptr;
-    }
     musicLibrary.clear();
 }
 
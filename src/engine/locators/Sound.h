@@ -1,11 +1,10 @@
 #ifndef _SOUND_H
 #define _SOUND_H
+#include "AssetRegistry.h"
 #include "Debug.h"
-#include "HelpingHand.h" //included for clearing a vector of pointers.
+#include "HelpingHand.h"
 #include <SDL_mixer.h> //Included for audio
-#include <algorithm> //included for sorting
 #include <string>
-#include <vector> //included for the audio libraries
 
 /***************************************************************************************************************
 The Audio class. The Music and Sound class inherit from this. It provides a template to use for audio handling.*
@@ -72,22 +71,33 @@ private:
 AUDIO HANDLING CLASSES*
 ***********************/
 
+typedef AssetHandle<Sound> SoundHandle;
+typedef AssetHandle<Music> MusicHandle;
+
 /***********************************************************************
 The SoundHandler class. It handles a library of sounds to play and use.*
 ************************************************************************/
 class SoundHandler {
 
 public:
-    void addSound(const std::string& location);
+    //Returns an invalid handle if the sound couldn't be loaded.
+    //Every call adds a reference to the sound, see releaseSound.
+    SoundHandle addSound(const std::string& location);
+    //Sounds only played by location have no references, so they are freed by the next freeUnreferencedSounds.
     void playSound(const std::string& location);
+    //Playing a sound by handle skips the path lookup.
+    void playSound(SoundHandle sound);
+    //Removes a reference added by addSound.
+    void releaseSound(SoundHandle sound);
+    //Frees every sound without references. Called after a scene is loaded.
+    void freeUnreferencedSounds();
     ~SoundHandler();
 
 private:
-    Sound* binarySearchSounds(const std::string& key);
-    void addSoundWithoutChecking(const std::string& location);
-    void addThenSort(Sound& sound);
+    SoundHandle addSoundWithoutChecking(const std::string& location);
 
-    std::vector<Sound*> soundLibrary;
+    //The audio library, keyed by file path.
+    AssetRegistry<Sound> soundLibrary;
 };
 
 /*******************************************************************************
@@ -97,19 +107,25 @@ class MusicHandler {
 
 public:
     void stop(bool fadeOut);
-    void addMusic(const std::string& location);
+    //Returns an invalid handle if the music couldn't be loaded.
+    //Every call adds a reference to the music, see releaseMusic.
+    MusicHandle addMusic(const std::string& location);
     void playMusic(const std::string& location, bool fadeIn = false);
+    void playMusic(MusicHandle music, bool fadeIn = false);
     void toggleMusic();
     void toggleMusic(bool paused);
     bool isPlayingMusic();
+    //Removes a reference added by addMusic.
+    void releaseMusic(MusicHandle music);
+    //Frees every music without references, except the one playing. Called after a scene is loaded.
+    void freeUnreferencedMusic();
     ~MusicHandler();
 
 private:
-    Music* binarySearchMusic(const std::string& key);
-    void addMusicWithoutChecking(const std::string& location);
-    void addThenSort(Music& sound);
+    MusicHandle addMusicWithoutChecking(const std::string& location);
 
-    std::vector<Music*> musicLibrary;
+    //The audio library, keyed by file path.
+    AssetRegistry<Music> musicLibrary;
 
     unsigned int FADE_SPEED = 2000;
     Music* currentlyPlaying = nullptr;
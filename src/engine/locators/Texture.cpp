@@ -25,51 +25,43 @@ CubeMap::~CubeMap() {
     texture = 0;
 }
 
+const size_t TextureHandler::DEFAULT_UPLOAD_BUDGET;
+const size_t TextureHandler::DEFAULT_MEMORY_BUDGET;
+const uint32_t TextureHandler::ALWAYS_RESIDENT_SIZE;
+const unsigned int TextureHandler::MAX_STREAM_REQUESTS_PER_FRAME;
+
 //Fills Texture with data from filePath if it exists. if not it will use a checker pattern.
 //Returns pointer of newly created texture.
 Texture* TextureHandler::parseTexture(std::string filePath, GLint filtering, bool repeatTexture) {
 
     GLuint textureHandle;
     SDL_Surface* surface;
+    TextureContainer::CookedTexture cooked;
 
-    if ((surface = IMG_Load(filePath.c_str()))) {
-
-        verifySurfaceDimensions(*surface);
-        int textureFormat = getSurfaceFormat(*surface);
+    if (readCookedTexture(filePath, cooked)) {
 
         glGenTextures(1, &textureHandle);
         glBindTexture(GL_TEXTURE_2D, textureHandle);
 
-        if (repeatTexture) {
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        } else {
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        }
+        setTextureParameters(filtering, repeatTexture);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filtering);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filtering);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        Texture* texture = new Texture(filePath, textureHandle, 0, 0, false);
+        uploadCookedTexture(*texture, cooked, getAlwaysResidentLevel(cooked), static_cast<GLint>(cooked.levels.size()));
 
-        glTexImage2D(GL_TEXTURE_2D,
-                     0,
-                     textureFormat,
-                     surface->w,
-                     surface->h,
-                     0,
-                     textureFormat,
-                     GL_UNSIGNED_BYTE,
-                     surface->pixels);
+        return texture;
+    }
 
-        glGenerateMipmap(GL_TEXTURE_2D);
+    if ((surface = IMG_Load(filePath.c_str()))) {
 
-        glBindTexture(GL_TEXTURE_2D, 0);
+        glGenTextures(1, &textureHandle);
+        glBindTexture(GL_TEXTURE_2D, textureHandle);
+
+        setTextureParameters(filtering, repeatTexture);
 
-        SDL_FreeSurface(surface);
+        Texture* texture = new Texture(filePath, textureHandle, 0, 0, false);
+        uploadSurface(*texture, surface);
 
-        return new Texture(filePath, textureHandle, surface->w, surface->h, (textureFormat == GL_RGBA));
+        return texture;
     }
 
     DBG_LOG("Image could not load properly, using null texture\n");
@@ -92,6 +84,512 @@ Texture* TextureHandler::parseTexture(std::string filePath, GLint filtering, boo
     return new Texture(filePath, textureHandle, 3, 3, false);
 }
 
+//The texture holds the checker pattern with the requested filtering until its image is uploaded by processUploads.
+Texture* TextureHandler::parseTextureAsynchronously(std::string filePath, GLint filtering, bool repeatTexture) {
+
+    GLuint textureHandle;
+
+    glGenTextures(1, &textureHandle);
+    glBindTexture(GL_TEXTURE_2D, textureHandle);
+
+    setTextureParameters(filtering, repeatTexture);
+    teximage2DFillerTexture(GL_TEXTURE_2D);
+
+    //The filler needs its own mips, a mipmapped filter samples nothing from an incomplete texture.
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    Texture* texture = new Texture(filePath, textureHandle, 3, 3, false);
+
+    if (decodeWorkers.empty()) {
+        const unsigned int amountOfWorkers = std::max(std::thread::hardware_concurrency() / 2, 1u);
+
+        for (unsigned int i = 0; i < amountOfWorkers; i++) {
+            decodeWorkers.emplace_back(&TextureHandler::decodeImages, this);
+        }
+    }
+
+    DecodedImage request;
+    request.texture = texture;
+
+    {
+        std::lock_guard<std::mutex> lock(decodeMutex);
+        decodeQueue.push_back(request);
+    }
+
+    decodeRequested.notify_one();
+
+    return texture;
+}
+
+void TextureHandler::setTextureParameters(GLint filtering, bool repeatTexture) {
+    if (repeatTexture) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    } else {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    //Linear textures are minified through their mips. Nearest textures are pixel art and gui, which stay sharp.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filtering == GL_LINEAR ? GL_LINEAR_MIPMAP_LINEAR : filtering);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filtering);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+}
+
+const GLvoid* TextureHandler::fillPixelBuffer(const void* data, size_t bytes) {
+    if (!pixelBuffer) {
+        glGenBuffers(1, &pixelBuffer);
+    }
+
+    //The buffer is orphaned for every image, so an upload never waits for the previous one to finish.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+
+    if (void* memory = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)) {
+        memcpy(memory, data, bytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        return nullptr;
+    }
+
+    DBG_LOG("Failed to map the pixel buffer, uploading directly (Texture.cpp fillPixelBuffer)\n");
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    return data;
+}
+
+size_t TextureHandler::uploadSurface(Texture& texture, SDL_Surface* surface) {
+
+    verifySurfaceDimensions(*surface);
+    int textureFormat = getSurfaceFormat(*surface);
+
+    const size_t bytes = static_cast<size_t>(surface->pitch) * surface->h;
+
+    const GLvoid* pixels = fillPixelBuffer(surface->pixels, bytes);
+
+    glBindTexture(GL_TEXTURE_2D, texture.texture);
+
+    //Rows of a surface can be padded.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, surface->pitch / surface->format->BytesPerPixel);
+
+    glTexImage2D(GL_TEXTURE_2D,
+                 0,
+                 textureFormat,
+                 surface->w,
+                 surface->h,
+                 0,
+                 textureFormat,
+                 GL_UNSIGNED_BYTE,
+                 pixels);
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    texture.imageWidth    = surface->w;
+    texture.imageHeight   = surface->h;
+    texture.isTransparent = textureFormat == GL_RGBA;
+
+    //Counting the generated mips, which add a third.
+    setResidentBytes(texture, static_cast<size_t>(surface->w) * surface->h * surface->format->BytesPerPixel * 4 / 3);
+
+    SDL_FreeSurface(surface);
+
+    return bytes;
+}
+
+size_t TextureHandler::uploadCookedTexture(Texture& texture, const TextureContainer::CookedTexture& cooked, GLint firstLevel, GLint lastLevel) {
+
+    //The levels are stored from the biggest to the smallest, so the ones uploaded are contiguous.
+    const TextureContainer::Level& first = cooked.levels[firstLevel];
+    const TextureContainer::Level& last  = cooked.levels[lastLevel - 1];
+    const size_t bytes                   = last.offset + last.size - first.offset;
+
+    const GLvoid* pixels         = fillPixelBuffer(cooked.data.data() + first.offset, bytes);
+    const uintptr_t pixelAddress = reinterpret_cast<uintptr_t>(pixels);
+
+    glBindTexture(GL_TEXTURE_2D, texture.texture);
+
+    for (GLint i = firstLevel; i < lastLevel; i++) {
+        uploadLevel(cooked.format, cooked.levels[i], i, reinterpret_cast<const GLvoid*>(pixelAddress + cooked.levels[i].offset - first.offset));
+    }
+
+    //Only the resident levels are sampled, the filler's levels outside of them are ignored.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, firstLevel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(cooked.levels.size() - 1));
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (texture.levels.empty()) {
+        texture.levels              = cooked.levels;
+        texture.format              = cooked.format;
+        texture.alwaysResidentLevel = firstLevel;
+        texture.imageWidth          = cooked.getWidth();
+        texture.imageHeight         = cooked.getHeight();
+        texture.isTransparent       = cooked.format == TextureContainer::FORMAT::BC3 || cooked.format == TextureContainer::FORMAT::RGBA8;
+    }
+
+    texture.residentLevel = firstLevel;
+
+    setResidentBytes(texture, getLevelBytes(texture, firstLevel));
+
+    return bytes;
+}
+
+GLint TextureHandler::getAlwaysResidentLevel(const TextureContainer::CookedTexture& cooked) const {
+    for (size_t i = 0; i < cooked.levels.size(); i++) {
+        if (std::max(cooked.levels[i].width, cooked.levels[i].height) <= ALWAYS_RESIDENT_SIZE) {
+            return static_cast<GLint>(i);
+        }
+    }
+
+    return static_cast<GLint>(cooked.levels.size() - 1);
+}
+
+size_t TextureHandler::getLevelBytes(const Texture& texture, GLint firstLevel) const {
+    size_t bytes = 0;
+
+    for (size_t i = firstLevel; i < texture.levels.size(); i++) {
+        bytes += texture.levels[i].size;
+    }
+
+    return bytes;
+}
+
+void TextureHandler::setResidentBytes(Texture& texture, size_t bytes) {
+    totalResidentBytes    = totalResidentBytes - texture.residentBytes + bytes;
+    texture.residentBytes = bytes;
+}
+
+void TextureHandler::uploadLevel(TextureContainer::FORMAT format, const TextureContainer::Level& level, GLint index, const GLvoid* pixels) {
+    if (TextureContainer::isCompressed(format)) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, index, getCompressedFormat(format), level.width, level.height, 0, level.size, pixels);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, index, GL_RGBA8, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+}
+
+void TextureHandler::evictLevel(Texture& texture) {
+    texture.residentLevel++;
+
+    const GLint firstLevel = texture.residentLevel;
+    const GLint lastLevel  = static_cast<GLint>(texture.levels.size());
+    const size_t bytes     = getLevelBytes(texture, firstLevel);
+    const uint32_t base    = texture.levels[firstLevel].offset;
+
+    //A single level can't be freed, so the levels kept are copied into a new texture through the pixel buffer.
+    //The copy stays on the GPU, nothing waits for it.
+    if (!pixelBuffer) {
+        glGenBuffers(1, &pixelBuffer);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_COPY);
+
+    glBindTexture(GL_TEXTURE_2D, texture.texture);
+
+    GLint wrapS     = 0;
+    GLint wrapT     = 0;
+    GLint minFilter = 0;
+    GLint magFilter = 0;
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &wrapS);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &wrapT);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &minFilter);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &magFilter);
+
+    for (GLint i = firstLevel; i < lastLevel; i++) {
+        GLvoid* levelPixels = reinterpret_cast<GLvoid*>(static_cast<uintptr_t>(texture.levels[i].offset - base));
+
+        if (TextureContainer::isCompressed(texture.format)) {
+            glGetCompressedTexImage(GL_TEXTURE_2D, i, levelPixels);
+        } else {
+            glGetTexImage(GL_TEXTURE_2D, i, GL_RGBA, GL_UNSIGNED_BYTE, levelPixels);
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glDeleteTextures(1, &texture.texture);
+
+    glGenTextures(1, &texture.texture);
+    glBindTexture(GL_TEXTURE_2D, texture.texture);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+
+    for (GLint i = firstLevel; i < lastLevel; i++) {
+        uploadLevel(texture.format, texture.levels[i], i, reinterpret_cast<const GLvoid*>(static_cast<uintptr_t>(texture.levels[i].offset - base)));
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, firstLevel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, lastLevel - 1);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    setResidentBytes(texture, bytes);
+}
+
+bool TextureHandler::makeRoom(size_t bytes) {
+    while (totalResidentBytes + cubeMapBytes + bytes > memoryBudget) {
+        Texture* leastRecentlyUsed = nullptr;
+
+        textures.forEach([this, &leastRecentlyUsed](TextureHandle, Texture& texture) {
+            if (texture.levels.empty() || texture.pendingLevel >= 0 || texture.residentLevel >= texture.alwaysResidentLevel) {
+                return;
+            }
+
+            //Textures drawn last frame only give up levels bigger than the ones they need.
+            if (texture.lastUsedFrame + 1 >= currentFrame && texture.residentLevel >= texture.requestedLevel) {
+                return;
+            }
+
+            if (!leastRecentlyUsed || texture.lastUsedFrame < leastRecentlyUsed->lastUsedFrame) {
+                leastRecentlyUsed = &texture;
+            }
+        });
+
+        if (!leastRecentlyUsed) {
+            return false;
+        }
+
+        evictLevel(*leastRecentlyUsed);
+    }
+
+    return true;
+}
+
+void TextureHandler::updateStreaming() {
+    currentFrame++;
+    totalRequestedBytes = 0;
+
+    unsigned int amountOfRequests = 0;
+
+    textures.forEach([this, &amountOfRequests](TextureHandle, Texture& texture) {
+        if (!texture.sizeReported) {
+            texture.lastUsedFrame = currentFrame;
+        }
+
+        if (texture.levels.empty()) {
+            totalRequestedBytes += texture.residentBytes;
+            return;
+        }
+
+        //The level whose size is closest to the size the texture was drawn at, unused textures keep their last request.
+        if (texture.requestedSize > 0.0f) {
+            const float biggestSide = static_cast<float>(std::max(texture.imageWidth, texture.imageHeight));
+            const float level       = std::floor(std::log2(biggestSide / texture.requestedSize));
+
+            texture.requestedLevel = std::min(static_cast<GLint>(std::max(level, 0.0f)), texture.alwaysResidentLevel);
+            texture.requestedSize  = 0.0f;
+        }
+
+        totalRequestedBytes += getLevelBytes(texture, texture.requestedLevel);
+
+        const bool usedLastFrame = texture.lastUsedFrame + 1 >= currentFrame;
+
+        if (!usedLastFrame || texture.pendingLevel >= 0 || texture.requestedLevel >= texture.residentLevel || amountOfRequests >= MAX_STREAM_REQUESTS_PER_FRAME) {
+            return;
+        }
+
+        const size_t missingBytes = getLevelBytes(texture, texture.requestedLevel) - texture.residentBytes;
+
+        if (!makeRoom(missingBytes)) {
+            return;
+        }
+
+        texture.pendingLevel = texture.requestedLevel;
+
+        DecodedImage request;
+        request.texture    = &texture;
+        request.firstLevel = texture.requestedLevel;
+
+        {
+            std::lock_guard<std::mutex> lock(decodeMutex);
+            decodeQueue.push_back(request);
+        }
+
+        decodeRequested.notify_one();
+        amountOfRequests++;
+    });
+
+    //The budget may have been lowered.
+    makeRoom(0);
+}
+
+void TextureHandler::requestTextureSize(TextureHandle handle, float sizeInPixels) {
+    Texture* texture = textures.get(handle);
+
+    if (!texture) {
+        return;
+    }
+
+    texture->sizeReported  = true;
+    texture->lastUsedFrame = currentFrame;
+    texture->requestedSize = std::max(texture->requestedSize, sizeInPixels);
+}
+
+void TextureHandler::releaseTexture(TextureHandle handle) {
+    textures.release(handle);
+}
+
+void TextureHandler::releaseCubeMap(CubeMapHandle handle) {
+    cubeMaps.release(handle);
+}
+
+void TextureHandler::freeUnreferencedTextures() {
+    //Textures still waiting on a worker thread are freed the next time.
+    textures.freeUnreferenced([this](Texture& texture) {
+        if (textures.getState(texture.handle) == ASSET_STATE::Loading || texture.pendingLevel >= 0) {
+            return false;
+        }
+
+        setResidentBytes(texture, 0);
+
+        return true;
+    });
+
+    cubeMaps.freeUnreferenced([this](CubeMap& cubeMap) {
+        cubeMapBytes -= cubeMap.residentBytes;
+
+        return true;
+    });
+}
+
+GLenum TextureHandler::getCompressedFormat(TextureContainer::FORMAT format) {
+    switch (format) {
+    case TextureContainer::FORMAT::BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case TextureContainer::FORMAT::BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TextureContainer::FORMAT::BC5:
+        return GL_COMPRESSED_RG_RGTC2;
+    default:
+        return GL_RGBA8;
+    }
+}
+
+//BC1 and BC3 aren't core, drivers without s3tc fall back to the png.
+bool TextureHandler::readCookedTexture(const std::string& filePath, TextureContainer::CookedTexture& cooked) {
+    if (!TextureContainer::read(TextureContainer::getCookedLocation(filePath), cooked)) {
+        return false;
+    }
+
+    if ((cooked.format == TextureContainer::FORMAT::BC1 || cooked.format == TextureContainer::FORMAT::BC3) && !GLEW_EXT_texture_compression_s3tc) {
+        return false;
+    }
+
+    return true;
+}
+
+void TextureHandler::processUploads(size_t byteBudget) {
+    size_t uploadedBytes = 0;
+
+    while (uploadedBytes < byteBudget) {
+        DecodedImage image;
+
+        {
+            std::lock_guard<std::mutex> lock(decodeMutex);
+
+            if (uploadQueue.empty()) {
+                return;
+            }
+
+            image = uploadQueue.front();
+            uploadQueue.pop_front();
+        }
+
+        Texture& texture = *image.texture;
+
+        if (image.firstLevel >= 0) {
+            //A streaming request, the texture keeps its resident levels if the file can't be read anymore.
+            if (image.cooked) {
+                uploadedBytes += uploadCookedTexture(texture, *image.cooked, image.firstLevel, texture.residentLevel);
+                delete image.cooked;
+            }
+
+            texture.pendingLevel = -1;
+            continue;
+        }
+
+        if (image.cooked) {
+            uploadedBytes += uploadCookedTexture(texture, *image.cooked, getAlwaysResidentLevel(*image.cooked), static_cast<GLint>(image.cooked->levels.size()));
+            delete image.cooked;
+            textures.setState(texture.handle, ASSET_STATE::Loaded);
+            continue;
+        }
+
+        if (!image.surface) {
+            DBG_LOG("Image could not load properly, using null texture\n");
+            DBG_LOG("The location of the non functioning texture is %s\n", texture.getLocation().c_str());
+            textures.setState(texture.handle, ASSET_STATE::Failed);
+            continue;
+        }
+
+        uploadedBytes += uploadSurface(texture, image.surface);
+        textures.setState(texture.handle, ASSET_STATE::Loaded);
+    }
+}
+
+void TextureHandler::finishLoading(Texture& texture) {
+    while (textures.getState(texture.handle) == ASSET_STATE::Loading) {
+        {
+            std::unique_lock<std::mutex> lock(decodeMutex);
+            imageDecoded.wait(lock, [this]() { return !uploadQueue.empty(); });
+        }
+
+        processUploads(SIZE_MAX);
+    }
+}
+
+void TextureHandler::decodeImages() {
+    while (true) {
+        DecodedImage image;
+
+        {
+            std::unique_lock<std::mutex> lock(decodeMutex);
+            decodeRequested.wait(lock, [this]() { return stopDecoding || !decodeQueue.empty(); });
+
+            if (stopDecoding) {
+                return;
+            }
+
+            image = decodeQueue.front();
+            decodeQueue.pop_front();
+        }
+
+        //The location never changes, so it can be read without the lock.
+        const std::string& location = image.texture->location;
+        image.cooked                = new TextureContainer::CookedTexture();
+
+        if (!readCookedTexture(location, *image.cooked)) {
+            delete image.cooked;
+            image.cooked = nullptr;
+
+            //Streaming requests only read cooked textures.
+            if (image.firstLevel < 0) {
+                image.surface = IMG_Load(location.c_str());
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(decodeMutex);
+            uploadQueue.push_back(image);
+        }
+
+        imageDecoded.notify_all();
+    }
+}
+
 //Checks if the sdl surface is power of two. Only runs on debug
 void TextureHandler::verifySurfaceDimensions(const SDL_Surface& surface) {
 
@@ -158,53 +656,32 @@ void TextureHandler::teximage2DFillerTexture(GLenum target) {
     glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
-//Add a new texture to the sorted texture library.
-Texture& TextureHandler::addNewTexture(std::string filePath, GLint filtering, bool repeatTexture) {
-    Texture* texture = parseTexture(filePath, filtering, repeatTexture);
+//Add a new texture to the texture registry.
+Texture& TextureHandler::addNewTexture(std::string filePath, GLint filtering, bool repeatTexture, TEXTURE_LOADING loading) {
+    Texture* texture = loading == TEXTURE_LOADING::Synchronous
+        ? parseTexture(filePath, filtering, repeatTexture)
+        : parseTextureAsynchronously(filePath, filtering, repeatTexture);
 
-    // Add texture to library
-    textureLibrary.push_back(texture);
-
-    // sort the library so I can use a binary search.
-    std::sort(textureLibrary.begin(),
-              textureLibrary.end(),
-              [](Texture* a, Texture* b) // :)
-              { return a->getLocation() < b->getLocation(); });
+    //The worker threads never touch the registry, so the handle can be set after the image was queued.
+    texture->handle = textures.add(filePath, texture, loading == TEXTURE_LOADING::Synchronous ? ASSET_STATE::Loaded : ASSET_STATE::Loading);
 
     return *texture;
 }
 
-//Searches the texture library for a texture.
-Texture* TextureHandler::binarySearchTextures(const std::string& key) {
-    unsigned int mid   = 0;
-    unsigned int left  = 0;
-    unsigned int right = textureLibrary.size();
-
-    while (left < right) {
-        mid = left + (right - left) / 2;
-
-        if (key > textureLibrary.at(mid)->getLocation()) {
-            left = mid + 1;
-        } else if (key < textureLibrary.at(mid)->getLocation()) {
-            right = mid;
-        } else {
-            return textureLibrary.at(mid);
-        }
-    }
-
-    return nullptr;
-}
-
 //Tries to retrieve a texture via file path, if it's not in the texture library then it adds it.
-Texture& TextureHandler::getTexture(std::string filePath, GLint filtering, bool repeatTexture) {
+Texture& TextureHandler::getTexture(std::string filePath, GLint filtering, bool repeatTexture, TEXTURE_LOADING loading) {
 
-    Texture* texture = binarySearchTextures(filePath);
+    Texture* texture = textures.get(textures.find(filePath));
 
-    if (texture != nullptr) {
-        return *texture;
+    if (texture == nullptr) {
+        texture = &addNewTexture(filePath, filtering, repeatTexture, loading);
+    } else if (loading == TEXTURE_LOADING::Synchronous) {
+        finishLoading(*texture);
     }
 
-    return addNewTexture(filePath, filtering, repeatTexture);
+    textures.acquire(texture->handle);
+
+    return *texture;
 }
 
 //Tries to retrieve a cubemap via file paths, if it's not in the cubemap library then it adds it.
@@ -214,14 +691,12 @@ CubeMap& TextureHandler::getCubeMap(const std::string identifier, const std::vec
     assert(faces.size() == 6);
 #endif
 
-    std::map<std::string, CubeMap*>::iterator itr;
-
-    for (itr = cubeMapLibrary.begin(); itr != cubeMapLibrary.end(); ++itr) {
+    CubeMap* existing = cubeMaps.get(cubeMaps.find(identifier));
 
-        if (itr->first == identifier && itr->second != nullptr) {
-            DBG_LOG("Cubmap identifier %s exists, returning.\n", itr->first.c_str());
-            return *itr->second;
-        }
+    if (existing != nullptr) {
+        DBG_LOG("Cubmap identifier %s exists, returning.\n", identifier.c_str());
+        cubeMaps.acquire(existing->handle);
+        return *existing;
     }
 
     GLuint textureID;
@@ -229,7 +704,8 @@ CubeMap& TextureHandler::getCubeMap(const std::string identifier, const std::vec
 
     CubeMap* cubemap = new CubeMap(faces, textureID);
 
-    cubeMapLibrary.insert({ identifier, cubemap });
+    cubemap->handle = cubeMaps.add(identifier, cubemap);
+    cubeMaps.acquire(cubemap->handle);
 
     glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -259,6 +735,8 @@ CubeMap& TextureHandler::getCubeMap(const std::string identifier, const std::vec
                          GL_UNSIGNED_BYTE,
                          surface->pixels);
 
+            cubemap->residentBytes += static_cast<size_t>(surface->w) * surface->h * surface->format->BytesPerPixel;
+
             SDL_FreeSurface(surface);
         } else {
 
@@ -272,28 +750,42 @@ CubeMap& TextureHandler::getCubeMap(const std::string identifier, const std::vec
     }
 
     glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+    cubeMapBytes += cubemap->residentBytes;
+
     return *cubemap;
 }
 
 //Free memory allocated for cubemaps and textures.
-//All allocated pointers are stored in textureLibrary and cubeMapLibrary
+//All allocated pointers are owned by textures and cubeMaps
 TextureHandler::~TextureHandler() {
 
-    DBG_LOG("Freeing memory for cube maps.\n");
+    {
+        std::lock_guard<std::mutex> lock(decodeMutex);
+        stopDecoding = true;
+    }
 
-    for (std::map<std::string, CubeMap*>::iterator it = cubeMapLibrary.begin(); it != cubeMapLibrary.end(); ++it) {
-        if (it->second != nullptr) {
-            delete it->second;
-            it->second = nullptr;
-        }
+    decodeRequested.notify_all();
+
+    for (std::thread& worker : decodeWorkers) {
+        worker.join();
     }
-    cubeMapLibrary.clear();
 
-    DBG_LOG("Freeing memory for textures.\n");
-    for (unsigned int i = 0; i < textureLibrary.size(); i++) {
+    for (DecodedImage& image : uploadQueue) {
+        if (image.surface) {
+            SDL_FreeSurface(image.surface);
+        }
+        delete image.cooked;
+    }
+    uploadQueue.clear();
 
-        delete textureLibrary.at(i);
-        textureLibrary.at(i) = nullptr;
+    if (pixelBuffer) {
+        glDeleteBuffers(1, &pixelBuffer);
     }
-    textureLibrary.clear();
+
+    DBG_LOG("Freeing memory for cube maps.\n");
+    cubeMaps.clear();
+
+    DBG_LOG("Freeing memory for textures.\n");
+    textures.clear();
 }
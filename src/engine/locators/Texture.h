@@ -6,11 +6,26 @@
 #include <SDL_opengl.h>
 
 #include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "AssetRegistry.h"
 #include "Debug.h"
 #include "HelpingHand.h"
+#include "TextureContainer.h"
+
+class Texture;
+class CubeMap;
+
+typedef AssetHandle<Texture> TextureHandle;
+typedef AssetHandle<CubeMap> CubeMapHandle;
 
 class Texture {
 public:
@@ -28,15 +43,49 @@ public:
     inline bool checkTransparency() const { return isTransparent; }
     inline GLuint getWidth() const { return imageWidth; }
     inline GLuint getHeight() const { return imageHeight; }
+    //!Changes when the texture gives up a mip level, so it should be read when the texture is bound.
     inline GLuint getTextureData() const { return texture; }
     inline std::string getLocation() const { return location; }
 
+    //!Stays the same for as long as the texture is loaded, unlike the texture's id it can't be mistaken for a texture loaded later.
+    inline TextureHandle getHandle() const { return handle; }
+
+    //!The video memory used by the texture's resident mip levels, estimated for textures that aren't cooked.
+    inline size_t getResidentBytes() const { return residentBytes; }
+
 private:
     GLuint imageWidth  = 0;
     GLuint imageHeight = 0;
     GLuint texture     = 0;
     bool isTransparent = false;
     std::string location;
+    TextureHandle handle;
+
+    size_t residentBytes = 0;
+
+    //!Streaming, only cooked textures have levels. Level 0 is the biggest, levels from alwaysResidentLevel on are never evicted.
+    std::vector<TextureContainer::Level> levels;
+    TextureContainer::FORMAT format = TextureContainer::FORMAT::RGBA8;
+    GLint residentLevel             = 0;
+    GLint alwaysResidentLevel       = 0;
+    GLint requestedLevel            = 0;
+    //!The level being streamed in, -1 if none.
+    GLint pendingLevel = -1;
+
+    //!The biggest size in pixels the texture was drawn at this frame, see TextureHandler::requestTextureSize.
+    float requestedSize    = 0.0f;
+    bool sizeReported      = false;
+    uint64_t lastUsedFrame = 0;
+
+    friend class TextureHandler;
+};
+
+//!How getTexture loads a texture that isn't in the texture library yet.
+enum class TEXTURE_LOADING {
+    //!The texture is returned right away with a placeholder, the image is decoded on a worker thread and uploaded in a later frame.
+    Asynchronous,
+    //!The image is decoded and uploaded before getTexture returns. Used when the texture's size is needed right away.
+    Synchronous
 };
 
 class CubeMap {
@@ -54,10 +103,16 @@ public:
     inline const std::vector<std::string> getTexturePaths() const {
         return location;
     }
+    inline CubeMapHandle getHandle() const { return handle; }
 
 private:
     std::vector<std::string> location;
     GLuint texture = 0;
+    CubeMapHandle handle;
+
+    size_t residentBytes = 0;
+
+    friend class TextureHandler;
 };
 
 //The TextureHandler class should be used for handling textures and cubemaps throughout the programs duration.
@@ -65,19 +120,134 @@ private:
 class TextureHandler {
 public:
     //Tries to retrieve a texture via file path, if it's not in the texture library then it adds it.
-    Texture& getTexture(std::string filePath, GLint filtering = GL_LINEAR, bool repeatTexture = false);
+    //The texture id changes when a mip level is evicted, so store the handle and bind through getTextureData(handle).
+    //Every call adds a reference to the texture, see releaseTexture.
+    Texture& getTexture(std::string filePath, GLint filtering = GL_LINEAR, bool repeatTexture = false, TEXTURE_LOADING loading = TEXTURE_LOADING::Asynchronous);
+
+    //Returns nullptr if the texture was freed.
+    Texture* getTexture(TextureHandle handle) const { return textures.get(handle); }
+
+    //The texture's current id, 0 if the texture was freed.
+    GLuint getTextureData(TextureHandle handle) const {
+        const Texture* texture = textures.get(handle);
+        return texture ? texture->getTextureData() : 0;
+    }
+
+    //Loading until an asynchronous texture is uploaded, Failed if its image couldn't be read and it kept the checker pattern.
+    ASSET_STATE getTextureState(TextureHandle handle) const { return textures.getState(handle); }
+
+    //Removes a reference added by getTexture. The texture is freed by the next freeUnreferencedTextures if it has no references left.
+    void releaseTexture(TextureHandle handle);
+
+    //Removes a reference added by getCubeMap.
+    void releaseCubeMap(CubeMapHandle handle);
+
+    //Frees every texture and cubemap without references. Called after a scene is loaded, so assets both scenes use stay loaded.
+    void freeUnreferencedTextures();
+
+    //Tells the streamer the texture was drawn sizeInPixels big this frame. Textures that are never reported are kept at full resolution.
+    void requestTextureSize(TextureHandle handle, float sizeInPixels);
+
+    //Picks the mip levels every cooked texture needs, queues the missing ones and evicts the least recently used ones
+    //while over the memory budget. Must be called on the GL thread, once per frame, before processUploads.
+    void updateStreaming();
+
+    void setMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+    size_t getMemoryBudget() const { return memoryBudget; }
+
+    //The video memory used by every texture and cubemap.
+    size_t getResidentBytes() const { return totalResidentBytes + cubeMapBytes; }
+
+    //The video memory every texture would use with the levels it needs this frame.
+    size_t getRequestedBytes() const { return totalRequestedBytes + cubeMapBytes; }
+
+    //The memory budget used unless setMemoryBudget is called.
+    static const size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+    //Levels this size or smaller are always resident, so a texture never waits on the streamer to be drawn.
+    static const uint32_t ALWAYS_RESIDENT_SIZE = 128;
+
+    //Limits how many textures start streaming in per frame.
+    static const unsigned int MAX_STREAM_REQUESTS_PER_FRAME = 4;
+
+    //Uploads the images decoded by the worker threads, until byteBudget bytes were uploaded. At least one image is uploaded if one is ready.
+    //Must be called on the GL thread, once per frame.
+    void processUploads(size_t byteBudget = DEFAULT_UPLOAD_BUDGET);
+
+    //The bytes uploaded per frame by default.
+    static const size_t DEFAULT_UPLOAD_BUDGET = 8 * 1024 * 1024;
 
     //Tries to retrieve a cubemap via file paths, if it's not in the cubemap library then it adds it.
     CubeMap& getCubeMap(const std::string identifier, const std::vector<std::string>& faces);
 
+    TextureHandler() {}
+
     //Free memory allocated for cubemaps and textures.
-    //All allocated pointers are stored in textureLibrary and cubeMapLibrary
+    //All allocated pointers are owned by textures and cubeMaps
     ~TextureHandler();
 
+    TextureHandler(const TextureHandler&) = delete;
+    TextureHandler(TextureHandler&&)      = delete;
+    TextureHandler& operator=(const TextureHandler&) = delete;
+    TextureHandler& operator=(TextureHandler&&) = delete;
+
 private:
+    //An image decoded by a worker thread. Either cooked or surface is set, both are nullptr if it couldn't be loaded.
+    //firstLevel is the level a streaming request starts at, -1 for the texture's first load.
+    struct DecodedImage {
+        Texture* texture                        = nullptr;
+        SDL_Surface* surface                    = nullptr;
+        TextureContainer::CookedTexture* cooked = nullptr;
+        GLint firstLevel                        = -1;
+    };
+
     //Fills Texture with data from filePath if it exists. if not it will use a checker pattern.
     Texture* parseTexture(std::string filePath, GLint filtering, bool repeatTexture);
 
+    //Creates a texture holding the checker pattern and queues its image to be decoded.
+    Texture* parseTextureAsynchronously(std::string filePath, GLint filtering, bool repeatTexture);
+
+    //Sets the wrapping and filtering of the bound texture.
+    void setTextureParameters(GLint filtering, bool repeatTexture);
+
+    //Copies data into the pixel buffer and leaves it bound. Returns the pointer glTexImage2D should read from.
+    const GLvoid* fillPixelBuffer(const void* data, size_t bytes);
+
+    //Uploads the surface into the texture through the pixel buffer and frees it. Returns the amount of bytes uploaded.
+    size_t uploadSurface(Texture& texture, SDL_Surface* surface);
+
+    //Uploads the levels from firstLevel up to lastLevel (exclusive) of a cooked texture through the pixel buffer.
+    //Returns the amount of bytes uploaded.
+    size_t uploadCookedTexture(Texture& texture, const TextureContainer::CookedTexture& cooked, GLint firstLevel, GLint lastLevel);
+
+    //The first level of a cooked texture that is always resident.
+    GLint getAlwaysResidentLevel(const TextureContainer::CookedTexture& cooked) const;
+
+    //The bytes of a cooked texture's levels from firstLevel to its smallest.
+    size_t getLevelBytes(const Texture& texture, GLint firstLevel) const;
+
+    void setResidentBytes(Texture& texture, size_t bytes);
+
+    //Uploads one level of a cooked texture into the bound texture.
+    void uploadLevel(TextureContainer::FORMAT format, const TextureContainer::Level& level, GLint index, const GLvoid* pixels);
+
+    //Frees the biggest resident level of the texture by moving the smaller levels into a new texture, which changes its name.
+    void evictLevel(Texture& texture);
+
+    //Evicts least recently used levels until bytes more fit in the budget. Returns false if they can't fit.
+    bool makeRoom(size_t bytes);
+
+    GLenum getCompressedFormat(TextureContainer::FORMAT format);
+
+    //Reads the cooked version of filePath, see TextureContainer.h. Returns false if there is none or it can't be sampled on this driver.
+    bool readCookedTexture(const std::string& filePath, TextureContainer::CookedTexture& cooked);
+
+    //Blocks until an asynchronous texture is decoded, then uploads it.
+    void finishLoading(Texture& texture);
+
+    //Decodes queued images until the handler is destroyed.
+    void decodeImages();
+
     //Checks if the sdl surface is power of two. Only runs on debug
     void verifySurfaceDimensions(const SDL_Surface& surface);
 
@@ -87,10 +257,8 @@ private:
     //Generates filler image using glTexImage2D with fillerTexturePixels to create a texture to use.
     void teximage2DFillerTexture(GLenum target);
 
-    //Add a new texture to the sorted texture library.
-    Texture& addNewTexture(std::string filePath, GLint filtering, bool repeatTexture);
-
-    Texture* binarySearchTextures(const std::string& key);
+    //Add a new texture to the texture registry.
+    Texture& addNewTexture(std::string filePath, GLint filtering, bool repeatTexture, TEXTURE_LOADING loading);
 
     //Used as data for filepaths which could not find a valid texture to use.
     //These bytes are a simple checkered pattern.
@@ -100,11 +268,32 @@ private:
 
                                         0, 0, 0, 255, 255, 255, 0, 0, 0 };
 
-    //Contains all dynamically allocated pointers for textures
-    std::vector<Texture*> textureLibrary;
+    //Contains all dynamically allocated pointers for textures, keyed by file path.
+    AssetRegistry<Texture> textures;
+
+    //Contains all dynamically allocated pointers for cubemaps, keyed by identifier.
+    AssetRegistry<CubeMap> cubeMaps;
+
+    //Started on the first asynchronous texture.
+    std::vector<std::thread> decodeWorkers;
+
+    //Guards decodeQueue, uploadQueue and stopDecoding.
+    std::mutex decodeMutex;
+    std::condition_variable decodeRequested;
+    std::condition_variable imageDecoded;
+
+    std::deque<DecodedImage> decodeQueue;
+    std::deque<DecodedImage> uploadQueue;
+    bool stopDecoding = false;
+
+    //Images are copied into it so the driver can upload them without blocking.
+    GLuint pixelBuffer = 0;
 
-    //Contains all dynamically allocated pointers for cubemaps
-    std::map<std::string, CubeMap*> cubeMapLibrary;
+    size_t memoryBudget        = DEFAULT_MEMORY_BUDGET;
+    size_t totalResidentBytes  = 0;
+    size_t totalRequestedBytes = 0;
+    size_t cubeMapBytes        = 0;
+    uint64_t currentFrame      = 0;
 };
 
 #endif
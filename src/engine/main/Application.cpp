@@ -157,6 +157,7 @@ void Application::initialize() {
     TextureLocator ::provide(textureService);
     ShaderLocator ::provide(shaderService);
     LuaLocator ::provide(luaService);
+    ModelLocator ::provide(modelService);
 
     thisGame.initialize(currentTime, backEndMessagingSystem);
 }
@@ -168,6 +169,9 @@ void Application::fixedUpdate() {
 
 void Application::render() {
 
+    textureService.updateStreaming();
+    textureService.processUploads();
+
     thisGame.render();
 
     SDL_GL_SwapWindow(gameWindow.getWindow());
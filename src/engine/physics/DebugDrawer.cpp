@@ -7,33 +7,83 @@ void Engine::DebugDrawer::render(const glm::mat4& projectionMatrix, const glm::m
         return;
     }
 
+    std::vector<LineVertex>& depthTested = lineVertices[static_cast<int>(DEBUG_DRAW_MODE::DepthTested)];
+    std::vector<LineVertex>& overlay     = lineVertices[static_cast<int>(DEBUG_DRAW_MODE::Overlay)];
+
+    const GLsizei amountOfDepthTested = static_cast<GLsizei>(depthTested.size());
+    const GLsizei amountOfOverlay     = static_cast<GLsizei>(overlay.size());
+
+    if (amountOfDepthTested + amountOfOverlay == 0) {
+        return;
+    }
+
+    const GLsizeiptr depthTestedBytes = amountOfDepthTested * sizeof(LineVertex);
+    const GLsizeiptr bytes            = depthTestedBytes + amountOfOverlay * sizeof(LineVertex);
+
+    //The stream doubles until it fits the frame's lines, so it only grows a few times.
+    if (bytes > lineStream.getSectionSize()) {
+        GLsizeiptr sectionSize = lineStream.getSectionSize();
+        while (sectionSize < bytes) {
+            sectionSize *= 2;
+        }
+
+        lineStream.resize(sectionSize);
+    }
+
     thisShader.useProgram();
     glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projectionMatrix));
     glUniformMatrix4fv(viewLocation, 1, GL_FALSE, glm::value_ptr(viewMatrix));
 
     glBindVertexArray(VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertID);
-    glBufferData(GL_ARRAY_BUFFER, currentMaxAmountOfVertices * sizeof(glm::vec3), &lineVertices[0].x, GL_DYNAMIC_DRAW);
+    if (char* memory = static_cast<char*>(lineStream.allocate(bytes))) {
+        if (amountOfDepthTested > 0) {
+            memcpy(memory, depthTested.data(), depthTestedBytes);
+        }
+        if (amountOfOverlay > 0) {
+            memcpy(memory + depthTestedBytes, overlay.data(), bytes - depthTestedBytes);
+        }
+        lineStream.commit();
+
+        glEnableVertexAttribArray(positionAttribute);
+        glVertexAttribPointer(positionAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex), (GLvoid*)(lineStream.getOffset() + offsetof(LineVertex, position)));
+
+        glEnableVertexAttribArray(colorAttribute);
+        glVertexAttribPointer(colorAttribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(LineVertex), (GLvoid*)(lineStream.getOffset() + offsetof(LineVertex, color)));
 
-    glEnableVertexAttribArray(positionAttribute);
-    glVertexAttribPointer(positionAttribute, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        glLineWidth(DBG_DRAWER::DEBUG_LINE_WIDTH);
 
-    glBindBuffer(GL_ARRAY_BUFFER, colorID);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * currentMaxAmountOfVertices, &lineColors[0].x, GL_DYNAMIC_DRAW);
+        if (amountOfDepthTested > 0) {
+            glDrawArrays(GL_LINES, 0, amountOfDepthTested);
+        }
 
-    glEnableVertexAttribArray(colorAttribute);
-    glVertexAttribPointer(colorAttribute, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        if (amountOfOverlay > 0) {
+            const GLboolean depthTestWasEnabled = glIsEnabled(GL_DEPTH_TEST);
 
-    glLineWidth(DBG_DRAWER::DEBUG_LINE_WIDTH);
+            glDisable(GL_DEPTH_TEST);
+            glDrawArrays(GL_LINES, amountOfDepthTested, amountOfOverlay);
 
-    glDrawArrays(GL_LINES, 0, currentAmountOfLines);
+            if (depthTestWasEnabled) {
+                glEnable(GL_DEPTH_TEST);
+            }
+        }
+    }
 
-    currentAmountOfLines = 0;
+    depthTested.clear();
+    overlay.clear();
 
     glBindVertexArray(0);
 }
 
+void Engine::DebugDrawer::clear() {
+    for (std::vector<LineVertex>& vertices : lineVertices) {
+        vertices.clear();
+    }
+
+    texts.clear();
+    warnedAboutDroppedLines = false;
+}
+
 void Engine::DebugDrawer::initialize() {
     thisShader = ShaderLocator::getService().getShader("dbg", "assets/shaders/color.vert", "assets/shaders/color.frag", SHADER_TYPE::Default);
 
@@ -46,13 +96,11 @@ void Engine::DebugDrawer::initialize() {
     colorAttribute     = Shaders::getAttribLocation(Shaders::AttribName::Color);
 
     glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-    glGenBuffers(1, &vertID);
-    glGenBuffers(1, &colorID);
-    glBindVertexArray(0);
+    lineStream.initialize(DBG_DRAWER::INITIAL_AMOUNT_DEBUG_LINES * 2 * sizeof(LineVertex));
+
+    lineVertices[static_cast<int>(DEBUG_DRAW_MODE::DepthTested)].reserve(DBG_DRAWER::INITIAL_AMOUNT_DEBUG_LINES * 2);
 
-    currentMaxAmountOfVertices = DBG_DRAWER::MAX_AMOUNT_DEBUG_LINES;
-    initialized                = true;
+    initialized = true;
 }
 
 Engine::DebugDrawer::~DebugDrawer() {
@@ -64,8 +112,6 @@ Engine::DebugDrawer::~DebugDrawer() {
     DBG_LOG("Freeing memory for debug drawer.\n");
 
     glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &vertID);
-    glDeleteBuffers(1, &colorID);
 }
 
 void Engine::DebugDrawer::drawLine(const btVector3& from, const btVector3& to, const btVector3& color) {
@@ -73,15 +119,84 @@ void Engine::DebugDrawer::drawLine(const btVector3& from, const btVector3& to, c
 }
 
 void Engine::DebugDrawer::drawLine(const btVector3& from, const btVector3& to, const btVector3& colorStart, const btVector3& colorEnd) {
-    if (currentAmountOfLines + 1 < DBG_DRAWER::MAX_AMOUNT_DEBUG_LINES) {
-        lineVertices[(currentAmountOfLines)]     = (glm::vec3(from.getX(), from.getY(), from.getZ()));
-        lineVertices[(currentAmountOfLines + 1)] = (glm::vec3(to.getX(), to.getY(), to.getZ()));
-        lineColors[currentAmountOfLines]         = hh::toGlmVec3(colorStart);
-        lineColors[currentAmountOfLines + 1]     = hh::toGlmVec3(colorEnd);
-        currentAmountOfLines += 2;
+    addLine(
+        hh::toGlmVec3(from),
+        hh::toGlmVec3(to),
+        glm::packUnorm4x8(glm::vec4(hh::toGlmVec3(colorStart), 1.0f)),
+        glm::packUnorm4x8(glm::vec4(hh::toGlmVec3(colorEnd), 1.0f)),
+        DEBUG_DRAW_MODE::DepthTested);
+}
+
+void Engine::DebugDrawer::drawLine(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, DEBUG_DRAW_MODE mode) {
+    const uint32_t packedColor = glm::packUnorm4x8(color);
+    addLine(from, to, packedColor, packedColor, mode);
+}
+
+void Engine::DebugDrawer::drawBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec4& color, DEBUG_DRAW_MODE mode) {
+    const uint32_t packedColor = glm::packUnorm4x8(color);
+
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; i++) {
+        corners[i] = center + halfExtents * glm::vec3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+    }
+
+    //Every edge connects two corners that differ in one axis.
+    for (int i = 0; i < 8; i++) {
+        for (int axis = 1; axis < 8; axis <<= 1) {
+            if (!(i & axis)) {
+                addLine(corners[i], corners[i | axis], packedColor, packedColor, mode);
+            }
+        }
     }
 }
 
+void Engine::DebugDrawer::drawSphere(const glm::vec3& center, float radius, const glm::vec4& color, DEBUG_DRAW_MODE mode) {
+    const uint32_t packedColor = glm::packUnorm4x8(color);
+    const float step           = glm::two_pi<float>() / DBG_DRAWER::SPHERE_SEGMENTS;
+
+    for (unsigned int i = 0; i < DBG_DRAWER::SPHERE_SEGMENTS; i++) {
+        const glm::vec2 a = glm::vec2(cosf(step * i), sinf(step * i)) * radius;
+        const glm::vec2 b = glm::vec2(cosf(step * (i + 1)), sinf(step * (i + 1))) * radius;
+
+        addLine(center + glm::vec3(a.x, a.y, 0.0f), center + glm::vec3(b.x, b.y, 0.0f), packedColor, packedColor, mode);
+        addLine(center + glm::vec3(a.x, 0.0f, a.y), center + glm::vec3(b.x, 0.0f, b.y), packedColor, packedColor, mode);
+        addLine(center + glm::vec3(0.0f, a.x, a.y), center + glm::vec3(0.0f, b.x, b.y), packedColor, packedColor, mode);
+    }
+}
+
+void Engine::DebugDrawer::drawText(const glm::vec3& position, const std::string& text) {
+    DebugText debugText;
+    debugText.position = position;
+    debugText.text     = text;
+
+    texts.push_back(debugText);
+}
+
+void Engine::DebugDrawer::addLine(const glm::vec3& from, const glm::vec3& to, uint32_t colorStart, uint32_t colorEnd, DEBUG_DRAW_MODE mode) {
+    const size_t amountOfVertices = lineVertices[static_cast<int>(DEBUG_DRAW_MODE::DepthTested)].size() + lineVertices[static_cast<int>(DEBUG_DRAW_MODE::Overlay)].size();
+
+    if (amountOfVertices + 2 > DBG_DRAWER::MAX_AMOUNT_DEBUG_LINES * 2) {
+        if (!warnedAboutDroppedLines) {
+            DBG_LOG("Too many debug lines this frame, the rest are dropped (DebugDrawer.cpp addLine)\n");
+            warnedAboutDroppedLines = true;
+        }
+        return;
+    }
+
+    std::vector<LineVertex>& vertices = lineVertices[static_cast<int>(mode)];
+
+    LineVertex start;
+    start.position = from;
+    start.color    = colorStart;
+
+    LineVertex end;
+    end.position = to;
+    end.color    = colorEnd;
+
+    vertices.push_back(start);
+    vertices.push_back(end);
+}
+
 void Engine::DebugDrawer::setDebugMode(int debugMode) {
     currentDebugMode = debugMode;
 }
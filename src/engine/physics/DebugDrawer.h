@@ -7,19 +7,44 @@
 
 #include "GameInfo.h"
 #include "Locator.h"
+#include "StreamingBuffer.h"
 #include <LinearMath/btIDebugDraw.h>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/packing.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <string>
 #include <vector>
 
 namespace Engine {
 
     //!Information used for the DebugDrawer.
     namespace DBG_DRAWER {
-        static const unsigned int MAX_AMOUNT_DEBUG_LINES = 16382;
-        static const float DEBUG_LINE_WIDTH              = .75f;
+        //!The line buffers start with room for this many lines and grow when more are drawn.
+        static const unsigned int INITIAL_AMOUNT_DEBUG_LINES = 16384;
+        //!Lines past this in a frame are dropped, with a warning.
+        static const unsigned int MAX_AMOUNT_DEBUG_LINES     = 1048576;
+        static const unsigned int SPHERE_SEGMENTS            = 24;
+        static const float DEBUG_LINE_WIDTH                  = .75f;
     }
 
+    //!Depth tested lines are hidden behind geometry, overlay lines are drawn on top of everything.
+    enum class DEBUG_DRAW_MODE {
+        DepthTested = 0,
+        Overlay     = 1,
+        Max         = 2
+    };
+
+    //!Text drawn at a point in the world. It is always drawn on top.
+    struct DebugText {
+        glm::vec3 position;
+        std::string text;
+    };
+
     //!The DebugDrawer class is used to render Bullet3's collision boxes/points/etc..
+    //!Gameplay code can also draw lines, boxes, spheres and text with it every frame, through PhysicsWorld::getDebugDrawer.
+    //!Nothing is kept between frames, and nothing is drawn unless debug drawing is on.
     //!The DebugDrawer should never be created outside of the PhysicsWorld object.
     class DebugDrawer : public btIDebugDraw {
     public:
@@ -44,22 +69,42 @@ namespace Engine {
         //!Initializes everything
         void initialize();
 
-        //!Renders the lines added via drawLine.
+        //!Renders the lines added since the last render, the depth tested ones first, and removes them.
         void render(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix);
 
+        //!Removes every line and text added since the last frame.
+        void clear();
+
         //!Adds a line to the list of lines to draw next frame
         virtual void drawLine(const btVector3& from, const btVector3& to, const btVector3& color);
 
         //!Adds a line to the list of lines to draw next frame
         void drawLine(const btVector3& from, const btVector3& to, const btVector3& colorStart, const btVector3& colorEnd);
 
+        using btIDebugDraw::drawBox;
+        using btIDebugDraw::drawSphere;
+
+        void drawLine(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, DEBUG_DRAW_MODE mode = DEBUG_DRAW_MODE::DepthTested);
+
+        //!Draws the edges of an axis aligned box.
+        void drawBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec4& color, DEBUG_DRAW_MODE mode = DEBUG_DRAW_MODE::DepthTested);
+
+        //!Draws a circle around each axis.
+        void drawSphere(const glm::vec3& center, float radius, const glm::vec4& color, DEBUG_DRAW_MODE mode = DEBUG_DRAW_MODE::DepthTested);
+
+        //!Adds text at position. The RenderingSystem draws it with the gui.
+        void drawText(const glm::vec3& position, const std::string& text);
+
+        const std::vector<DebugText>& getTexts() const { return texts; }
+
         //!Unimplemented
         virtual void drawContactPoint(const btVector3& PointOnB, const btVector3& normalOnB, btScalar distance, int lifeTime, const btVector3& color) {}
 
         virtual void reportErrorWarning(const char* warningString);
 
-        //!Unimplemented
-        virtual void draw3dText(const btVector3&, const char*) {}
+        virtual void draw3dText(const btVector3& location, const char* textString) {
+            drawText(hh::toGlmVec3(location), textString);
+        }
 
         //!Sets the debug draw mode
         virtual void setDebugMode(int debugMode);
@@ -72,16 +117,29 @@ namespace Engine {
 
         glm::mat4 identitym = glm::mat4(1.0f);
 
-        glm::vec3 lineVertices[Engine::DBG_DRAWER::MAX_AMOUNT_DEBUG_LINES];
-        glm::vec3 lineColors[Engine::DBG_DRAWER::MAX_AMOUNT_DEBUG_LINES];
+        //!Position and color are interleaved so every line is streamed with a single copy.
+        struct LineVertex {
+            glm::vec3 position;
+            //!RGBA8, read as a normalized vec4.
+            uint32_t color;
+        };
+
+        //!Adds a line with packed colors, or drops it if there are too many lines.
+        void addLine(const glm::vec3& from, const glm::vec3& to, uint32_t colorStart, uint32_t colorEnd, DEBUG_DRAW_MODE mode);
+
+        //!The lines of each DEBUG_DRAW_MODE.
+        std::vector<LineVertex> lineVertices[static_cast<int>(DEBUG_DRAW_MODE::Max)];
+
+        std::vector<DebugText> texts;
+
+        int currentDebugMode = 0;
+
+        GLuint VAO = 0;
 
-        int currentDebugMode                    = 0;
-        unsigned int currentMaxAmountOfVertices = 0;
-        unsigned int currentAmountOfLines       = 0;
+        //!Only the vertices added this frame are written into it. Grows if a frame has more lines than it fits.
+        StreamingBuffer lineStream;
 
-        GLuint VAO     = 0;
-        GLuint vertID  = 0;
-        GLuint colorID = 0;
+        bool warnedAboutDroppedLines = false;
 
         GLint positionAttribute  = 0;
         GLint colorAttribute     = 0;
@@ -15,11 +15,6 @@ struct AnimatedMesh {
     std::vector<glm::vec4> boneIDs;
 
     Mesh mesh;
-
-    //These variables do not need serialization
-
-    uint32_t weightsBufferObject;
-    uint32_t boneIDsBufferObject;
 };
 
 }
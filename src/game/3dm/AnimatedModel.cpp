@@ -1,15 +1,15 @@
 #include "AnimatedModel.h"
 
 void _3DM::AnimatedModel::removeKeyframes(unsigned int channelIndex) {
-    if (channelIndex < modelsAnimation.channels.size()) {
-        modelsAnimation.channels.erase(modelsAnimation.channels.begin() + channelIndex);
+    if (channelIndex < resource->animation.channels.size()) {
+        resource->animation.channels.erase(resource->animation.channels.begin() + channelIndex);
     }
 }
 
 void _3DM::AnimatedModel::addScaleToKeyFrames(const glm::vec3& scale, unsigned int channelIndex) {
-    if (channelIndex < modelsAnimation.channels.size()) {
-        for (unsigned int i = 0; i < modelsAnimation.channels.at(channelIndex).scalingKeys.size(); i++) {
-            modelsAnimation.channels.at(channelIndex).scalingKeys[i].origin += scale;
+    if (channelIndex < resource->animation.channels.size()) {
+        for (unsigned int i = 0; i < resource->animation.channels.at(channelIndex).scalingKeys.size(); i++) {
+            resource->animation.channels.at(channelIndex).scalingKeys[i].origin += scale;
         }
     }
 #ifdef DEBUG
@@ -21,9 +21,9 @@ void _3DM::AnimatedModel::addScaleToKeyFrames(const glm::vec3& scale, unsigned i
 
 void _3DM::AnimatedModel::overwriteScaleKeyFrames(const glm::vec3& scale, unsigned int channelIndex) {
 
-    if (channelIndex < modelsAnimation.channels.size()) {
-        for (unsigned int i = 0; i < modelsAnimation.channels.at(channelIndex).scalingKeys.size(); i++) {
-            modelsAnimation.channels.at(channelIndex).scalingKeys[i].origin = scale;
+    if (channelIndex < resource->animation.channels.size()) {
+        for (unsigned int i = 0; i < resource->animation.channels.at(channelIndex).scalingKeys.size(); i++) {
+            resource->animation.channels.at(channelIndex).scalingKeys[i].origin = scale;
         }
     }
 #ifdef DEBUG
@@ -35,9 +35,9 @@ void _3DM::AnimatedModel::overwriteScaleKeyFrames(const glm::vec3& scale, unsign
 
 void _3DM::AnimatedModel::addPositionToKeyFrames(const glm::vec3& position, unsigned int channelIndex) {
 
-    if (channelIndex < modelsAnimation.channels.size()) {
-        for (unsigned int i = 0; i < modelsAnimation.channels.at(channelIndex).positionKeys.size(); i++) {
-            modelsAnimation.channels.at(channelIndex).positionKeys[i].origin += position;
+    if (channelIndex < resource->animation.channels.size()) {
+        for (unsigned int i = 0; i < resource->animation.channels.at(channelIndex).positionKeys.size(); i++) {
+            resource->animation.channels.at(channelIndex).positionKeys[i].origin += position;
         }
     } else {
         DBG_LOG("local variable channelIndex goes out of bounds.\n");
@@ -45,9 +45,9 @@ void _3DM::AnimatedModel::addPositionToKeyFrames(const glm::vec3& position, unsi
 }
 
 void _3DM::AnimatedModel::overWritePositionToKeyFrames(const glm::vec3& position, unsigned int channelIndex) {
-    if (channelIndex < modelsAnimation.channels.size()) {
-        for (unsigned int i = 0; i < modelsAnimation.channels.at(channelIndex).positionKeys.size(); i++) {
-            modelsAnimation.channels.at(channelIndex).positionKeys[i].origin = position;
+    if (channelIndex < resource->animation.channels.size()) {
+        for (unsigned int i = 0; i < resource->animation.channels.at(channelIndex).positionKeys.size(); i++) {
+            resource->animation.channels.at(channelIndex).positionKeys[i].origin = position;
         }
     } else {
         DBG_LOG("local variable channelIndex goes out of bounds.\n");
@@ -55,54 +55,103 @@ void _3DM::AnimatedModel::overWritePositionToKeyFrames(const glm::vec3& position
 }
 
 void _3DM::AnimatedModel::initialize(Shader& shader) {
+    if (!modelLoaded) {
+        printf("Please load in a model before initializing buffers. ( _3DM::AnimatedModel::initialize() )\n");
+        return;
+    }
+
+    //Every model sharing the geometry may have released it already.
+    if (keepGeometry || !resource->uploaded) {
+        ModelLocator::getService().reloadGeometry(resourceHandle);
+    }
+
     // loop through each mesh and initialize them
     for (unsigned int i = 0; i < meshes.size(); i++) {
+        initializeTexture(meshes[i], shader);
+    }
+
+    //The buffers are shared, so they are only generated by the first model loaded from the file.
+    if (!resource->uploaded) {
+        for (unsigned int i = 0; i < resource->meshes.size(); i++) {
+            initializeBuffers(resource->meshes[i], shader);
 
-        initializeTexture(meshes[i].mesh, shader);
-        initializeBuffers(meshes[i].mesh, shader);
-        initializeBoneBuffers(meshes[i], shader);
+            glBindVertexArray(0);
+        }
 
-        glBindVertexArray(0);
+        resource->uploaded = true;
     }
+
     initialized   = true;
     animatedModel = true;
+
+    if (!keepGeometry) {
+        releaseGeometry();
+    }
 }
 
-_3DM::AnimatedModel::~AnimatedModel() {
+void _3DM::AnimatedModel::releaseGeometry() {
+    if (!usesGeometry) {
+        return;
+    }
 
-    if (!initialized) {
-        //If the object is not initialized then no buffers were generated.
+    usesGeometry = false;
+    resource->geometryUsers--;
+
+    if (resource->geometryUsers > 0) {
         return;
     }
 
-    DBG_LOG("Freeing memory for animated model.\n");
+    for (unsigned int i = 0; i < resource->meshes.size(); i++) {
+        VertexFormat::releaseGeometry(resource->meshes[i]);
+    }
+
+    resource->hasGeometry = false;
+}
+
+_3DM::AnimatedModel::~AnimatedModel() {
 
     for (unsigned int i = 0; i < meshes.size(); i++) {
-        AnimatedMesh& mesh = meshes.at(i);
+        for (unsigned int j = 0; j < meshes[i].textures.size(); j++) {
+            TextureLocator::getService().releaseTexture(meshes[i].textures[j].texture);
+        }
+    }
 
-        glDeleteBuffers(1, &mesh.weightsBufferObject);
-        glDeleteBuffers(1, &mesh.boneIDsBufferObject);
-        glDeleteVertexArrays(1, &mesh.mesh.vertexArrayObject);
-        glDeleteBuffers(1, &mesh.mesh.vertexBufferObject);
-        glDeleteBuffers(1, &mesh.mesh.elementBufferObject);
-        glDeleteBuffers(1, &mesh.mesh.uvBufferObject);
-        glDeleteBuffers(1, &mesh.mesh.normalBufferObject);
+    if (!resource) {
+        return;
     }
+
+    //The buffers are deleted with the resource, once no model uses it.
+    releaseGeometry();
+    ModelLocator::getService().releaseAnimatedModel(resourceHandle);
 }
 
 _3DM::AnimatedModel::AnimatedModel(const std::string& path) {
-    _3DM_IO modelLoader;
-    *this = modelLoader.readAnimatedModel(path);
+    ModelHandler& models = ModelLocator::getService();
 
-    if (!modelLoaded) {
-        printf("Please load in a model before initializing buffers. ( _3DM::Model::initialize() )\n");
+    resourceHandle = models.getAnimatedModel(path);
+    resource       = models.getResource(resourceHandle);
+    filePath       = path;
+
+    if (!resource) {
+        DBG_LOG("The animated model %s could not be loaded (_3DM::AnimatedModel::AnimatedModel)\n", path.c_str());
         return;
     }
+
+    for (unsigned int i = 0; i < resource->meshes.size(); i++) {
+        meshes.push_back(copyMeshInstance(resource->meshes[i].mesh));
+    }
+
+    //Every model starts in the bind pose stored in the file.
+    boneTransformations = resource->animation.boneTransformations;
+
+    resource->geometryUsers++;
+    usesGeometry = true;
+    modelLoaded  = true;
 }
 
 glm::mat4 _3DM::AnimatedModel::getMeshMatrix(unsigned int index) const {
     if (index < meshes.size() && index >= 0) {
-        return meshes.at(index).mesh.baseModelMatrix;
+        return meshes.at(index).baseModelMatrix;
     } else {
         DBG_LOG("Index went out of bounds (glm::mat4 _3DM::AnimatedModel::getMeshMatrix in AnimatedModel.cpp)\n");
     }
@@ -110,16 +159,54 @@ glm::mat4 _3DM::AnimatedModel::getMeshMatrix(unsigned int index) const {
     return glm::mat4();
 }
 
+glm::mat4 _3DM::AnimatedModel::getMeshTransformation(unsigned int index) const {
+    if (index >= meshes.size()) {
+        DBG_LOG("Index went out of bounds (_3DM::AnimatedModel::getMeshTransformation)\n");
+        return glm::mat4(1.0f);
+    }
+
+    glm::mat4 transformation = meshes.at(index).baseModelMatrix;
+
+    transformation = glm::translate(transformation, transform.position);
+    transformation = glm::rotate(transformation, glm::angle(transform.rotation), glm::axis(transform.rotation));
+    transformation = glm::scale(transformation, transform.scale);
+
+    return transformation;
+}
+
+bool _3DM::AnimatedModel::canInstanceWith(const AnimatedModel& other) const {
+    if (filePath != other.filePath || meshes.size() != other.meshes.size() || amountOfBones() != other.amountOfBones()) {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < meshes.size(); i++) {
+        const std::vector<ModelTexture>& textures      = meshes[i].textures;
+        const std::vector<ModelTexture>& otherTextures = other.meshes[i].textures;
+
+        if (textures.size() != otherTextures.size()) {
+            return false;
+        }
+
+        for (unsigned int j = 0; j < textures.size(); j++) {
+            if (textures[j].texture != otherTextures[j].texture || textures[j].uniformName != otherTextures[j].uniformName) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 void _3DM::AnimatedModel::setMeshMatrix(unsigned int index, const glm::mat4& newMatrix) {
     if (index < meshes.size() && index >= 0) {
-        meshes.at(index).mesh.baseModelMatrix = newMatrix;
+        meshes.at(index).baseModelMatrix = newMatrix;
     }
 }
 
 void _3DM::AnimatedModel::addRotationToKeyFrames(const glm::quat& rotation, unsigned int channelIndex) {
-    if (channelIndex < modelsAnimation.channels.size()) {
-        for (unsigned int i = 0; i < modelsAnimation.channels.at(channelIndex).rotationKeys.size(); i++) {
-            modelsAnimation.channels.at(channelIndex).rotationKeys[i].origin += rotation;
+    if (channelIndex < resource->animation.channels.size()) {
+        for (unsigned int i = 0; i < resource->animation.channels.at(channelIndex).rotationKeys.size(); i++) {
+            resource->animation.channels.at(channelIndex).rotationKeys[i].origin += rotation;
         }
     } else {
         DBG_LOG("local variable channelIndex goes out of bounds.\n");
@@ -128,19 +215,19 @@ void _3DM::AnimatedModel::addRotationToKeyFrames(const glm::quat& rotation, unsi
 
 void _3DM::AnimatedModel::addRotationToKeyFrames(const glm::vec3& rotation, unsigned int channelIndex) {
 
-    if (channelIndex < modelsAnimation.channels.size()) {
+    if (channelIndex < resource->animation.channels.size()) {
 
         glm::vec3 rot;
         rot.x = glm::radians(rotation.x);
         rot.y = glm::radians(rotation.y);
         rot.z = glm::radians(rotation.z);
 
-        for (unsigned int i = 0; i < modelsAnimation.channels.at(channelIndex).rotationKeys.size(); i++) {
+        for (unsigned int i = 0; i < resource->animation.channels.at(channelIndex).rotationKeys.size(); i++) {
 
-            modelsAnimation.channels.at(channelIndex).rotationKeys[i].origin.w = 1;
-            modelsAnimation.channels.at(channelIndex).rotationKeys[i].origin.x += rot.x;
-            modelsAnimation.channels.at(channelIndex).rotationKeys[i].origin.y += rot.y;
-            modelsAnimation.channels.at(channelIndex).rotationKeys[i].origin.z += rot.z;
+            resource->animation.channels.at(channelIndex).rotationKeys[i].origin.w = 1;
+            resource->animation.channels.at(channelIndex).rotationKeys[i].origin.x += rot.x;
+            resource->animation.channels.at(channelIndex).rotationKeys[i].origin.y += rot.y;
+            resource->animation.channels.at(channelIndex).rotationKeys[i].origin.z += rot.z;
         }
     } else {
         DBG_LOG("local variable channelIndex goes out of bounds.\n");
@@ -149,12 +236,12 @@ void _3DM::AnimatedModel::addRotationToKeyFrames(const glm::vec3& rotation, unsi
 
 void _3DM::AnimatedModel::overwriteRotationKeyFrames(const glm::vec3& rotation, unsigned int channelIndex) {
 
-    if (channelIndex < modelsAnimation.channels.size()) {
+    if (channelIndex < resource->animation.channels.size()) {
 
         glm::quat rot = hh::toQuaternion(rotation);
 
-        for (unsigned int i = 0; i < modelsAnimation.channels.at(channelIndex).rotationKeys.size(); i++) {
-            modelsAnimation.channels.at(channelIndex).rotationKeys[i].origin = rot;
+        for (unsigned int i = 0; i < resource->animation.channels.at(channelIndex).rotationKeys.size(); i++) {
+            resource->animation.channels.at(channelIndex).rotationKeys[i].origin = rot;
         }
     } else {
         DBG_LOG("local variable channelIndex goes out of bounds.\n");
@@ -162,9 +249,9 @@ void _3DM::AnimatedModel::overwriteRotationKeyFrames(const glm::vec3& rotation,
 }
 
 void _3DM::AnimatedModel::overwriteRotationKeyFrames(const glm::quat& rotation, unsigned int channelIndex) {
-    if (channelIndex < modelsAnimation.channels.size()) {
-        for (unsigned int i = 0; i < modelsAnimation.channels.at(channelIndex).rotationKeys.size(); i++) {
-            modelsAnimation.channels.at(channelIndex).rotationKeys[i].origin = rotation;
+    if (channelIndex < resource->animation.channels.size()) {
+        for (unsigned int i = 0; i < resource->animation.channels.at(channelIndex).rotationKeys.size(); i++) {
+            resource->animation.channels.at(channelIndex).rotationKeys[i].origin = rotation;
         }
     } else {
         DBG_LOG("local variable channelIndex goes out of bounds.\n");
@@ -172,8 +259,8 @@ void _3DM::AnimatedModel::overwriteRotationKeyFrames(const glm::quat& rotation,
 }
 
 glm::mat4 _3DM::AnimatedModel::getBoneTransformation(unsigned int boneId) const {
-    if (boneId < modelsAnimation.boneTransformations.size()) {
-        return modelsAnimation.boneTransformations.at(boneId);
+    if (boneId < boneTransformations.size()) {
+        return boneTransformations.at(boneId);
     } else {
         DBG_LOG("local variable boneId goes out of bounds.\n");
         return glm::mat4(1.0);
@@ -182,22 +269,22 @@ glm::mat4 _3DM::AnimatedModel::getBoneTransformation(unsigned int boneId) const
 
 glm::mat4 _3DM::AnimatedModel::getBoneTransformationWithoutOffset(unsigned int boneId) const {
 
-    std::map<std::string, glm::mat4>::const_iterator boneMatrixIT = modelsAnimation.boneOffset.find(getBoneName(boneId));
+    std::map<std::string, glm::mat4>::const_iterator boneMatrixIT = resource->animation.boneOffset.find(getBoneName(boneId));
 
-    if (boneMatrixIT != modelsAnimation.boneOffset.end()) {
+    if (boneMatrixIT != resource->animation.boneOffset.end()) {
         return getBoneTransformation(boneId) / boneMatrixIT->second; //Use matrix division to undo the multiplication of the bone offset.
     }
     return glm::mat4();
 }
 
 glm::mat4 _3DM::AnimatedModel::getBoneTransformationWithoutOffset(const std::string& name) const {
-    std::map<std::string, uint32_t>::const_iterator boneIDNameIT = boneIDMap.find(name);
+    std::map<std::string, uint32_t>::const_iterator boneIDNameIT = resource->boneIDMap.find(name);
 
-    if (boneIDNameIT != boneIDMap.end()) {
+    if (boneIDNameIT != resource->boneIDMap.end()) {
 
-        std::map<std::string, glm::mat4>::const_iterator boneMatrixIT = modelsAnimation.boneOffset.find(boneIDNameIT->first);
+        std::map<std::string, glm::mat4>::const_iterator boneMatrixIT = resource->animation.boneOffset.find(boneIDNameIT->first);
 
-        if (boneMatrixIT != modelsAnimation.boneOffset.end()) {
+        if (boneMatrixIT != resource->animation.boneOffset.end()) {
             return getBoneTransformation(getBoneID(name)) / boneMatrixIT->second; //Use matrix division to undo the multiplication of the bone offset.
         }
     }
@@ -207,21 +294,21 @@ glm::mat4 _3DM::AnimatedModel::getBoneTransformationWithoutOffset(const std::str
 
 std::vector<glm::vec3>* _3DM::AnimatedModel::getMeshVertices(unsigned int index) {
     if (index < meshes.size()) {
-        return &(meshes.at(index).mesh.vertices);
+        return &(resource->meshes.at(index).mesh.vertices);
     }
     return nullptr;
 }
 
 std::vector<uint32_t>* _3DM::AnimatedModel::getMeshIndices(unsigned int index) {
     if (index < meshes.size()) {
-        return &(meshes.at(index).mesh.indices);
+        return &(resource->meshes.at(index).mesh.indices);
     }
     return nullptr;
 }
 
 void _3DM::AnimatedModel::setBoneMatrix(const glm::mat4& transformation, unsigned int boneId) {
-    if (boneId < modelsAnimation.boneTransformations.size()) {
-        modelsAnimation.boneTransformations.at(boneId) = transformation;
+    if (boneId < boneTransformations.size()) {
+        boneTransformations.at(boneId) = transformation;
     } else {
         DBG_LOG("There was an error setting the bone matrix. local variable boneId goes out of bounds.\n");
     }
@@ -233,34 +320,34 @@ void _3DM::AnimatedModel::addTexture(const Texture& texture, unsigned int meshIn
         return;
     }
 
-    AnimatedMesh& animMesh = meshes.at(meshIndex);
+    Mesh& mesh = meshes.at(meshIndex);
 
     ModelTexture modelTexture;
     std::stringstream stringStream;
 
-    modelTexture.imageID   = texture.getTextureData();
+    modelTexture.texture   = texture.getHandle();
     modelTexture.imagePath = texture.getLocation();
     modelTexture.imageType = type;
 
     switch (type) {
     case _3DM::TextureType::Diffuse:
-        animMesh.mesh.diffuseIndex++;
-        stringStream << animMesh.mesh.diffuseIndex;
+        mesh.diffuseIndex++;
+        stringStream << mesh.diffuseIndex;
         modelTexture.uniformName = Shaders::getUniformName(Shaders::UniformName::DiffuseTexture) + stringStream.str();
         break;
     case _3DM::TextureType::Specular:
-        animMesh.mesh.specularIndex++;
-        stringStream << animMesh.mesh.specularIndex;
+        mesh.specularIndex++;
+        stringStream << mesh.specularIndex;
         modelTexture.uniformName = Shaders::getUniformName(Shaders::UniformName::SpecularTexture) + stringStream.str();
         break;
     case _3DM::TextureType::Normals:
-        animMesh.mesh.normalsIndex++;
-        stringStream << animMesh.mesh.normalsIndex;
+        mesh.normalsIndex++;
+        stringStream << mesh.normalsIndex;
         modelTexture.uniformName = Shaders::getUniformName(Shaders::UniformName::NormalTexture) + stringStream.str();
         break;
     }
 
-    animMesh.mesh.textures.push_back(modelTexture);
+    mesh.textures.push_back(modelTexture);
 }
 
 void _3DM::AnimatedModel::fixedUpdateAnimation() {
@@ -275,16 +362,16 @@ void _3DM::AnimatedModel::fixedUpdateAnimation() {
 
     if (currentBlendingTime < blendingTime) {
         blendBoneTree(
-            blendingLastFrameTime * modelsAnimation.ticksPerSecond,
-            &modelsAnimation.rootBone, //the root bone node
+            blendingLastFrameTime * resource->animation.ticksPerSecond,
+            &resource->animation.rootBone, //the root bone node
             glm::mat4(1.0f) //an Identity matrix, since the root bone node has no parents.
         );
         currentBlendingTime += GameInfo::fixedDeltaTime;
     } else {
         //if this doesn't work, then maybe you did not initialize the model, or its not the right format.
         updateBoneTree(
-            timeSinceAnimationStarted * modelsAnimation.ticksPerSecond, //current time multiplied by the current frames ticks per second.
-            &modelsAnimation.rootBone, //the root bone node
+            timeSinceAnimationStarted * resource->animation.ticksPerSecond, //current time multiplied by the current frames ticks per second.
+            &resource->animation.rootBone, //the root bone node
             glm::mat4(1.0f) //an Identity matrix, since the root bone node has no parents.
         );
 
@@ -295,7 +382,7 @@ void _3DM::AnimatedModel::fixedUpdateAnimation() {
 //Returns -1 on failure.
 int _3DM::AnimatedModel::getMeshIndex(const std::string& MeshName) const {
     for (unsigned int i = 0; i < meshes.size(); i++) {
-        if (meshes[i].mesh.name == MeshName) {
+        if (meshes[i].name == MeshName) {
             return i;
         }
     }
@@ -315,7 +402,7 @@ void _3DM::AnimatedModel::renderSingleMesh(unsigned int index, Shader& shader) {
 }
 
 void _3DM::AnimatedModel::setAnimationClip(unsigned int clip) {
-    if (clip < animationClips.size()) {
+    if (clip < resource->animationClips.size()) {
         currentAnimationClip = clip;
     }
 #ifdef DEBUG
@@ -327,8 +414,8 @@ void _3DM::AnimatedModel::setAnimationClip(unsigned int clip) {
 
 //Returns -1 on failure of finding animation clip
 int _3DM::AnimatedModel::getAnimationIndex(const std::string& name) const {
-    for (unsigned int i = 0; i < animationClips.size(); i++) {
-        if (name == animationClips[i].name) {
+    for (unsigned int i = 0; i < resource->animationClips.size(); i++) {
+        if (name == resource->animationClips[i].name) {
             return i;
         }
     }
@@ -337,16 +424,16 @@ int _3DM::AnimatedModel::getAnimationIndex(const std::string& name) const {
 
 //Returns -1 on failure of finding bone ID
 int _3DM::AnimatedModel::getBoneID(const std::string& nodeName) const {
-    std::map<std::string, uint32_t>::const_iterator boneIDNameIT = boneIDMap.find(nodeName);
+    std::map<std::string, uint32_t>::const_iterator boneIDNameIT = resource->boneIDMap.find(nodeName);
 
-    if (boneIDNameIT != boneIDMap.end()) {
+    if (boneIDNameIT != resource->boneIDMap.end()) {
         return boneIDNameIT->second;
     }
     return -1;
 }
 
 std::string _3DM::AnimatedModel::getBoneName(uint32_t id) const {
-    for (std::map<std::string, uint32_t>::const_iterator it = boneIDMap.begin(); it != boneIDMap.end(); it++) {
+    for (std::map<std::string, uint32_t>::const_iterator it = resource->boneIDMap.begin(); it != resource->boneIDMap.end(); it++) {
         if (id == it->second) {
             return it->first;
         }
@@ -358,8 +445,8 @@ std::string _3DM::AnimatedModel::getBoneName(uint32_t id) const {
 //Returns -1 on failure of finding channel's index
 int _3DM::AnimatedModel::getChannelIndex(const std::string& channelName) const {
 
-    for (unsigned int i = 0; i < modelsAnimation.channels.size(); i++) {
-        if (channelName == modelsAnimation.channels[i].name) {
+    for (unsigned int i = 0; i < resource->animation.channels.size(); i++) {
+        if (channelName == resource->animation.channels[i].name) {
             return i;
         }
     }
@@ -385,18 +472,18 @@ void _3DM::AnimatedModel::updateBoneTree(const float& timeInTicks, _3DM::BoneNod
         float currentTime = std::fmod //get floating point modulus.
             (
                 timeInTicks,
-                animationClips.at(currentAnimationClip).endTime - animationClips.at(currentAnimationClip).startTime);
+                resource->animationClips.at(currentAnimationClip).endTime - resource->animationClips.at(currentAnimationClip).startTime);
 
         if (std::isnan(currentTime)) {
             currentTime = 0;
         }
 
-        currentTime += animationClips.at(currentAnimationClip).startTime;
+        currentTime += resource->animationClips.at(currentAnimationClip).startTime;
 
         //Get the current keyframes in the animation, and the interpolation value (0.0-1.0)
-        InterpolatedFrame translationKeysIndex = getKeyframesAtTime(modelsAnimation.channels.at(channelIndex).positionKeys, currentTime);
-        InterpolatedFrame scaleKeysIndex       = getKeyframesAtTime(modelsAnimation.channels.at(channelIndex).scalingKeys, currentTime);
-        InterpolatedFrame rotationKeysIndex    = getKeyframesAtTime(modelsAnimation.channels.at(channelIndex).rotationKeys, currentTime);
+        InterpolatedFrame translationKeysIndex = getKeyframesAtTime(resource->animation.channels.at(channelIndex).positionKeys, currentTime);
+        InterpolatedFrame scaleKeysIndex       = getKeyframesAtTime(resource->animation.channels.at(channelIndex).scalingKeys, currentTime);
+        InterpolatedFrame rotationKeysIndex    = getKeyframesAtTime(resource->animation.channels.at(channelIndex).rotationKeys, currentTime);
 
         /********************************************************************************************************************
 		*Here, we create the transformation matrix for this bone node.														*
@@ -409,32 +496,32 @@ void _3DM::AnimatedModel::updateBoneTree(const float& timeInTicks, _3DM::BoneNod
 
                          hh::lerp //translation
                          (
-                             modelsAnimation.channels.at(channelIndex).positionKeys.at(translationKeysIndex.firstFrame).origin,
-                             modelsAnimation.channels.at(channelIndex).positionKeys.at(translationKeysIndex.lastFrame).origin,
+                             resource->animation.channels.at(channelIndex).positionKeys.at(translationKeysIndex.firstFrame).origin,
+                             resource->animation.channels.at(channelIndex).positionKeys.at(translationKeysIndex.lastFrame).origin,
                              translationKeysIndex.interpolation))
             * glm::mat4_cast(
                          glm::slerp //rotation
                          (
-                             modelsAnimation.channels.at(channelIndex).rotationKeys.at(rotationKeysIndex.firstFrame).origin,
-                             modelsAnimation.channels.at(channelIndex).rotationKeys.at(rotationKeysIndex.lastFrame).origin,
+                             resource->animation.channels.at(channelIndex).rotationKeys.at(rotationKeysIndex.firstFrame).origin,
+                             resource->animation.channels.at(channelIndex).rotationKeys.at(rotationKeysIndex.lastFrame).origin,
                              rotationKeysIndex.interpolation))
             * glm::scale(
                          glm::mat4(1.0f),
                          hh::lerp //scale
                          (
-                             modelsAnimation.channels.at(channelIndex).scalingKeys.at(scaleKeysIndex.firstFrame).origin,
-                             modelsAnimation.channels.at(channelIndex).scalingKeys.at(scaleKeysIndex.lastFrame).origin,
+                             resource->animation.channels.at(channelIndex).scalingKeys.at(scaleKeysIndex.firstFrame).origin,
+                             resource->animation.channels.at(channelIndex).scalingKeys.at(scaleKeysIndex.lastFrame).origin,
                              scaleKeysIndex.interpolation));
 
         int boneIndex = getBoneID(node->name);
 
         if (boneIndex != -1) {
-            modelsAnimation.boneTransformations.at(boneIndex) = finalModel * modelsAnimation.boneOffset[node->name];
+            boneTransformations.at(boneIndex) = finalModel * resource->animation.boneOffset[node->name];
 
-            //DBG_LOG(" %s Offset = %f, %f, %f\n\n", node->name.c_str(), modelsAnimation.boneOffset[node->name][3][0], modelsAnimation.boneOffset[node->name][3][1], modelsAnimation.boneOffset[node->name][3][2]);
+            //DBG_LOG(" %s Offset = %f, %f, %f\n\n", node->name.c_str(), resource->animation.boneOffset[node->name][3][0], resource->animation.boneOffset[node->name][3][1], resource->animation.boneOffset[node->name][3][2]);
 
         } else {
-            modelsAnimation.boneTransformations.at(boneIDMap[node->name]) = finalModel;
+            boneTransformations.at(resource->boneIDMap[node->name]) = finalModel;
         }
     }
 
@@ -462,37 +549,37 @@ void _3DM::AnimatedModel::blendBoneTree(const float& lastAnimationTime, _3DM::Bo
         float currentTime = std::fmod //get floating point modulus.
             (
                 lastAnimationTime,
-                animationClips.at(blendinglastAnimationClip).endTime - animationClips.at(blendinglastAnimationClip).startTime);
+                resource->animationClips.at(blendinglastAnimationClip).endTime - resource->animationClips.at(blendinglastAnimationClip).startTime);
 
         if (std::isnan(currentTime)) {
             currentTime = 0;
         }
 
-        currentTime += animationClips.at(blendinglastAnimationClip).startTime;
+        currentTime += resource->animationClips.at(blendinglastAnimationClip).startTime;
 
         //Get the current keyframes in the animation, and the interpolation value (0.0-1.0)
-        InterpolatedFrame translationKeysIndex = getKeyframesAtTime(modelsAnimation.channels.at(channelIndex).positionKeys, currentTime);
-        InterpolatedFrame scaleKeysIndex       = getKeyframesAtTime(modelsAnimation.channels.at(channelIndex).scalingKeys, currentTime);
-        InterpolatedFrame rotationKeysIndex    = getKeyframesAtTime(modelsAnimation.channels.at(channelIndex).rotationKeys, currentTime);
+        InterpolatedFrame translationKeysIndex = getKeyframesAtTime(resource->animation.channels.at(channelIndex).positionKeys, currentTime);
+        InterpolatedFrame scaleKeysIndex       = getKeyframesAtTime(resource->animation.channels.at(channelIndex).scalingKeys, currentTime);
+        InterpolatedFrame rotationKeysIndex    = getKeyframesAtTime(resource->animation.channels.at(channelIndex).rotationKeys, currentTime);
 
         //For fast blending, set orientation to the first index (???KeysIndex.x) and do not lerp / slerp.
 
         glm::vec3 aiTranslation = hh::lerp //translation
             (
-                modelsAnimation.channels.at(channelIndex).positionKeys.at(translationKeysIndex.firstFrame).origin,
-                modelsAnimation.channels.at(channelIndex).positionKeys.at(translationKeysIndex.lastFrame).origin,
+                resource->animation.channels.at(channelIndex).positionKeys.at(translationKeysIndex.firstFrame).origin,
+                resource->animation.channels.at(channelIndex).positionKeys.at(translationKeysIndex.lastFrame).origin,
                 translationKeysIndex.interpolation);
 
         glm::vec3 aiScale = hh::lerp //scale
             (
-                modelsAnimation.channels.at(channelIndex).scalingKeys.at(scaleKeysIndex.firstFrame).origin,
-                modelsAnimation.channels.at(channelIndex).scalingKeys.at(scaleKeysIndex.lastFrame).origin,
+                resource->animation.channels.at(channelIndex).scalingKeys.at(scaleKeysIndex.firstFrame).origin,
+                resource->animation.channels.at(channelIndex).scalingKeys.at(scaleKeysIndex.lastFrame).origin,
                 scaleKeysIndex.interpolation);
 
         glm::quat aiRotation = glm::slerp //rotation
             (
-                modelsAnimation.channels.at(channelIndex).rotationKeys.at(rotationKeysIndex.firstFrame).origin,
-                modelsAnimation.channels.at(channelIndex).rotationKeys.at(rotationKeysIndex.lastFrame).origin,
+                resource->animation.channels.at(channelIndex).rotationKeys.at(rotationKeysIndex.firstFrame).origin,
+                resource->animation.channels.at(channelIndex).rotationKeys.at(rotationKeysIndex.lastFrame).origin,
                 rotationKeysIndex.interpolation);
 
         float interpolationValue = currentBlendingTime / blendingTime;
@@ -500,19 +587,19 @@ void _3DM::AnimatedModel::blendBoneTree(const float& lastAnimationTime, _3DM::Bo
         aiTranslation = hh::lerp //translation
             (
                 aiTranslation,
-                modelsAnimation.channels.at(channelIndex).positionKeys.at(getNearestFrameAtTime(modelsAnimation.channels.at(channelIndex).positionKeys, animationClips.at(currentAnimationClip).startTime)).origin,
+                resource->animation.channels.at(channelIndex).positionKeys.at(getNearestFrameAtTime(resource->animation.channels.at(channelIndex).positionKeys, resource->animationClips.at(currentAnimationClip).startTime)).origin,
                 interpolationValue);
 
         aiScale = hh::lerp //scale
             (
                 aiScale,
-                modelsAnimation.channels.at(channelIndex).scalingKeys.at(getNearestFrameAtTime(modelsAnimation.channels.at(channelIndex).scalingKeys, animationClips.at(currentAnimationClip).startTime)).origin,
+                resource->animation.channels.at(channelIndex).scalingKeys.at(getNearestFrameAtTime(resource->animation.channels.at(channelIndex).scalingKeys, resource->animationClips.at(currentAnimationClip).startTime)).origin,
                 interpolationValue);
 
         aiRotation = glm::slerp //rotation
             (
                 aiRotation,
-                modelsAnimation.channels.at(channelIndex).rotationKeys.at(getNearestFrameAtTime(modelsAnimation.channels.at(channelIndex).rotationKeys, animationClips.at(currentAnimationClip).startTime)).origin,
+                resource->animation.channels.at(channelIndex).rotationKeys.at(getNearestFrameAtTime(resource->animation.channels.at(channelIndex).rotationKeys, resource->animationClips.at(currentAnimationClip).startTime)).origin,
                 interpolationValue);
 
         /********************************************************************************************************************
@@ -528,9 +615,9 @@ void _3DM::AnimatedModel::blendBoneTree(const float& lastAnimationTime, _3DM::Bo
         int boneIndex = getBoneID(node->name);
 
         if (boneIndex != -1) {
-            modelsAnimation.boneTransformations.at(boneIndex) = finalModel * modelsAnimation.boneOffset[node->name];
+            boneTransformations.at(boneIndex) = finalModel * resource->animation.boneOffset[node->name];
         } else {
-            modelsAnimation.boneTransformations.at(boneIDMap[node->name]) = finalModel;
+            boneTransformations.at(resource->boneIDMap[node->name]) = finalModel;
         }
     }
 
@@ -547,13 +634,13 @@ void _3DM::AnimatedModel::blendBoneTree(const float& lastAnimationTime, _3DM::Bo
 * This function contains NO bounds checking					 *
 **************************************************************/
 void _3DM::AnimatedModel::renderMesh(unsigned int index, Shader& shader) {
-    glm::mat4 transformation = meshes.at(index).mesh.baseModelMatrix;
+    const glm::mat4 transformation = getMeshTransformation(index);
 
-    transformation = glm::translate(transformation, transform.position);
-    transformation = glm::rotate(transformation, glm::angle(transform.rotation), glm::axis(transform.rotation));
-    transformation = glm::scale(transformation, transform.scale);
+    const Mesh& sharedMesh = resource->meshes.at(index).mesh;
+    const bool depthOnly   = Shader::isDepthTask();
 
-    glBindVertexArray(meshes.at(index).mesh.vertexArrayObject); //Bind VAO
+    //The depth passes only read the positions and skinning streams, and don't need the materials.
+    glBindVertexArray(depthOnly ? sharedMesh.depthVertexArrayObject : sharedMesh.vertexArrayObject); //Bind VAO
 
     glUniformMatrix4fv(
         Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::ModelMatrix),
@@ -561,29 +648,54 @@ void _3DM::AnimatedModel::renderMesh(unsigned int index, Shader& shader) {
         GL_FALSE,
         glm::value_ptr(transformation));
 
-    glUniformMatrix4fv //supply bone matricies for shader
-        (
-            Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::BoneTransformations),
-            modelsAnimation.boneTransformations.size(),
-            GL_FALSE,
-            glm::value_ptr(modelsAnimation.boneTransformations[0]));
+    //The bones themselves were uploaded once this frame into the bone palette buffer.
+    glUniform1i(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::BonePaletteOffset), bonePaletteOffset);
+
+    if (!depthOnly) {
+        bindTextures(index, shader);
+    }
+
+    glDrawElements(GL_TRIANGLES, sharedMesh.amountOfIndices, sharedMesh.indexType, 0); //Draw the mesh
+
+    glBindVertexArray(0);
+}
+
+void _3DM::AnimatedModel::renderMeshInstanced(unsigned int index, Shader& shader, GLuint instanceBuffer, GLintptr instanceOffset, unsigned int amountOfInstances) {
+    if (index >= meshes.size()) {
+        DBG_LOG("This index goes out of bounds (_3DM::AnimatedModel::renderMeshInstanced)\n");
+        return;
+    }
+
+    const Mesh& sharedMesh = resource->meshes.at(index).mesh;
+    const bool depthOnly   = Shader::isDepthTask();
+
+    glBindVertexArray(depthOnly ? sharedMesh.depthVertexArrayObject : sharedMesh.vertexArrayObject); //Bind VAO
+
+    enableInstanceAttributes(instanceBuffer, instanceOffset);
+
+    if (!depthOnly) {
+        bindTextures(index, shader);
+    }
+
+    glDrawElementsInstanced(GL_TRIANGLES, sharedMesh.amountOfIndices, sharedMesh.indexType, 0, amountOfInstances);
 
-    for (GLuint j = 0; j < meshes.at(index).mesh.textures.size(); j++) {
+    disableInstanceAttributes();
+    glBindVertexArray(0);
+}
+
+void _3DM::AnimatedModel::bindTextures(unsigned int index, Shader& shader) {
+    for (GLuint j = 0; j < meshes.at(index).textures.size(); j++) {
 
         glActiveTexture(GL_TEXTURE0 + j); // Activate texture before binding
 
         glUniform1i(
             glGetUniformLocation(
                 shader.getProgramID(),
-                meshes.at(index).mesh.textures.at(j).uniformName.c_str()),
+                meshes.at(index).textures.at(j).uniformName.c_str()),
             j);
 
-        glBindTexture(GL_TEXTURE_2D, meshes.at(index).mesh.textures.at(j).imageID);
+        glBindTexture(GL_TEXTURE_2D, TextureLocator::getService().getTextureData(meshes.at(index).textures.at(j).texture));
     }
-
-    glDrawElements(GL_TRIANGLES, meshes.at(index).mesh.indices.size(), GL_UNSIGNED_INT, 0); //Draw the mesh
-
-    glBindVertexArray(0);
 }
 /****************************************
 *Render All meshes if they exist.		*
@@ -601,28 +713,6 @@ void _3DM::AnimatedModel::renderAll(Shader& shader) {
     }
 };
 
-void _3DM::AnimatedModel::initializeBoneBuffers(_3DM::AnimatedMesh& mesh, Shader& shader) {
-    glGenBuffers(1, &mesh.weightsBufferObject);
-    glGenBuffers(1, &mesh.boneIDsBufferObject);
-
-    bindBuffers(shader, mesh);
-}
-
-void _3DM::AnimatedModel::bindBuffers(Shader& shader, AnimatedMesh& mesh) {
-    int boneIDsAttribute = Shaders::getAttribLocation(Shaders::AttribName::BoneIDS);
-    int weightsAttribute = Shaders::getAttribLocation(Shaders::AttribName::BoneWeights);
-
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.weightsBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * mesh.weights.size(), &mesh.weights[0], GL_STATIC_DRAW);
-    glEnableVertexAttribArray(weightsAttribute);
-    glVertexAttribPointer(weightsAttribute, 4, GL_FLOAT, GL_FALSE, 0, 0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.boneIDsBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * mesh.boneIDs.size(), &mesh.boneIDs[0], GL_STATIC_DRAW);
-    glEnableVertexAttribArray(boneIDsAttribute);
-    glVertexAttribPointer(boneIDsAttribute, 4, GL_FLOAT, GL_FALSE, 0, 0);
-}
-
 void _3DM::AnimatedModel::initializeTexture(_3DM::Mesh& mesh, Shader& shader) {
 
     for (GLuint j = 0; j < mesh.textures.size(); j++) {
@@ -634,7 +724,9 @@ void _3DM::AnimatedModel::initializeTexture(_3DM::Mesh& mesh, Shader& shader) {
 
         std::stringstream stringStream;
 
-        mesh.textures.at(j).imageID = TextureLocator::getService().getTexture(mesh.textures.at(j).imagePath).getTextureData();
+        const Texture& texture = TextureLocator::getService().getTexture(mesh.textures.at(j).imagePath);
+
+        mesh.textures.at(j).texture = texture.getHandle();
 
         if (mesh.textures.at(j).imageType == TextureType::Diffuse) {
             mesh.diffuseIndex++;
@@ -663,35 +755,33 @@ void _3DM::AnimatedModel::initializeTexture(_3DM::Mesh& mesh, Shader& shader) {
         }
     }
 }
-void _3DM::AnimatedModel::initializeBuffers(_3DM::Mesh& mesh, Shader& shader) {
-    glGenVertexArrays(1, &mesh.vertexArrayObject);
 
-    glGenBuffers(1, &mesh.vertexBufferObject);
-    glGenBuffers(1, &mesh.elementBufferObject);
-    glGenBuffers(1, &mesh.uvBufferObject);
-    glGenBuffers(1, &mesh.normalBufferObject);
+//Initializes the interleaved vertex buffer and the index buffer for a mesh.
+void _3DM::AnimatedModel::initializeBuffers(_3DM::AnimatedMesh& animatedMesh, Shader& shader) {
+    Mesh& mesh = animatedMesh.mesh;
 
-    GLint positionAttribute = Shaders::getAttribLocation(Shaders::AttribName::Position);
-    GLint uvAttribute       = Shaders::getAttribLocation(Shaders::AttribName::TextureCoordinates);
-    GLint normalsAttribute  = Shaders::getAttribLocation(Shaders::AttribName::Normal);
+    std::vector<PackedAnimatedVertex> packedVertices;
+    VertexFormat::packVertices(animatedMesh, packedVertices);
 
+    glGenVertexArrays(1, &mesh.vertexArrayObject);
     glBindVertexArray(mesh.vertexArrayObject);
 
+    glGenBuffers(1, &mesh.vertexBufferObject);
     glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * mesh.vertices.size(), &mesh.vertices[0], GL_STATIC_DRAW);
-    glEnableVertexAttribArray(positionAttribute);
-    glVertexAttribPointer(positionAttribute, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(PackedAnimatedVertex) * packedVertices.size(), &packedVertices[0], GL_STATIC_DRAW);
+    VertexFormat::setAnimatedVertexAttributes();
 
+    glGenBuffers(1, &mesh.elementBufferObject);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.elementBufferObject);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * mesh.indices.size(), &mesh.indices[0], GL_STATIC_DRAW);
+    mesh.indexType       = VertexFormat::uploadIndices(mesh.indices, mesh.vertices.size());
+    mesh.amountOfIndices = mesh.indices.size();
 
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.uvBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2) * mesh.uvs.size(), &mesh.uvs[0], GL_STATIC_DRAW);
-    glEnableVertexAttribArray(uvAttribute);
-    glVertexAttribPointer(uvAttribute, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    //The depth passes read the same buffer, without the normals and uvs.
+    glGenVertexArrays(1, &mesh.depthVertexArrayObject);
+    glBindVertexArray(mesh.depthVertexArrayObject);
 
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.normalBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * mesh.normals.size(), &mesh.normals[0], GL_STATIC_DRAW);
-    glEnableVertexAttribArray(normalsAttribute);
-    glVertexAttribPointer(normalsAttribute, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBufferObject);
+    VertexFormat::setAnimatedDepthVertexAttributes();
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.elementBufferObject);
 }
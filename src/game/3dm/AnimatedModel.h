@@ -8,29 +8,31 @@
 #include "Component.h"
 #include "Locator.h"
 #include "ModelBase.h"
-#include "ModelSerialization.h"
+#include "ModelResource.h"
 #include "Shader.h"
 #include "Transform.h"
+#include "VertexFormat.h"
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 namespace _3DM {
 
-    class _3DM_IO;
-
     //!The AnimatedModel controls the lifecycle of a 3D Animated Model. This includes init, rendering, and freeing the data to render the AnimatedModel.
+    //!Models loaded from the same file share their geometry, buffers, skeleton and clips through the ModelHandler, see AnimatedModelResource.
+    //!Each AnimatedModel only holds its transform, textures, bone transformations and animation playback state.
     class AnimatedModel : public Component<AnimatedModel>, public ModelBase {
 
     public:
-        //!Keep in mind that the destructor will call glDelete on openGL objects if the Model was properly initialized.
+        //!The file is only read by the first model loaded from it.
         AnimatedModel(const std::string& path);
         ~AnimatedModel();
 
         friend void swap(_3DM::AnimatedModel& first, _3DM::AnimatedModel& second) // nothrow
         {
             using std::swap;
-            swap(first.modelsAnimation, second.modelsAnimation);
+            swap(first.resourceHandle, second.resourceHandle);
+            swap(first.resource, second.resource);
+            swap(first.boneTransformations, second.boneTransformations);
             swap(first.meshes, second.meshes);
-            swap(first.boneIDMap, second.boneIDMap);
             swap(first.currentAnimationClip, second.currentAnimationClip);
             swap(first.lastAnimationClip, second.lastAnimationClip);
             swap(first.timeSinceAnimationStarted, second.timeSinceAnimationStarted);
@@ -38,10 +40,11 @@ namespace _3DM {
             swap(first.currentBlendingTime, second.currentBlendingTime);
             swap(first.blendingLastFrameTime, second.blendingLastFrameTime);
             swap(first.blendinglastAnimationClip, second.blendinglastAnimationClip);
-            swap(first.animationClips, second.animationClips);
-            swap(first.rootPath, second.rootPath);
+            swap(first.filePath, second.filePath);
             swap(first.modelLoaded, second.modelLoaded);
             swap(first.initialized, second.initialized);
+            swap(first.keepGeometry, second.keepGeometry);
+            swap(first.usesGeometry, second.usesGeometry);
 
             //ModelBase
             swap(first.animatedModel, second.animatedModel);
@@ -74,6 +77,15 @@ namespace _3DM {
         //!Retrieves matrix of mesh at index.
         glm::mat4 getMeshMatrix(unsigned int index) const;
 
+        //!Retrieves the matrix used to render the mesh at index (the mesh's matrix combined with the model's transform).
+        glm::mat4 getMeshTransformation(unsigned int index) const;
+
+        //!Returns the path the model was loaded from.
+        const std::string& getFilePath() const { return filePath; }
+
+        //!Returns true if other was loaded from the same file and uses the same textures, meaning both can be drawn in one instanced draw.
+        bool canInstanceWith(const AnimatedModel& other) const;
+
         //!Retrieves the index of a mesh via mesh name.
         int getMeshIndex(const std::string& MeshName) const;
 
@@ -90,7 +102,7 @@ namespace _3DM {
         std::string getBoneName(uint32_t id) const;
 
         //!Returns amount of animations for the animated model.
-        int amountOfAnimations() const { return animationClips.size(); }
+        int amountOfAnimations() const { return resource ? resource->animationClips.size() : 0; }
 
         //!Returns the current transform of the bone.
         glm::mat4 getBoneTransformation(unsigned int boneId) const;
@@ -102,7 +114,14 @@ namespace _3DM {
         glm::mat4 getBoneTransformationWithoutOffset(const std::string& name) const;
 
         //!Returns the amount of bones in the animated model.
-        unsigned int amountOfBones() const { return modelsAnimation.boneTransformations.size(); }
+        unsigned int amountOfBones() const { return boneTransformations.size(); }
+
+        //!Returns the current transform of every bone, in the order the shaders expect them.
+        const std::vector<glm::mat4>& getBoneTransformations() const { return boneTransformations; }
+
+        //!Sets where this model's bones were placed in the bone palette buffer this frame. Must be set before rendering.
+        void setBonePaletteOffset(unsigned int offset) { bonePaletteOffset = offset; }
+        unsigned int getBonePaletteOffset() const { return bonePaletteOffset; }
 
         //!Returns the amount of meshes in the animated model.
         unsigned int amountOfMeshes() const { return meshes.size(); }
@@ -113,7 +132,15 @@ namespace _3DM {
         //!Retrieves indices of mesh at index.
         std::vector<uint32_t>* getMeshIndices(unsigned int index);
 
-        //!Sets matrix of mesh at index.
+        //!The CPU side geometry is released once it is uploaded, unless this is set before initializing.
+        //!Needed by models that collision meshes are built from after the model is initialized.
+        void setKeepGeometry(bool keep) { keepGeometry = keep; }
+        bool isKeepingGeometry() const { return keepGeometry; }
+
+        //!Tells the shared geometry this model is done with it. It is freed once every model loaded from the same file is.
+        void releaseGeometry();
+
+        //!Sets matrix of mesh at index. Only changes this model's matrix, not the matrix of every model loaded from the same file.
         void setMeshMatrix(unsigned int index, const glm::mat4& newMatrix);
 
         //!Sets matrix of a bone at index.
@@ -122,7 +149,7 @@ namespace _3DM {
         //!Sets the current animation clip to be ran.
         void setAnimationClip(unsigned int clip);
 
-        //!Used to add a texture manually to a mesh.
+        //!Used to add a texture manually to a mesh. Only this model uses the texture.
         void addTexture(const Texture& texture, unsigned int meshIndex, const _3DM::TextureType& type);
 
         //!Updates the animation a single frame.
@@ -134,6 +161,12 @@ namespace _3DM {
         //!Renders a mesh at index.
         void renderSingleMesh(unsigned int index, Shader& shader);
 
+        //!Renders amountOfInstances copies of the mesh at index. instanceBuffer must hold one model matrix per instance, starting at
+        //!instanceOffset, and the bone palettes of every instance must already be bound.
+        void renderMeshInstanced(unsigned int index, Shader& shader, GLuint instanceBuffer, GLintptr instanceOffset, unsigned int amountOfInstances);
+
+        //!The keyframes are shared, editing them changes the animation of every model loaded from the same file.
+
         //!Removes a channel via it's index.
         void removeKeyframes(unsigned int channelIndex);
 
@@ -205,8 +238,8 @@ namespace _3DM {
             }
         }
 
-        //!Initializes the buffers for a mesh.
-        void initializeBuffers(Mesh& mesh, Shader& shader);
+        //!Initializes the interleaved vertex buffer and the index buffer for a mesh.
+        void initializeBuffers(AnimatedMesh& animatedMesh, Shader& shader);
 
         //!Initializes the textures for a mesh.
         void initializeTexture(Mesh& mesh, Shader& shader);
@@ -214,8 +247,8 @@ namespace _3DM {
         //!Renders a mesh at index.
         void renderMesh(unsigned int index, Shader& shader);
 
-        //!Initializes the bone buffers for a mesh.
-        void initializeBoneBuffers(AnimatedMesh& mesh, Shader& shader);
+        //!Binds the textures of the mesh at index.
+        void bindTextures(unsigned int index, Shader& shader);
 
         //!This function will recursively update the bonetree according to the time given. it will also interpolate properly between each keyframe.
         void updateBoneTree(const float& timeInTicks, BoneNode* node, const glm::mat4& parentTransform);
@@ -223,17 +256,16 @@ namespace _3DM {
         //!This function will recursively blend the bonetree according to the time given. it will also interpolate properly between each keyframe.
         void blendBoneTree(const float& lastAnimationTime, _3DM::BoneNode* node, const glm::mat4& parentTransform);
 
-        //!Bind's buffers before rendering
-        void bindBuffers(Shader& shader, AnimatedMesh& mesh);
+        AnimatedModelHandle resourceHandle;
 
-        //!The animation of the model
-        Animation modelsAnimation;
+        //!The geometry, buffers, skeleton, keyframes and clips every model loaded from the same file shares.
+        AnimatedModelResource* resource = nullptr;
 
-        //!The meshes of the model
-        std::vector<AnimatedMesh> meshes;
+        //!The bone transformations that are uploaded to the vertex shader.
+        std::vector<glm::mat4> boneTransformations;
 
-        //!The boneId's mapped to the bone name
-        std::map<std::string, uint32_t> boneIDMap;
+        //!This model's copy of each mesh's textures and matrix. The geometry and buffers are in resource.
+        std::vector<Mesh> meshes;
 
         uint16_t currentAnimationClip      = 0;
         uint16_t lastAnimationClip         = 0;
@@ -243,15 +275,18 @@ namespace _3DM {
         float blendingLastFrameTime        = 0;
         uint16_t blendinglastAnimationClip = 0;
 
-        //!Animation clips for the AnimatedModel
-        std::vector<AnimationClip> animationClips;
+        std::string filePath;
+        bool modelLoaded  = false;
+        bool initialized  = false;
+        bool keepGeometry = false;
+
+        //!True until releaseGeometry, while this model counts as one of the resource's geometryUsers.
+        bool usesGeometry = false;
 
-        std::string rootPath;
-        bool modelLoaded = false;
-        bool initialized = false;
+        //!Offset (in bones) of this model's palette in the bone palette buffer.
+        unsigned int bonePaletteOffset = 0;
 
         AnimatedModel() {}
-        friend class _3DM::_3DM_IO;
     };
 
 };
@@ -2,7 +2,9 @@
 #define MESH_H
 
 #include "ModelTexture.h"
+#include <GL/glew.h>
 #include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
 #include <vector>
 namespace _3DM {
 struct ModelTexture;
@@ -17,13 +19,24 @@ struct Mesh {
 
     glm::mat4 baseModelMatrix;
 
+    //Local space bounds of the vertices, calculated when the model is loaded.
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+
     std::string name;
 
-    uint32_t vertexArrayObject;
-    uint32_t vertexBufferObject;
-    uint32_t elementBufferObject;
-    uint32_t uvBufferObject;
-    uint32_t normalBufferObject;
+    uint32_t vertexArrayObject   = 0;
+    uint32_t vertexBufferObject  = 0;
+    uint32_t elementBufferObject = 0;
+
+    //Used by the depth passes. Static meshes read a buffer of positions alone, animated meshes
+    //read the positions and skinning streams of vertexBufferObject, so they have no positionBufferObject.
+    uint32_t depthVertexArrayObject = 0;
+    uint32_t positionBufferObject   = 0;
+
+    //Kept so the mesh can still be drawn once the CPU side indices are released.
+    uint32_t amountOfIndices = 0;
+    uint32_t indexType       = GL_UNSIGNED_INT;
 
     unsigned short diffuseIndex  = 0;
     unsigned short specularIndex = 0;
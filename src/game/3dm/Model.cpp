@@ -1,13 +1,24 @@
 #include "Model.h"
 
 _3DM::Model::Model(const std::string& path) {
-    _3DM_IO modelLoader;
-    *this = modelLoader.readModel(path);
+    ModelHandler& models = ModelLocator::getService();
 
-    if (!modelLoaded) {
-        printf("Please load in a model before initializing buffers. ( _3DM::Model::initialize() )\n");
+    resourceHandle = models.getModel(path);
+    resource       = models.getResource(resourceHandle);
+    filePath       = path;
+
+    if (!resource) {
+        DBG_LOG("The model %s could not be loaded (_3DM::Model::Model)\n", path.c_str());
         return;
     }
+
+    for (unsigned int i = 0; i < resource->meshes.size(); i++) {
+        meshes.push_back(copyMeshInstance(resource->meshes[i]));
+    }
+
+    resource->geometryUsers++;
+    usesGeometry = true;
+    modelLoaded  = true;
 }
 
 void _3DM::Model::addTexture(const Texture& texture, unsigned int meshIndex, const _3DM::TextureType& type) {
@@ -20,7 +31,7 @@ void _3DM::Model::addTexture(const Texture& texture, unsigned int meshIndex, con
     std::stringstream stringStream;
 
     ModelTexture modelTexture;
-    modelTexture.imageID   = texture.getTextureData();
+    modelTexture.texture   = texture.getHandle();
     modelTexture.imagePath = texture.getLocation();
     modelTexture.imageType = type;
 
@@ -78,7 +89,9 @@ void _3DM::Model::initializeTexture(_3DM::Mesh& mesh, Shader& shader) {
 
         std::stringstream stringStream;
 
-        mesh.textures.at(j).imageID = TextureLocator::getService().getTexture(mesh.textures.at(j).imagePath).getTextureData();
+        const Texture& texture = TextureLocator::getService().getTexture(mesh.textures.at(j).imagePath);
+
+        mesh.textures.at(j).texture = texture.getHandle();
 
         if (mesh.textures.at(j).imageType == TextureType::Diffuse) {
             mesh.diffuseIndex++;
@@ -109,37 +122,35 @@ void _3DM::Model::initializeTexture(_3DM::Mesh& mesh, Shader& shader) {
     }
 }
 
-//!Initializes the buffers for a mesh.
+//!Initializes the buffers for a mesh. The vertices are interleaved and packed (see VertexFormat).
 void _3DM::Model::initializeBuffers(_3DM::Mesh& mesh, Shader& shader) {
 
-    GLint uvAttribute       = Shaders::getAttribLocation(Shaders::AttribName::TextureCoordinates);
-    GLint positionAttribute = Shaders::getAttribLocation(Shaders::AttribName::Position);
-    GLint normalsAttribute  = Shaders::getAttribLocation(Shaders::AttribName::Normal);
+    std::vector<PackedVertex> packedVertices;
+    VertexFormat::packVertices(mesh, packedVertices);
 
     glGenVertexArrays(1, &mesh.vertexArrayObject);
     glBindVertexArray(mesh.vertexArrayObject);
 
     glGenBuffers(1, &mesh.vertexBufferObject);
     glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * mesh.vertices.size(), &mesh.vertices[0], GL_STATIC_DRAW);
-    glEnableVertexAttribArray(positionAttribute);
-    glVertexAttribPointer(positionAttribute, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex) * packedVertices.size(), &packedVertices[0], GL_STATIC_DRAW);
+    VertexFormat::setVertexAttributes();
 
     glGenBuffers(1, &mesh.elementBufferObject);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.elementBufferObject);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * mesh.indices.size(), &mesh.indices[0], GL_STATIC_DRAW);
-
-    glGenBuffers(1, &mesh.uvBufferObject);
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.uvBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2) * mesh.uvs.size(), &mesh.uvs[0], GL_STATIC_DRAW);
-    glEnableVertexAttribArray(uvAttribute);
-    glVertexAttribPointer(uvAttribute, 2, GL_FLOAT, GL_FALSE, 0, 0);
-
-    glGenBuffers(1, &mesh.normalBufferObject);
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.normalBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * mesh.normals.size(), &mesh.normals[0], GL_STATIC_DRAW);
-    glEnableVertexAttribArray(normalsAttribute);
-    glVertexAttribPointer(normalsAttribute, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    mesh.indexType       = VertexFormat::uploadIndices(mesh.indices, mesh.vertices.size());
+    mesh.amountOfIndices = mesh.indices.size();
+
+    //The depth passes fetch 12 bytes per vertex instead of the whole packed vertex. The index buffer is shared.
+    glGenVertexArrays(1, &mesh.depthVertexArrayObject);
+    glBindVertexArray(mesh.depthVertexArrayObject);
+
+    glGenBuffers(1, &mesh.positionBufferObject);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.positionBufferObject);
+    VertexFormat::uploadPositions(mesh.vertices);
+    VertexFormat::setDepthVertexAttributes();
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.elementBufferObject);
 }
 
 //!Initializes the model. Should be called before rendering.
@@ -150,35 +161,69 @@ void _3DM::Model::initialize(Shader& shader) {
         return;
     }
 
+    //Every model sharing the geometry may have released it already.
+    if (staticGeometry || keepGeometry || !resource->uploaded) {
+        ModelLocator::getService().reloadGeometry(resourceHandle);
+    }
+
     // loop through each mesh and initialize them
     for (unsigned int i = 0; i < meshes.size(); i++) {
-
         initializeTexture(meshes[i], shader);
-        initializeBuffers(meshes[i], shader);
+    }
+
+    //Static models are uploaded by the StaticGeometryBatcher, which still needs the CPU side geometry.
+    //The buffers are shared, so they are only generated by the first model loaded from the file.
+    if (!staticGeometry && !resource->uploaded) {
+        for (unsigned int i = 0; i < resource->meshes.size(); i++) {
+            initializeBuffers(resource->meshes[i], shader);
+        }
+
+        resource->uploaded = true;
     }
 
     glBindVertexArray(0);
     animatedModel = false;
     initialized   = true;
+
+    if (!staticGeometry && !keepGeometry) {
+        releaseGeometry();
+    }
 }
 
-_3DM::Model::~Model() {
-    if (!initialized) {
-        //If the object is not initialized then no buffers were generated.
+//!Frees the CPU side vertices, normals, uvs and indices of every mesh, once no model sharing them needs them.
+void _3DM::Model::releaseGeometry() {
+    if (!usesGeometry) {
         return;
     }
 
-    DBG_LOG("Freeing memory for model.\n");
+    usesGeometry = false;
+    resource->geometryUsers--;
+
+    if (resource->geometryUsers > 0) {
+        return;
+    }
 
+    for (unsigned int i = 0; i < resource->meshes.size(); i++) {
+        VertexFormat::releaseGeometry(resource->meshes[i]);
+    }
+
+    resource->hasGeometry = false;
+}
+
+_3DM::Model::~Model() {
     for (unsigned int i = 0; i < meshes.size(); i++) {
-        Mesh& mesh = meshes.at(i);
+        for (unsigned int j = 0; j < meshes[i].textures.size(); j++) {
+            TextureLocator::getService().releaseTexture(meshes[i].textures[j].texture);
+        }
+    }
 
-        glDeleteVertexArrays(1, &mesh.vertexArrayObject);
-        glDeleteBuffers(1, &mesh.vertexBufferObject);
-        glDeleteBuffers(1, &mesh.elementBufferObject);
-        glDeleteBuffers(1, &mesh.uvBufferObject);
-        glDeleteBuffers(1, &mesh.normalBufferObject);
+    if (!resource) {
+        return;
     }
+
+    //The buffers are deleted with the resource, once no model uses it.
+    releaseGeometry();
+    ModelLocator::getService().releaseModel(resourceHandle);
 }
 
 //!Renders all meshes in model.
@@ -212,10 +257,37 @@ void _3DM::Model::setMeshMatrix(unsigned int index, const glm::mat4& newMatrix)
     }
 }
 
+//!Retrieves the matrix used to render the mesh at index.
+glm::mat4 _3DM::Model::getMeshTransformation(unsigned int index) const {
+    if (index >= meshes.size()) {
+        DBG_LOG("Index went out of bounds (_3DM::Model::getMeshTransformation)\n");
+        return glm::mat4(1.0f);
+    }
+
+    glm::mat4 transformation = meshes.at(index).baseModelMatrix;
+
+    transformation = glm::translate(transformation, transform.position);
+    transformation = glm::rotate(transformation, glm::angle(transform.rotation), glm::axis(transform.rotation));
+    transformation = glm::scale(transformation, transform.scale);
+
+    return transformation;
+}
+
+//!Retrieves the local space bounds of the mesh at index.
+bool _3DM::Model::getMeshBounds(unsigned int index, glm::vec3& boundsMin, glm::vec3& boundsMax) const {
+    if (index >= meshes.size()) {
+        return false;
+    }
+
+    boundsMin = meshes.at(index).boundsMin;
+    boundsMax = meshes.at(index).boundsMax;
+    return true;
+}
+
 //!Retrieves vertices of mesh at index.
 std::vector<glm::vec3>* _3DM::Model::getMeshVertices(unsigned int index) {
     if (index < meshes.size()) {
-        return &meshes.at(index).vertices;
+        return &resource->meshes.at(index).vertices;
     }
 
     return nullptr;
@@ -224,22 +296,47 @@ std::vector<glm::vec3>* _3DM::Model::getMeshVertices(unsigned int index) {
 //Retrieves indices of mesh at index.
 std::vector<uint32_t>* _3DM::Model::getMeshIndices(unsigned int index) {
     if (index < meshes.size()) {
-        return &meshes.at(index).indices;
+        return &resource->meshes.at(index).indices;
     }
 
     return nullptr;
 }
 
-//Renders a mesh at index.
-void _3DM::Model::renderMesh(unsigned int index, Shader& shader) {
+//Retrieves normals of mesh at index.
+std::vector<glm::vec3>* _3DM::Model::getMeshNormals(unsigned int index) {
+    if (index < meshes.size()) {
+        return &resource->meshes.at(index).normals;
+    }
 
-    glBindVertexArray(meshes.at(index).vertexArrayObject); //Bind VAO
+    return nullptr;
+}
 
-    glm::mat4 transformation = meshes.at(index).baseModelMatrix;
+//Retrieves uvs of mesh at index.
+std::vector<glm::vec2>* _3DM::Model::getMeshUVs(unsigned int index) {
+    if (index < meshes.size()) {
+        return &resource->meshes.at(index).uvs;
+    }
 
-    transformation = glm::translate(transformation, transform.position);
-    transformation = glm::rotate(transformation, glm::angle(transform.rotation), glm::axis(transform.rotation));
-    transformation = glm::scale(transformation, transform.scale);
+    return nullptr;
+}
+
+//Retrieves textures of mesh at index.
+std::vector<_3DM::ModelTexture>* _3DM::Model::getMeshTextures(unsigned int index) {
+    if (index < meshes.size()) {
+        return &meshes.at(index).textures;
+    }
+
+    return nullptr;
+}
+
+//Renders a mesh at index. Depth passes only get the positions and the matrix.
+void _3DM::Model::renderMesh(unsigned int index, Shader& shader) {
+    const Mesh& sharedMesh = resource->meshes.at(index);
+    const bool depthOnly   = Shader::isDepthTask();
+
+    glBindVertexArray(depthOnly ? sharedMesh.depthVertexArrayObject : sharedMesh.vertexArrayObject); //Bind VAO
+
+    const glm::mat4 transformation = getMeshTransformation(index);
 
     glUniformMatrix4fv(
         Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::ModelMatrix),
@@ -247,6 +344,41 @@ void _3DM::Model::renderMesh(unsigned int index, Shader& shader) {
         GL_FALSE,
         glm::value_ptr(transformation));
 
+    if (!depthOnly) {
+        bindTextures(index, shader);
+    }
+
+    glDrawElements(GL_TRIANGLES, sharedMesh.amountOfIndices, sharedMesh.indexType, 0); //Draw the mesh
+
+    glBindVertexArray(0);
+}
+
+//Renders amountOfInstances copies of the mesh at index.
+void _3DM::Model::renderMeshInstanced(unsigned int index, Shader& shader, GLuint instanceBuffer, GLintptr instanceOffset, unsigned int amountOfInstances) {
+    if (index >= meshes.size()) {
+        DBG_LOG("This index goes out of bounds (_3DM::Model::renderMeshInstanced)\n");
+        return;
+    }
+
+    const Mesh& sharedMesh = resource->meshes.at(index);
+    const bool depthOnly   = Shader::isDepthTask();
+
+    glBindVertexArray(depthOnly ? sharedMesh.depthVertexArrayObject : sharedMesh.vertexArrayObject); //Bind VAO
+
+    enableInstanceAttributes(instanceBuffer, instanceOffset);
+
+    if (!depthOnly) {
+        bindTextures(index, shader);
+    }
+
+    glDrawElementsInstanced(GL_TRIANGLES, sharedMesh.amountOfIndices, sharedMesh.indexType, 0, amountOfInstances);
+
+    disableInstanceAttributes();
+    glBindVertexArray(0);
+}
+
+//Binds the textures of the mesh at index.
+void _3DM::Model::bindTextures(unsigned int index, Shader& shader) {
     for (GLuint j = 0; j < meshes.at(index).textures.size(); j++) {
 
         glActiveTexture(GL_TEXTURE0 + j); // Activate proper texture unit before binding
@@ -257,10 +389,30 @@ void _3DM::Model::renderMesh(unsigned int index, Shader& shader) {
                 meshes.at(index).textures.at(j).uniformName.c_str()),
             j);
 
-        glBindTexture(GL_TEXTURE_2D, meshes.at(index).textures.at(j).imageID);
+        glBindTexture(GL_TEXTURE_2D, TextureLocator::getService().getTextureData(meshes.at(index).textures.at(j).texture));
     }
+}
 
-    glDrawElements(GL_TRIANGLES, meshes.at(index).indices.size(), GL_UNSIGNED_INT, 0); //Draw the mesh
+//Returns true if other was loaded from the same file and uses the same textures.
+bool _3DM::Model::canInstanceWith(const Model& other) const {
+    if (filePath != other.filePath || meshes.size() != other.meshes.size()) {
+        return false;
+    }
 
-    glBindVertexArray(0);
+    for (unsigned int i = 0; i < meshes.size(); i++) {
+        const std::vector<ModelTexture>& textures      = meshes[i].textures;
+        const std::vector<ModelTexture>& otherTextures = other.meshes[i].textures;
+
+        if (textures.size() != otherTextures.size()) {
+            return false;
+        }
+
+        for (unsigned int j = 0; j < textures.size(); j++) {
+            if (textures[j].texture != otherTextures[j].texture || textures[j].uniformName != otherTextures[j].uniformName) {
+                return false;
+            }
+        }
+    }
+
+    return true;
 }
@@ -6,29 +6,35 @@
 #include "Locator.h"
 #include "Mesh.h"
 #include "ModelBase.h"
-#include "ModelSerialization.h"
+#include "ModelResource.h"
 #include "Shader.h"
 #include "Transform.h"
+#include "VertexFormat.h"
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
 namespace _3DM {
-    class _3DM_IO;
 
     //!The Model controls the lifecycle of a 3D Model. This includes init, rendering, and freeing the data to render the Model.
+    //!Models loaded from the same file share their geometry and buffers through the ModelHandler, see ModelResource.
     class Model : public Component<Model>, public ModelBase {
     public:
-        //!Keep in mind that the destructor will call glDelete on openGL objects if the Model was properly initialized.
+        //!The file is only read by the first model loaded from it.
         Model(const std::string& path);
         ~Model();
 
         friend void swap(_3DM::Model& first, _3DM::Model& second) // nothrow
         {
             using std::swap;
-            swap(first.rootPath, second.rootPath);
+            swap(first.filePath, second.filePath);
             swap(first.modelLoaded, second.modelLoaded);
             swap(first.initialized, second.initialized);
+            swap(first.staticGeometry, second.staticGeometry);
+            swap(first.keepGeometry, second.keepGeometry);
+            swap(first.usesGeometry, second.usesGeometry);
             swap(first.meshes, second.meshes);
+            swap(first.resourceHandle, second.resourceHandle);
+            swap(first.resource, second.resource);
 
             //ModelBase
             swap(first.animatedModel, second.animatedModel);
@@ -56,7 +62,7 @@ namespace _3DM {
             return *this;
         }
 
-        //! Used to add a texture manually to a mesh.
+        //! Used to add a texture manually to a mesh. Only this model uses the texture, not every model loaded from the same file.
         void addTexture(const Texture& texture, unsigned int meshIndex, const _3DM::TextureType& type);
         void renderSingleMesh(unsigned int index, Shader& shader);
         int getMeshIndex(const std::string& MeshName) const;
@@ -64,25 +70,70 @@ namespace _3DM {
         void renderAll(Shader& shader);
         void renderMesh(unsigned int index, Shader& shader);
         glm::mat4 getMeshMatrix(unsigned int index) const;
+        //!Only changes this model's matrix, not the matrix of every model loaded from the same file.
         void setMeshMatrix(unsigned int index, const glm::mat4& newMatrix);
+
+        //!Retrieves the matrix used to render the mesh at index (the mesh's matrix combined with the model's transform).
+        glm::mat4 getMeshTransformation(unsigned int index) const;
+
+        //!Retrieves the local space bounds of the mesh at index. Returns false if the index is out of bounds.
+        bool getMeshBounds(unsigned int index, glm::vec3& boundsMin, glm::vec3& boundsMax) const;
         unsigned int amountOfMeshes() { return meshes.size(); }
 
         std::vector<glm::vec3>* getMeshVertices(unsigned int index);
 
         std::vector<uint32_t>* getMeshIndices(unsigned int index);
 
+        std::vector<glm::vec3>* getMeshNormals(unsigned int index);
+
+        std::vector<glm::vec2>* getMeshUVs(unsigned int index);
+
+        std::vector<ModelTexture>* getMeshTextures(unsigned int index);
+
+        //!Static models are merged into the StaticGeometryBatcher when the scene loads and are not rendered on their own.
+        //!Their transform and mesh matrices should not change after the scene loads.
+        void setStatic(bool isStatic) { staticGeometry = isStatic; }
+        bool isStatic() const { return staticGeometry; }
+
+        //!The CPU side geometry is released once it is uploaded, unless this is set before initializing.
+        //!Needed by models that collision meshes or occluders are built from after the model is initialized.
+        void setKeepGeometry(bool keep) { keepGeometry = keep; }
+        bool isKeepingGeometry() const { return keepGeometry; }
+
+        //!Tells the shared geometry this model is done with it. It is freed once every model loaded from the same file is.
+        //!Bounds are kept, so occlusion culling still works.
+        void releaseGeometry();
+
+        //!Returns the path the model was loaded from.
+        const std::string& getFilePath() const { return filePath; }
+
+        //!Returns true if other was loaded from the same file and uses the same textures, meaning both can be drawn in one instanced draw.
+        bool canInstanceWith(const Model& other) const;
+
+        //!Renders amountOfInstances copies of the mesh at index. instanceBuffer must hold one model matrix per instance, starting at instanceOffset.
+        void renderMeshInstanced(unsigned int index, Shader& shader, GLuint instanceBuffer, GLintptr instanceOffset, unsigned int amountOfInstances);
+
     private:
         Model() {}
+
+        //!This model's copy of each mesh's textures and matrix. The geometry and buffers are in resource.
         std::vector<Mesh> meshes;
 
         void initializeBuffers(_3DM::Mesh& mesh, Shader& shader);
         void initializeTexture(_3DM::Mesh& mesh, Shader& shader);
+        void bindTextures(unsigned int index, Shader& shader);
+
+        ModelHandle resourceHandle;
+        ModelResource* resource = nullptr;
 
-        std::string rootPath;
-        bool modelLoaded = false;
-        bool initialized = false;
+        std::string filePath;
+        bool modelLoaded    = false;
+        bool initialized    = false;
+        bool staticGeometry = false;
+        bool keepGeometry   = false;
 
-        friend class _3DM::_3DM_IO;
+        //!True until releaseGeometry, while this model counts as one of the resource's geometryUsers.
+        bool usesGeometry = false;
     };
 }
 
@@ -1,6 +1,7 @@
 #ifndef MODEL_INTERFACE_H
 #define MODEL_INTERFACE_H
 
+#include "Shaders.h"
 #include "Transform.h"
 
 class ModelBase {
@@ -16,6 +17,29 @@ public:
 
 protected:
     bool animatedModel = false;
+
+    //!Points the instance model matrix attribute of the bound vertex array object at the matrices starting at instanceOffset
+    //!in instanceBuffer (one mat4 per instance).
+    static void enableInstanceAttributes(GLuint instanceBuffer, GLintptr instanceOffset) {
+        const GLint location = Shaders::getAttribLocation(Shaders::AttribName::InstanceModelMatrix);
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+        for (GLint i = 0; i < 4; i++) {
+            glEnableVertexAttribArray(location + i);
+            glVertexAttribPointer(location + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), reinterpret_cast<void*>(instanceOffset + sizeof(glm::vec4) * i));
+            glVertexAttribDivisor(location + i, 1);
+        }
+    }
+
+    //!Disables the instance model matrix attribute of the bound vertex array object.
+    static void disableInstanceAttributes() {
+        const GLint location = Shaders::getAttribLocation(Shaders::AttribName::InstanceModelMatrix);
+
+        for (GLint i = 0; i < 4; i++) {
+            glDisableVertexAttribArray(location + i);
+        }
+    }
 };
 
 #endif
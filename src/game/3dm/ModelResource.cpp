@@ -0,0 +1,179 @@
+#include "ModelResource.h"
+#include "ModelSerialization.h"
+
+namespace {
+    //!Calculates the local space bounds of a mesh's vertices.
+    void calculateBounds(_3DM::Mesh& mesh) {
+        if (mesh.vertices.empty()) {
+            mesh.boundsMin = glm::vec3(0);
+            mesh.boundsMax = glm::vec3(0);
+            return;
+        }
+
+        mesh.boundsMin = mesh.vertices[0];
+        mesh.boundsMax = mesh.vertices[0];
+
+        for (unsigned int i = 1; i < mesh.vertices.size(); i++) {
+            mesh.boundsMin = glm::min(mesh.boundsMin, mesh.vertices[i]);
+            mesh.boundsMax = glm::max(mesh.boundsMax, mesh.vertices[i]);
+        }
+    }
+
+    void deleteBuffers(_3DM::Mesh& mesh) {
+        glDeleteVertexArrays(1, &mesh.vertexArrayObject);
+        glDeleteVertexArrays(1, &mesh.depthVertexArrayObject);
+        glDeleteBuffers(1, &mesh.vertexBufferObject);
+        glDeleteBuffers(1, &mesh.positionBufferObject);
+        glDeleteBuffers(1, &mesh.elementBufferObject);
+    }
+}
+
+_3DM::ModelResource::~ModelResource() {
+    if (!uploaded) {
+        //If the model was never uploaded then no buffers were generated.
+        return;
+    }
+
+    DBG_LOG("Freeing memory for model.\n");
+
+    for (unsigned int i = 0; i < meshes.size(); i++) {
+        deleteBuffers(meshes[i]);
+    }
+}
+
+_3DM::AnimatedModelResource::~AnimatedModelResource() {
+    if (!uploaded) {
+        return;
+    }
+
+    DBG_LOG("Freeing memory for animated model.\n");
+
+    for (unsigned int i = 0; i < meshes.size(); i++) {
+        deleteBuffers(meshes[i].mesh);
+    }
+}
+
+_3DM::Mesh _3DM::copyMeshInstance(const Mesh& sharedMesh) {
+    Mesh instance;
+
+    instance.textures        = sharedMesh.textures;
+    instance.baseModelMatrix = sharedMesh.baseModelMatrix;
+    instance.boundsMin       = sharedMesh.boundsMin;
+    instance.boundsMax       = sharedMesh.boundsMax;
+    instance.name            = sharedMesh.name;
+    instance.diffuseIndex    = sharedMesh.diffuseIndex;
+    instance.specularIndex   = sharedMesh.specularIndex;
+    instance.normalsIndex    = sharedMesh.normalsIndex;
+
+    return instance;
+}
+
+ModelHandle ModelHandler::getModel(const std::string& filePath) {
+    ModelHandle handle = models.find(filePath);
+
+    if (!handle.isValid()) {
+        _3DM::ModelResource* model = new _3DM::ModelResource();
+
+        _3DM::_3DM_IO modelLoader;
+        modelLoader.readModel(filePath, *model);
+
+        for (unsigned int i = 0; i < model->meshes.size(); i++) {
+            calculateBounds(model->meshes[i]);
+        }
+
+        handle = models.add(filePath, model);
+    }
+
+    models.acquire(handle);
+
+    return handle;
+}
+
+AnimatedModelHandle ModelHandler::getAnimatedModel(const std::string& filePath) {
+    AnimatedModelHandle handle = animatedModels.find(filePath);
+
+    if (!handle.isValid()) {
+        _3DM::AnimatedModelResource* model = new _3DM::AnimatedModelResource();
+
+        _3DM::_3DM_IO modelLoader;
+        modelLoader.readAnimatedModel(filePath, *model);
+
+        handle = animatedModels.add(filePath, model);
+    }
+
+    animatedModels.acquire(handle);
+
+    return handle;
+}
+
+//The buffers and bounds are kept, only the geometry is swapped in.
+void ModelHandler::reloadGeometry(ModelHandle handle) {
+    _3DM::ModelResource* model = models.get(handle);
+
+    if (!model || model->hasGeometry) {
+        return;
+    }
+
+    _3DM::ModelResource reloaded;
+
+    _3DM::_3DM_IO modelLoader;
+    modelLoader.readModel(models.getPath(handle), reloaded);
+
+    if (reloaded.meshes.size() != model->meshes.size()) {
+        DBG_LOG("%s changed since it was loaded, its geometry can't be reloaded (ModelResource.cpp reloadGeometry)\n", models.getPath(handle).c_str());
+        return;
+    }
+
+    for (unsigned int i = 0; i < model->meshes.size(); i++) {
+        model->meshes[i].vertices.swap(reloaded.meshes[i].vertices);
+        model->meshes[i].normals.swap(reloaded.meshes[i].normals);
+        model->meshes[i].uvs.swap(reloaded.meshes[i].uvs);
+        model->meshes[i].indices.swap(reloaded.meshes[i].indices);
+    }
+
+    model->hasGeometry = true;
+}
+
+void ModelHandler::reloadGeometry(AnimatedModelHandle handle) {
+    _3DM::AnimatedModelResource* model = animatedModels.get(handle);
+
+    if (!model || model->hasGeometry) {
+        return;
+    }
+
+    _3DM::AnimatedModelResource reloaded;
+
+    _3DM::_3DM_IO modelLoader;
+    modelLoader.readAnimatedModel(animatedModels.getPath(handle), reloaded);
+
+    if (reloaded.meshes.size() != model->meshes.size()) {
+        DBG_LOG("%s changed since it was loaded, its geometry can't be reloaded (ModelResource.cpp reloadGeometry)\n", animatedModels.getPath(handle).c_str());
+        return;
+    }
+
+    for (unsigned int i = 0; i < model->meshes.size(); i++) {
+        _3DM::Mesh& mesh         = model->meshes[i].mesh;
+        _3DM::Mesh& reloadedMesh = reloaded.meshes[i].mesh;
+
+        mesh.vertices.swap(reloadedMesh.vertices);
+        mesh.normals.swap(reloadedMesh.normals);
+        mesh.uvs.swap(reloadedMesh.uvs);
+        mesh.indices.swap(reloadedMesh.indices);
+
+        model->meshes[i].weights.swap(reloaded.meshes[i].weights);
+        model->meshes[i].boneIDs.swap(reloaded.meshes[i].boneIDs);
+    }
+
+    model->hasGeometry = true;
+}
+
+void ModelHandler::freeUnreferencedModels() {
+    models.freeUnreferenced();
+    animatedModels.freeUnreferenced();
+}
+
+ModelHandler::~ModelHandler() {
+    DBG_LOG("Freeing memory for models.\n");
+    models.clear();
+    animatedModels.clear();
+}
@@ -0,0 +1,110 @@
+#ifndef MODEL_RESOURCE_H
+#define MODEL_RESOURCE_H
+
+#include "AnimatedMesh.h"
+#include "AssetRegistry.h"
+#include "Mesh.h"
+#include "SkeletalSystem.h"
+#include <GL/glew.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace _3DM {
+
+    /*!What every Model loaded from the same .3DM file shares: the meshes' geometry and their buffers.
+
+    The geometry is kept while any model could still need it, see geometryUsers. The buffers are deleted with the resource.
+    */
+    struct ModelResource {
+        ModelResource() {}
+        ~ModelResource();
+
+        ModelResource(const ModelResource&) = delete;
+        ModelResource(ModelResource&&)      = delete;
+        ModelResource& operator=(const ModelResource&) = delete;
+        ModelResource& operator=(ModelResource&&) = delete;
+
+        std::vector<Mesh> meshes;
+        std::string rootPath;
+
+        //!True once the buffers were generated, by the first model initialized that isn't static.
+        bool uploaded = false;
+
+        //!False once the CPU side geometry was released, ModelHandler::reloadGeometry reads it again.
+        bool hasGeometry = true;
+
+        //!Models that may still need the CPU side geometry. It is released when the last one is done with it.
+        unsigned int geometryUsers = 0;
+    };
+
+    /*!What every AnimatedModel loaded from the same .3DMA file shares: the geometry and buffers, the skeleton, the keyframes and the clips.
+    Only the bone transformations and the animation's playback state belong to each AnimatedModel.
+    */
+    struct AnimatedModelResource {
+        AnimatedModelResource() {}
+        ~AnimatedModelResource();
+
+        AnimatedModelResource(const AnimatedModelResource&) = delete;
+        AnimatedModelResource(AnimatedModelResource&&)      = delete;
+        AnimatedModelResource& operator=(const AnimatedModelResource&) = delete;
+        AnimatedModelResource& operator=(AnimatedModelResource&&) = delete;
+
+        //!The bone transformations stored in the file are the bind pose every AnimatedModel starts from.
+        Animation animation;
+        std::vector<AnimatedMesh> meshes;
+        std::map<std::string, uint32_t> boneIDMap;
+        std::vector<AnimationClip> animationClips;
+        std::string rootPath;
+
+        bool uploaded              = false;
+        bool hasGeometry           = true;
+        unsigned int geometryUsers = 0;
+    };
+
+    //!Returns a copy of what a model may change about a shared mesh: its textures, matrix and name. The geometry and buffers aren't copied.
+    Mesh copyMeshInstance(const Mesh& sharedMesh);
+};
+
+typedef AssetHandle<_3DM::ModelResource> ModelHandle;
+typedef AssetHandle<_3DM::AnimatedModelResource> AnimatedModelHandle;
+
+//The ModelHandler class loads every .3DM and .3DMA file once, no matter how many models are loaded from it.
+//It should be handled by the ModelLocator class.
+class ModelHandler {
+public:
+    //Reads the file the first time it is asked for. Every call adds a reference, see releaseModel.
+    ModelHandle getModel(const std::string& filePath);
+    AnimatedModelHandle getAnimatedModel(const std::string& filePath);
+
+    //Returns nullptr if the model was freed.
+    _3DM::ModelResource* getResource(ModelHandle handle) const { return models.get(handle); }
+    _3DM::AnimatedModelResource* getResource(AnimatedModelHandle handle) const { return animatedModels.get(handle); }
+
+    //Reads the CPU side geometry of a model again after every model using it released it.
+    void reloadGeometry(ModelHandle handle);
+    void reloadGeometry(AnimatedModelHandle handle);
+
+    //Removes a reference added by getModel. The model is freed by the next freeUnreferencedModels if it has no references left.
+    void releaseModel(ModelHandle handle) { models.release(handle); }
+    void releaseAnimatedModel(AnimatedModelHandle handle) { animatedModels.release(handle); }
+
+    //Frees every model without references. Called after a scene is loaded, so models both scenes use stay loaded.
+    void freeUnreferencedModels();
+
+    ModelHandler() {}
+
+    //Deletes the buffers of every model still loaded.
+    ~ModelHandler();
+
+    ModelHandler(const ModelHandler&) = delete;
+    ModelHandler(ModelHandler&&)      = delete;
+    ModelHandler& operator=(const ModelHandler&) = delete;
+    ModelHandler& operator=(ModelHandler&&) = delete;
+
+private:
+    AssetRegistry<_3DM::ModelResource> models;
+    AssetRegistry<_3DM::AnimatedModelResource> animatedModels;
+};
+
+#endif
@@ -487,17 +487,18 @@ void _3DM::_3DM_IO::setIfstream(const char* path) {
     iStream.seekg(0, iStream.beg);
 }
 
-void _3DM::_3DM_IO::writeAnimatedModel(_3DM::AnimatedModel& model, std::ofstream& oStream) {
+void _3DM::_3DM_IO::writeAnimatedModel(_3DM::AnimatedModelResource& model, std::ofstream& oStream) {
 
     Byte boneIdSize      = static_cast<Byte>(model.boneIDMap.size());
     Byte sizeOfRootPath  = static_cast<Byte>(model.rootPath.size());
     Byte sizeOfSignature = static_cast<Byte>(_3DMA_Signature.size());
+    Byte modelLoaded     = 1;
 
     writeBytes(sizeOfSignature, 1, oStream);
 
     oStream.write(_3DMA_Signature.c_str(), sizeOfSignature);
 
-    writeAnimation(model.modelsAnimation, oStream);
+    writeAnimation(model.animation, oStream);
 
     writeVector<_3DM::AnimatedMesh>([&](_3DM::AnimatedMesh& mesh, std::ofstream& oS) { writeAnimatedMesh(mesh, oS); }, model.meshes, oStream);
     writeVector<_3DM::AnimationClip>([&](_3DM::AnimationClip& mesh, std::ofstream& oS) { writeAnimationClip(mesh, oS); }, model.animationClips, oStream);
@@ -513,22 +514,21 @@ void _3DM::_3DM_IO::writeAnimatedModel(_3DM::AnimatedModel& model, std::ofstream
         writeBytes(i->second, 4, oStream);
     }
 
-    writeBytes(model.modelLoaded, 1, oStream);
+    writeBytes(modelLoaded, 1, oStream);
 
     writeBytes(sizeOfRootPath, 1, oStream);
 
     oStream.write(model.rootPath.c_str(), sizeOfRootPath);
 }
 
-_3DM::AnimatedModel _3DM::_3DM_IO::readAnimatedModel(const std::string& path) {
+void _3DM::_3DM_IO::readAnimatedModel(const std::string& path, _3DM::AnimatedModelResource& newModel) {
 
     isBigEndianness = isBigEndian();
 
-    _3DM::AnimatedModel newModel;
-
     Byte boneIdSize      = 0;
     Byte sizeOfRootPath  = 0;
     Byte sizeOfSignature = 0;
+    Byte modelLoaded     = 0;
 
     setIfstream(path.c_str());
 
@@ -538,7 +538,7 @@ _3DM::AnimatedModel _3DM::_3DM_IO::readAnimatedModel(const std::string& path) {
 
     iStream.seekg(static_cast<Byte>(iStream.tellg()) + sizeOfSignature, std::ios::beg);
 
-    newModel.modelsAnimation = readAnimation(iStream);
+    newModel.animation = readAnimation(iStream);
 
     newModel.meshes         = readVector<_3DM::AnimatedMesh>([&]() -> _3DM::AnimatedMesh { return readAnimatedMesh(iStream); }, iStream);
     newModel.animationClips = readVector<_3DM::AnimationClip>([&]() -> _3DM::AnimationClip { return readAnimationClip(iStream); }, iStream);
@@ -567,7 +567,7 @@ _3DM::AnimatedModel _3DM::_3DM_IO::readAnimatedModel(const std::string& path) {
         newStr = nullptr;
     }
 
-    readBytes(newModel.modelLoaded, 1, iStream, isBigEndianness);
+    readBytes(modelLoaded, 1, iStream, isBigEndianness);
 
     readBytes(sizeOfRootPath, 1, iStream, isBigEndianness);
 
@@ -579,26 +579,24 @@ _3DM::AnimatedModel _3DM::_3DM_IO::readAnimatedModel(const std::string& path) {
 
     delete[] rootPath;
     rootPath = nullptr;
-
-    newModel.modelLoaded = true;
-
-    return newModel;
 }
 
-void _3DM::_3DM_IO::writeModel(_3DM::Model& model, std::ofstream& oStream) {
+void _3DM::_3DM_IO::writeModel(_3DM::ModelResource& model, std::ofstream& oStream) {
+    Byte modelLoaded = 1;
+
     writeVector<_3DM::Mesh>([&](_3DM::Mesh& mesh, std::ofstream& oStream) { writeMesh(mesh, oStream); }, model.meshes, oStream);
 
     TwoBytes sizeOfString = static_cast<TwoBytes>(model.rootPath.size());
     writeBytes(sizeOfString, 2, oStream);
     writeBytes(model.rootPath.c_str(), sizeOfString, oStream);
 
-    writeBytes(model.modelLoaded, 1, oStream);
+    writeBytes(modelLoaded, 1, oStream);
 }
 
-_3DM::Model _3DM::_3DM_IO::readModel(const std::string& path) {
+void _3DM::_3DM_IO::readModel(const std::string& path, _3DM::ModelResource& newModel) {
 
-    _3DM::Model newModel;
     TwoBytes sizeOfString;
+    Byte modelLoaded = 0;
 
     setIfstream(path.c_str());
 
@@ -610,14 +608,10 @@ _3DM::Model _3DM::_3DM_IO::readModel(const std::string& path) {
 
     newModel.rootPath = std::string(rootPath, sizeOfString);
 
-    readBytes(newModel.modelLoaded, 1, iStream, isBigEndianness);
-
-    newModel.modelLoaded = true;
+    readBytes(modelLoaded, 1, iStream, isBigEndianness);
 
     delete[] rootPath;
     rootPath = nullptr;
-
-    return newModel;
 }
 
 _3DM::_3DM_IO::~_3DM_IO() {
@@ -3,17 +3,14 @@
 
 #include <SDL_endian.h>
 
-#include "AnimatedModel.h"
-#include "Model.h"
-
+#include "ModelResource.h"
 #include "Serialization.h"
+#include <fstream>
 
 using namespace Serialization;
 
 namespace _3DM {
 
-    class AnimatedModel;
-    class Model;
     //Consts
 
     const Byte Mat_4_ROW_COL_SIZE = 4;
@@ -27,25 +24,25 @@ namespace _3DM {
     class _3DM_IO {
 
     public:
-        /***************************************************************************************
-		*Used to read a 3DMA Model File and return a Model. iStream::tellg is expected to be 0.*
-		****************************************************************************************/
-        AnimatedModel readAnimatedModel(const std::string& path);
+        /*************************************************************************************
+		*Used to read a 3DMA Model File into a resource. iStream::tellg is expected to be 0.*
+		**************************************************************************************/
+        void readAnimatedModel(const std::string& path, AnimatedModelResource& model);
 
         /*********************************************************************
 		*Used to write a 3DMA Model File. oStream::tellp is expected to be 0.*
 		**********************************************************************/
-        void writeAnimatedModel(AnimatedModel& model, std::ofstream& oStream);
+        void writeAnimatedModel(AnimatedModelResource& model, std::ofstream& oStream);
 
-        /***************************************************************************************
-		*Used to read a 3DMA Model File and return a Model. iStream::tellg is expected to be 0.*
-		****************************************************************************************/
-        Model readModel(const std::string& path);
+        /************************************************************************************
+		*Used to read a 3DM Model File into a resource. iStream::tellg is expected to be 0.*
+		*************************************************************************************/
+        void readModel(const std::string& path, ModelResource& model);
 
         /*********************************************************************
 		*Used to write a 3DMA Model File. oStream::tellp is expected to be 0.*
 		**********************************************************************/
-        void writeModel(Model& model, std::ofstream& oStream);
+        void writeModel(ModelResource& model, std::ofstream& oStream);
 
         ~_3DM_IO();
 
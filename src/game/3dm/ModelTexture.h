@@ -1,7 +1,10 @@
 #ifndef MODEL_TEXTURE
 #define MODEL_TEXTURE
+#include "AssetRegistry.h"
 #include <string>
 
+class Texture;
+
 namespace _3DM {
     enum class TextureType {
         Diffuse  = 0,
@@ -14,7 +17,7 @@ namespace _3DM {
 
         //These variables do not need serialization
         std::string uniformName = "";
-        unsigned int imageID    = 0;
+        AssetHandle<Texture> texture;
     };
 };
 
@@ -0,0 +1,191 @@
+#include "VertexFormat.h"
+#include "Shaders.h"
+#include <cstddef>
+#include <glm/gtc/packing.hpp>
+
+glm::vec2 _3DM::VertexFormat::encodeOctahedral(const glm::vec3& normal) {
+    const float length = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+
+    if (length <= 0.0f) {
+        return glm::vec2(0.0f);
+    }
+
+    glm::vec2 encoded = glm::vec2(normal.x, normal.y) / length;
+
+    //Fold the lower hemisphere over the diagonals.
+    if (normal.z < 0.0f) {
+        const glm::vec2 folded = glm::vec2(1.0f - glm::abs(encoded.y), 1.0f - glm::abs(encoded.x));
+
+        encoded.x = encoded.x >= 0.0f ? folded.x : -folded.x;
+        encoded.y = encoded.y >= 0.0f ? folded.y : -folded.y;
+    }
+
+    return encoded;
+}
+
+glm::vec3 _3DM::VertexFormat::decodeOctahedral(const glm::vec2& encoded) {
+    glm::vec3 normal = glm::vec3(encoded.x, encoded.y, 1.0f - glm::abs(encoded.x) - glm::abs(encoded.y));
+
+    const float fold = glm::max(-normal.z, 0.0f);
+
+    normal.x += normal.x >= 0.0f ? -fold : fold;
+    normal.y += normal.y >= 0.0f ? -fold : fold;
+
+    return glm::normalize(normal);
+}
+
+_3DM::PackedVertex _3DM::VertexFormat::packVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv) {
+    const glm::vec2 encodedNormal = encodeOctahedral(normal);
+
+    PackedVertex vertex;
+    vertex.position  = position;
+    vertex.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(encodedNormal.x));
+    vertex.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(encodedNormal.y));
+    vertex.uv[0]     = glm::packHalf1x16(uv.x);
+    vertex.uv[1]     = glm::packHalf1x16(uv.y);
+
+    return vertex;
+}
+
+void _3DM::VertexFormat::packVertices(const Mesh& mesh, std::vector<PackedVertex>& packedVertices) {
+    packedVertices.resize(mesh.vertices.size());
+
+    for (unsigned int i = 0; i < mesh.vertices.size(); i++) {
+        const glm::vec3 normal = i < mesh.normals.size() ? mesh.normals[i] : glm::vec3(0, 1, 0);
+        const glm::vec2 uv     = i < mesh.uvs.size() ? mesh.uvs[i] : glm::vec2(0);
+
+        packedVertices[i] = packVertex(mesh.vertices[i], normal, uv);
+    }
+}
+
+void _3DM::VertexFormat::packVertices(const AnimatedMesh& animatedMesh, std::vector<PackedAnimatedVertex>& packedVertices) {
+    const Mesh& mesh = animatedMesh.mesh;
+
+    packedVertices.resize(mesh.vertices.size());
+
+    for (unsigned int i = 0; i < mesh.vertices.size(); i++) {
+        const glm::vec3 normal  = i < mesh.normals.size() ? mesh.normals[i] : glm::vec3(0, 1, 0);
+        const glm::vec2 uv      = i < mesh.uvs.size() ? mesh.uvs[i] : glm::vec2(0);
+        const glm::vec4 weights = i < animatedMesh.weights.size() ? animatedMesh.weights[i] : glm::vec4(1, 0, 0, 0);
+        const glm::vec4 boneIDs = i < animatedMesh.boneIDs.size() ? animatedMesh.boneIDs[i] : glm::vec4(0);
+
+        PackedAnimatedVertex& packedVertex = packedVertices[i];
+        packedVertex.vertex                = packVertex(mesh.vertices[i], normal, uv);
+
+        //Rounding each weight on its own can make the sum drift from 255, so the error is given to the largest weight.
+        int sum     = 0;
+        int largest = 0;
+
+        for (int j = 0; j < 4; j++) {
+            packedVertex.weights[j] = static_cast<uint8_t>(glm::round(glm::clamp(weights[j], 0.0f, 1.0f) * 255.0f));
+            packedVertex.boneIDs[j] = static_cast<uint8_t>(glm::clamp(boneIDs[j], 0.0f, 255.0f));
+
+            sum += packedVertex.weights[j];
+
+            if (packedVertex.weights[j] > packedVertex.weights[largest]) {
+                largest = j;
+            }
+        }
+
+        if (sum > 0) {
+            packedVertex.weights[largest] = static_cast<uint8_t>(glm::clamp(packedVertex.weights[largest] + 255 - sum, 0, 255));
+        }
+    }
+}
+
+bool _3DM::VertexFormat::canUseShortIndices(size_t amountOfVertices) {
+    return amountOfVertices <= 0xFFFF;
+}
+
+GLenum _3DM::VertexFormat::uploadIndices(const std::vector<uint32_t>& indices, size_t amountOfVertices) {
+    if (indices.empty()) {
+        return GL_UNSIGNED_INT;
+    }
+
+    if (!canUseShortIndices(amountOfVertices)) {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * indices.size(), &indices[0], GL_STATIC_DRAW);
+        return GL_UNSIGNED_INT;
+    }
+
+    const std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t) * shortIndices.size(), &shortIndices[0], GL_STATIC_DRAW);
+
+    return GL_UNSIGNED_SHORT;
+}
+
+//Sets up the attributes shared by both vertex formats.
+static void setSharedVertexAttributes(GLsizei stride) {
+    const GLint positionAttribute = Shaders::getAttribLocation(Shaders::AttribName::Position);
+    const GLint normalsAttribute  = Shaders::getAttribLocation(Shaders::AttribName::Normal);
+    const GLint uvAttribute       = Shaders::getAttribLocation(Shaders::AttribName::TextureCoordinates);
+
+    glEnableVertexAttribArray(positionAttribute);
+    glVertexAttribPointer(positionAttribute, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(_3DM::PackedVertex, position)));
+
+    glEnableVertexAttribArray(normalsAttribute);
+    glVertexAttribPointer(normalsAttribute, 2, GL_SHORT, GL_TRUE, stride, reinterpret_cast<void*>(offsetof(_3DM::PackedVertex, normal)));
+
+    glEnableVertexAttribArray(uvAttribute);
+    glVertexAttribPointer(uvAttribute, 2, GL_HALF_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(_3DM::PackedVertex, uv)));
+}
+
+void _3DM::VertexFormat::setVertexAttributes() {
+    setSharedVertexAttributes(sizeof(PackedVertex));
+}
+
+//Sets up the bone weight and bone id attributes of the animated vertex format.
+static void setSkinningAttributes() {
+    const GLint weightsAttribute = Shaders::getAttribLocation(Shaders::AttribName::BoneWeights);
+    const GLint boneIDsAttribute = Shaders::getAttribLocation(Shaders::AttribName::BoneIDS);
+    const GLsizei stride         = sizeof(_3DM::PackedAnimatedVertex);
+
+    glEnableVertexAttribArray(weightsAttribute);
+    glVertexAttribPointer(weightsAttribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, reinterpret_cast<void*>(offsetof(_3DM::PackedAnimatedVertex, weights)));
+
+    //Not normalized, so the shader still receives the bone ids as whole numbers.
+    glEnableVertexAttribArray(boneIDsAttribute);
+    glVertexAttribPointer(boneIDsAttribute, 4, GL_UNSIGNED_BYTE, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(_3DM::PackedAnimatedVertex, boneIDs)));
+}
+
+void _3DM::VertexFormat::setAnimatedVertexAttributes() {
+    setSharedVertexAttributes(sizeof(PackedAnimatedVertex));
+    setSkinningAttributes();
+}
+
+void _3DM::VertexFormat::uploadPositions(const std::vector<glm::vec3>& positions) {
+    if (positions.empty()) {
+        return;
+    }
+
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * positions.size(), &positions[0], GL_STATIC_DRAW);
+}
+
+void _3DM::VertexFormat::setDepthVertexAttributes() {
+    const GLint positionAttribute = Shaders::getAttribLocation(Shaders::AttribName::Position);
+
+    glEnableVertexAttribArray(positionAttribute);
+    glVertexAttribPointer(positionAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), reinterpret_cast<void*>(0));
+}
+
+void _3DM::VertexFormat::setAnimatedDepthVertexAttributes() {
+    const GLint positionAttribute = Shaders::getAttribLocation(Shaders::AttribName::Position);
+
+    glEnableVertexAttribArray(positionAttribute);
+    glVertexAttribPointer(positionAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(PackedAnimatedVertex), reinterpret_cast<void*>(offsetof(PackedVertex, position)));
+
+    setSkinningAttributes();
+}
+
+void _3DM::VertexFormat::releaseGeometry(Mesh& mesh) {
+    std::vector<glm::vec3>().swap(mesh.vertices);
+    std::vector<glm::vec3>().swap(mesh.normals);
+    std::vector<glm::vec2>().swap(mesh.uvs);
+    std::vector<uint32_t>().swap(mesh.indices);
+}
+
+void _3DM::VertexFormat::releaseGeometry(AnimatedMesh& animatedMesh) {
+    releaseGeometry(animatedMesh.mesh);
+
+    std::vector<glm::vec4>().swap(animatedMesh.weights);
+    std::vector<glm::vec4>().swap(animatedMesh.boneIDs);
+}
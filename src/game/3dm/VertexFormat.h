@@ -0,0 +1,87 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include "AnimatedMesh.h"
+#include "Mesh.h"
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace _3DM {
+
+    //!Interleaved vertex uploaded for static meshes. 20 bytes instead of the 32 bytes of three float arrays.
+    struct PackedVertex {
+        glm::vec3 position;
+
+        //!Octahedral encoded normal, stored as two normalized shorts.
+        int16_t normal[2];
+
+        //!Half float texture coordinates.
+        uint16_t uv[2];
+    };
+
+    //!Interleaved vertex uploaded for animated meshes. 28 bytes instead of the 64 bytes of five float arrays.
+    struct PackedAnimatedVertex {
+        PackedVertex vertex;
+
+        //!Bone weights normalized to bytes. The four weights always add up to 255.
+        uint8_t weights[4];
+
+        //!Bone ids, which fit in a byte since the shaders support at most 64 bones.
+        uint8_t boneIDs[4];
+    };
+
+    /*!Converts meshes to the packed vertex formats and uploads them.
+
+    Normals are octahedral encoded, uvs are stored as half floats, bone weights as normalized bytes,
+    and indices are stored as shorts when every vertex of the mesh can be addressed with one.
+    */
+    namespace VertexFormat {
+
+        //!Maps a unit vector onto the [-1, 1] square.
+        glm::vec2 encodeOctahedral(const glm::vec3& normal);
+
+        //!Reverses encodeOctahedral. The same math is done in the vertex shaders.
+        glm::vec3 decodeOctahedral(const glm::vec2& encoded);
+
+        //!Packs a position, normal and uv. Used by anything that uploads vertices for the lit shaders.
+        PackedVertex packVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv);
+
+        //!Packs every vertex of the mesh. Missing normals or uvs are filled in.
+        void packVertices(const Mesh& mesh, std::vector<PackedVertex>& packedVertices);
+
+        //!Packs every vertex of the animated mesh. Missing normals, uvs or weights are filled in.
+        void packVertices(const AnimatedMesh& animatedMesh, std::vector<PackedAnimatedVertex>& packedVertices);
+
+        //!Returns true if every vertex of a mesh with amountOfVertices can be indexed with a short.
+        bool canUseShortIndices(size_t amountOfVertices);
+
+        //!Uploads the indices into the bound element buffer, as shorts if possible. Returns GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+        GLenum uploadIndices(const std::vector<uint32_t>& indices, size_t amountOfVertices);
+
+        //!Points the attributes of the bound vertex array object at the bound PackedVertex buffer.
+        void setVertexAttributes();
+
+        //!Points the attributes of the bound vertex array object at the bound PackedAnimatedVertex buffer.
+        void setAnimatedVertexAttributes();
+
+        //!Uploads the positions alone into the bound array buffer, for the vertex array objects of the depth passes.
+        void uploadPositions(const std::vector<glm::vec3>& positions);
+
+        //!Points the position attribute of the bound vertex array object at the bound buffer of uploadPositions.
+        void setDepthVertexAttributes();
+
+        //!Points the position and skinning attributes of the bound vertex array object at the bound PackedAnimatedVertex buffer.
+        //!Normals and uvs are left disabled.
+        void setAnimatedDepthVertexAttributes();
+
+        //!Frees the CPU side geometry of the mesh. Bounds and index counts are kept.
+        void releaseGeometry(Mesh& mesh);
+
+        //!Frees the CPU side geometry of the animated mesh. Bounds and index counts are kept.
+        void releaseGeometry(AnimatedMesh& animatedMesh);
+    }
+}
+
+#endif
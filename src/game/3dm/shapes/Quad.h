@@ -10,13 +10,6 @@
 #include <glm/gtx/transform.hpp>
 class Quad {
 public:
-    void render3D(
-        const Shader& shader,
-        const Texture& texture,
-        const glm::vec4& spriteOrientationInPixels,
-        const glm::vec2& positionInPixels,
-        const glm::vec2& scaleInPixels);
-
     void render3D(const Shader& shader, GLint textureID, glm::mat4& modelMatrix);
 
     void render2D(const Shader& shader, GLint textureID);
@@ -27,7 +20,11 @@ public:
 private:
     void init();
 
-    bool hasInit = false;
+    //!Uploads quadVertices the first time a quad with fixed texture coordinates is rendered.
+    void uploadVertices();
+
+    bool hasInit          = false;
+    bool uploadedVertices = false;
 
     GLuint quadVAO                    = 0;
     GLuint quadVBO                    = 0;
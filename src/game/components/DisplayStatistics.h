@@ -4,24 +4,49 @@
 #include "GUIResizingInfo.h"
 #include "GuiString.h"
 #include "LTime.h"
+#include "Locator.h"
+#include <cstdio>
 #include <numeric>
 
 class DisplayStatistics : public Component<DisplayStatistics> {
 
 public:
+    ~DisplayStatistics() {
+        if (font) {
+            TextureLocator::getService().releaseTexture(font->getHandle());
+        }
+    }
+
+    //!Takes over the reference getTexture added to texture.
     void initialize(TextMap& textMap, Texture& texture) {
+        if (font) {
+            TextureLocator::getService().releaseTexture(font->getHandle());
+        }
+
+        font = &texture;
         guiString.initialize(textMap, texture);
     }
 
 private:
-    GuiString guiString = GuiString(20);
+    Texture* font = nullptr;
+
+    GuiString guiString = GuiString(160);
 
     float lastUnit = 0;
 
-    float currentInterval   = 0.f;
-    std::string currentFPS  = "0";
-    std::string currentMSPF = "0";
-    int lastFPS             = 0;
+    float currentInterval = 0.f;
+    int lastFPS           = -1;
+    double lastMSPF       = -1.0;
+
+    //!Texture memory in megabytes, see TextureHandler::getResidentBytes.
+    double lastResidentMB  = -1.0;
+    double lastRequestedMB = -1.0;
+
+    //!GPU milliseconds of the frame and of its passes, see GpuProfiler. Negative while the GPU isn't profiled.
+    double lastGpuMS = -1.0;
+
+    //!The formatted statistics. Rewritten in place so formatting doesn't allocate.
+    char text[192] = {};
 
     friend class DisplayStatisticsSystem;
 };
@@ -0,0 +1,24 @@
+#ifndef OCCLUDER_H
+#define OCCLUDER_H
+#include "Component.h"
+#include "Model.h"
+
+//!Component used to mark a model as an occluder. Occluders are only rasterized by the OcclusionCuller, never rendered.
+//!Simplified meshes such as collision meshes make the best occluders.
+class Occluder : public Component<Occluder> {
+
+public:
+    void initialize(_3DM::Model& occluderModel, const glm::mat4& occluderMatrix = glm::mat4(1.0f)) {
+        model       = &occluderModel;
+        modelMatrix = occluderMatrix;
+    }
+
+    _3DM::Model* getModel() const { return model; }
+    const glm::mat4& getModelMatrix() const { return modelMatrix; }
+
+private:
+    _3DM::Model* model    = nullptr;
+    glm::mat4 modelMatrix = glm::mat4(1.0f);
+};
+
+#endif
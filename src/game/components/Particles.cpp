@@ -1,6 +1,10 @@
 #include "Particles.h"
 
 Particles::~Particles() {
+    if (particleTexture) {
+        TextureLocator::getService().releaseTexture(particleTexture->getHandle());
+    }
+
     if (!initialized) {
         return;
     }
@@ -9,7 +13,26 @@ Particles::~Particles() {
 
     glDeleteVertexArrays(1, &vertexArrayObject);
     glDeleteBuffers(1, &bufferObject);
-    glDeleteBuffers(1, &instanceBufferObject);
+
+    if (gpuStateInitialized) {
+        glDeleteVertexArrays(2, gpuUpdateArrays);
+        glDeleteVertexArrays(2, gpuRenderArrays);
+        glDeleteBuffers(2, gpuStateBuffers);
+    }
+}
+
+void Particles::setTexture(const Texture& pTexture) {
+    if (particleTexture == &pTexture) {
+        //The caller's getTexture added a second reference, this one is kept.
+        TextureLocator::getService().releaseTexture(pTexture.getHandle());
+        return;
+    }
+
+    if (particleTexture) {
+        TextureLocator::getService().releaseTexture(particleTexture->getHandle());
+    }
+
+    particleTexture = &pTexture;
 }
 
 //Generates VAO & buffers
@@ -21,14 +44,33 @@ void Particles::initialize(const Settings& worldSettings) {
     glGenVertexArrays(1, &vertexArrayObject);
     glBindVertexArray(vertexArrayObject);
 
-    //Generate buffer for normal stuff, and other for instancing.
+    //Generate buffer for normal stuff, and a stream for instancing.
     glGenBuffers(1, &bufferObject);
-    glGenBuffers(1, &instanceBufferObject);
+    instanceStream.initialize(getCapacity() * sizeof(ParticleInstance));
 
     //Supply info about quad and texture coordinates to normal buffer.
     glBindBuffer(GL_ARRAY_BUFFER, bufferObject);
     glBufferData(GL_ARRAY_BUFFER, sizeof(hh::quadVertices), &hh::quadVertices, GL_STATIC_DRAW);
 
+    supplyQuadAttributes();
+
+    //The instance attributes are pointed at the stream every time it is written to (see DefaultParticleSystem::renderParticles).
+    glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::ParticlePosition));
+    glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::ParticleScale));
+    glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::ParticleColor));
+
+    //Update data when rendering new instance- so we use the same quad dimensions and texture coordinates per draw, but not color, scale, or position.
+    glVertexAttribDivisor(Shaders::getAttribLocation(Shaders::AttribName::ParticleColor), 1);
+    glVertexAttribDivisor(Shaders::getAttribLocation(Shaders::AttribName::ParticleScale), 1);
+    glVertexAttribDivisor(Shaders::getAttribLocation(Shaders::AttribName::ParticlePosition), 1);
+
+    glBindVertexArray(0);
+
+    initialized = true;
+}
+
+//Points the position and texture coordinates at the quad. The vao and quad buffer should be bound.
+void Particles::supplyQuadAttributes() {
     glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::Position));
     glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::TextureCoordinates));
 
@@ -47,46 +89,72 @@ void Particles::initialize(const Settings& worldSettings) {
         GL_FALSE,
         5 * sizeof(GLfloat),
         (GLvoid*)(3 * sizeof(GLfloat)));
+}
 
-    //Bind instance buffer and supply info about each particle.
-    glBindBuffer(GL_ARRAY_BUFFER, instanceBufferObject);
-    glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::ParticlePosition));
-    glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::ParticleScale));
-    glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::ParticleColor));
+void Particles::initializeGpuState() {
+    if (gpuStateInitialized) {
+        return;
+    }
+    if (!initialized) {
+        DBG_LOG("Please initialize particles before their gpu state (Particles.cpp initializeGpuState)\n");
+        return;
+    }
 
-    //Since we use a very simple struct using offsetof gets us the position of the attrib
-    glVertexAttribPointer(
-        Shaders::getAttribLocation(Shaders::AttribName::ParticlePosition),
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Particle),
-        (GLvoid*)(offsetof(Particle, Particle::position)));
+    //Every particle starts out dead (lifeTime and size of 0).
+    const std::vector<GpuParticle> deadParticles(getCapacity());
 
-    glVertexAttribPointer(
-        Shaders::getAttribLocation(Shaders::AttribName::ParticleScale),
-        1,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Particle),
-        (GLvoid*)(offsetof(Particle, Particle::size)));
+    glGenBuffers(2, gpuStateBuffers);
+    glGenVertexArrays(2, gpuUpdateArrays);
+    glGenVertexArrays(2, gpuRenderArrays);
 
-    glVertexAttribPointer(
-        Shaders::getAttribLocation(Shaders::AttribName::ParticleColor),
-        4,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Particle),
-        (GLvoid*)(offsetof(Particle, Particle::color)));
+    for (unsigned int i = 0; i < 2; i++) {
+        glBindBuffer(GL_ARRAY_BUFFER, gpuStateBuffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, deadParticles.size() * sizeof(GpuParticle), &deadParticles[0], GL_DYNAMIC_COPY);
 
-    //Update data when rendering new instance- so we use the same quad dimensions and texture coordinates per draw, but not color, scale, or position.
-    glVertexAttribDivisor(Shaders::getAttribLocation(Shaders::AttribName::ParticleColor), 1);
-    glVertexAttribDivisor(Shaders::getAttribLocation(Shaders::AttribName::ParticleScale), 1);
-    glVertexAttribDivisor(Shaders::getAttribLocation(Shaders::AttribName::ParticlePosition), 1);
+        //Read by the update shader, which uses its own locations (see particle-update.vert).
+        glBindVertexArray(gpuUpdateArrays[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, gpuStateBuffers[i]);
+
+        for (GLuint location = 0; location < 5; location++) {
+            glEnableVertexAttribArray(location);
+        }
+
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (GLvoid*)offsetof(GpuParticle, position));
+        glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (GLvoid*)offsetof(GpuParticle, size));
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (GLvoid*)offsetof(GpuParticle, speed));
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (GLvoid*)offsetof(GpuParticle, lifeTime));
+        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (GLvoid*)offsetof(GpuParticle, color));
+
+        //Read by the particle shader, the same way the streamed instances are.
+        glBindVertexArray(gpuRenderArrays[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, bufferObject);
+        supplyQuadAttributes();
+
+        glBindBuffer(GL_ARRAY_BUFFER, gpuStateBuffers[i]);
+
+        const GLuint positionLocation = Shaders::getAttribLocation(Shaders::AttribName::ParticlePosition);
+        const GLuint scaleLocation    = Shaders::getAttribLocation(Shaders::AttribName::ParticleScale);
+        const GLuint colorLocation    = Shaders::getAttribLocation(Shaders::AttribName::ParticleColor);
+
+        glEnableVertexAttribArray(positionLocation);
+        glEnableVertexAttribArray(scaleLocation);
+        glEnableVertexAttribArray(colorLocation);
+
+        glVertexAttribPointer(positionLocation, 3, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (GLvoid*)offsetof(GpuParticle, position));
+        glVertexAttribPointer(scaleLocation, 1, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (GLvoid*)offsetof(GpuParticle, size));
+        glVertexAttribPointer(colorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (GLvoid*)offsetof(GpuParticle, color));
+
+        glVertexAttribDivisor(positionLocation, 1);
+        glVertexAttribDivisor(scaleLocation, 1);
+        glVertexAttribDivisor(colorLocation, 1);
+    }
 
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    initialized = true;
+    currentGpuState     = 0;
+    gpuSpawnCursor      = 0;
+    gpuStateInitialized = true;
 }
 
 bool Particles::areVitalsNull() {
@@ -96,3 +164,72 @@ bool Particles::areVitalsNull() {
     }
     return false;
 }
+
+void Particles::resize(unsigned int size) {
+    std::vector<float>* arrays[] = {
+        &lifeTimes, &weights, &sizes,
+        &positionsX, &positionsY, &positionsZ,
+        &speedsX, &speedsY, &speedsZ,
+        &colorsR, &colorsG, &colorsB, &colorsA
+    };
+
+    for (std::vector<float>* attribute : arrays) {
+        attribute->resize(size);
+    }
+
+    //Every emitter gets its own sequence.
+    static uint32_t emitterCount = 0;
+    random.setSeed(2463534242u + 0x9E3779B9u * ++emitterCount);
+}
+
+void Particles::setParticle(unsigned int index, const Particle& particle) {
+    lifeTimes[index]  = particle.lifeTime;
+    weights[index]    = particle.weight;
+    sizes[index]      = particle.size;
+    positionsX[index] = particle.position.x;
+    positionsY[index] = particle.position.y;
+    positionsZ[index] = particle.position.z;
+    speedsX[index]    = particle.speed.x;
+    speedsY[index]    = particle.speed.y;
+    speedsZ[index]    = particle.speed.z;
+    colorsR[index]    = particle.color.r;
+    colorsG[index]    = particle.color.g;
+    colorsB[index]    = particle.color.b;
+    colorsA[index]    = particle.color.a;
+}
+
+Particle Particles::getParticle(unsigned int index) const {
+    Particle particle;
+
+    if (index >= getCapacity()) {
+        DBG_LOG("This index goes out of bounds (Particles.cpp getParticle)\n");
+        return particle;
+    }
+
+    particle.lifeTime = lifeTimes[index];
+    particle.weight   = weights[index];
+    particle.size     = sizes[index];
+    particle.position = glm::vec3(positionsX[index], positionsY[index], positionsZ[index]);
+    particle.speed    = glm::vec3(speedsX[index], speedsY[index], speedsZ[index]);
+    particle.color    = glm::vec4(colorsR[index], colorsG[index], colorsB[index], colorsA[index]);
+
+    return particle;
+}
+
+void Particles::removeParticle(unsigned int index) {
+    const unsigned int last = --renderingSize;
+
+    lifeTimes[index]  = lifeTimes[last];
+    weights[index]    = weights[last];
+    sizes[index]      = sizes[last];
+    positionsX[index] = positionsX[last];
+    positionsY[index] = positionsY[last];
+    positionsZ[index] = positionsZ[last];
+    speedsX[index]    = speedsX[last];
+    speedsY[index]    = speedsY[last];
+    speedsZ[index]    = speedsZ[last];
+    colorsR[index]    = colorsR[last];
+    colorsG[index]    = colorsG[last];
+    colorsB[index]    = colorsB[last];
+    colorsA[index]    = colorsA[last];
+}
@@ -5,6 +5,8 @@
 #include "Locator.h"
 #include "Settings.h"
 #include "Shader.h"
+#include "StreamingBuffer.h"
+#include "XorShiftRandom.h"
 #include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/norm.hpp>
@@ -14,13 +16,13 @@
 //Used to tell which system should be used for a Particles component.
 //A system can be an overriden DefaultParticleSystem- the proper system to be called is set in the main systems file's.
 enum class PARTICLE_TYPE {
-    Default  = 0,
-    Fountain = 1,
-    Max      = 2
+    Default     = 0,
+    Fountain    = 1,
+    GpuFountain = 2,
+    Max         = 3
 };
 
-//Particle struct used for instanced rendering.
-//      !!! Be careful changing it's contents !!!         : a VBO relies on it's format.
+//Describes a single particle. Used when a particle is spawned, the Particles component stores every attribute in its own array.
 struct Particle {
     float lifeTime     = 0;
     float weight       = 0;
@@ -30,16 +32,35 @@ struct Particle {
     glm::vec4 color    = glm::vec4(1, 1, 1, 1);
 };
 
-//Manages an array of particles and generated vao/vbos to be used by a particle system.
+//The part of a particle the GPU reads, streamed once per frame for instanced rendering.
+//      !!! Be careful changing it's contents !!!         : a VBO relies on it's format.
+struct ParticleInstance {
+    glm::vec3 position;
+    float size;
+    glm::vec4 color;
+};
+
+//The state of a particle simulated by the GpuParticleSystem. Written by transform feedback, so it is tightly packed.
+//      !!! Be careful changing it's contents !!!         : particle-update.vert's outputs rely on it's format.
+struct GpuParticle {
+    glm::vec3 position = glm::vec3(0.0f);
+    float size         = 0;
+    glm::vec3 speed    = glm::vec3(0.0f);
+    float lifeTime     = 0;
+    glm::vec4 color    = glm::vec4(0.0f);
+};
+
+//Manages the particles and generated vao/vbos to be used by a particle system.
+//Particles are stored as a structure of arrays so systems can update several of them at once with SIMD.
 class Particles : public Component<Particles> {
 public:
     Particles() {
-        particles.resize(100);
+        resize(100);
     }
 
     //Size must not change throughout the lifetime of the system.
     Particles(unsigned int size) {
-        particles.resize(size);
+        resize(size);
     }
 
     void initialize(const Settings& worldSettings);
@@ -48,12 +69,20 @@ public:
 
     bool areVitalsNull();
 
+    //Creates the buffers the GpuParticleSystem keeps the particles in. Should be called after initialize.
+    void initializeGpuState();
+
     unsigned int getParticlesPerSecond() { return particlesPerSecond; }
     const Texture* const getTexture() { return particleTexture; }
-    std::vector<Particle>* const getParticles() { return &particles; }
+    unsigned int getCapacity() const { return static_cast<unsigned int>(lifeTimes.size()); }
+    int getAmountOfParticles() const { return renderingSize; }
     PARTICLE_TYPE const getParticleType() { return particleType; }
 
-    void setTexture(const Texture& pTexture) { particleTexture = &pTexture; }
+    //!Gathers the live particle at index from every array. Used to check the systems' results.
+    Particle getParticle(unsigned int index) const;
+
+    //!Takes over the reference getTexture added to pTexture. It is released with the particles, or when another texture is set.
+    void setTexture(const Texture& pTexture);
     //Used for wind direction & such
     void setWorldSettings(const Settings& worldSettings) { currentWorldSettings = &worldSettings; }
 
@@ -65,11 +94,39 @@ public:
     void setDefaultColor(const glm::vec4& color) { defaultColor = color; }
     void setPosition(const glm::vec3& position) { emmisionPosition = position; }
     void setParticleType(PARTICLE_TYPE t) { particleType = t; }
+    //!Every emitter is given its own sequence. Emitters with the same seed spawn the same particles.
+    void setSeed(uint32_t seed) { random.setSeed(seed); }
 
 private:
+    void resize(unsigned int size);
+
+    void supplyQuadAttributes();
+
+    //Writes the particle into every array at index.
+    void setParticle(unsigned int index, const Particle& particle);
+
+    //Moves the last live particle into index and shrinks the amount of live particles by one.
+    void removeParticle(unsigned int index);
+
     PARTICLE_TYPE particleType     = PARTICLE_TYPE::Default;
     const Texture* particleTexture = nullptr;
-    std::vector<Particle> particles;
+
+    std::vector<float> lifeTimes;
+    std::vector<float> weights;
+    std::vector<float> sizes;
+    std::vector<float> positionsX;
+    std::vector<float> positionsY;
+    std::vector<float> positionsZ;
+    std::vector<float> speedsX;
+    std::vector<float> speedsY;
+    std::vector<float> speedsZ;
+    std::vector<float> colorsR;
+    std::vector<float> colorsG;
+    std::vector<float> colorsB;
+    std::vector<float> colorsA;
+
+    //Only used on the thread that spawns particles.
+    XorShiftRandom random;
 
     const Settings* currentWorldSettings = nullptr;
 
@@ -84,14 +141,28 @@ private:
     float newparticles              = 0;
     int renderingSize               = 0;
 
-    GLuint vertexArrayObject    = 0;
-    GLuint bufferObject         = 0;
-    GLuint instanceBufferObject = 0;
+    GLuint vertexArrayObject = 0;
+    GLuint bufferObject      = 0;
+
+    //Holds the live particles' instances. A section fits every particle.
+    StreamingBuffer instanceStream;
+
+    //Only used by the GpuParticleSystem. Every frame the particles are read from the current buffer and written into the other.
+    GLuint gpuStateBuffers[2] = {};
+    GLuint gpuUpdateArrays[2] = {};
+    GLuint gpuRenderArrays[2] = {};
+
+    unsigned int currentGpuState = 0;
+
+    //The slot the next spawned particle goes to. Slots are reused in order, so the oldest particles are replaced first.
+    unsigned int gpuSpawnCursor = 0;
 
-    bool initialized = false;
+    bool gpuStateInitialized = false;
+    bool initialized         = false;
 
     friend class DefaultParticleSystem;
     friend class FountainParticleSystem;
+    friend class GpuParticleSystem;
 };
 
 #endif
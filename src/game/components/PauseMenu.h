@@ -8,16 +8,41 @@
 class PauseMenu : public Component<PauseMenu> {
 
 public:
+    ~PauseMenu() {
+        releaseTextures();
+    }
+
     bool showing() const {
         return isShowing;
     }
 
+    //!Takes over the reference getTexture added to textImage.
     void initialize(TextMap& map, Texture& textImage) {
-        str.initialize(map, textImage);
-        resumeButton.initialize(TextureLocator::getService().getTexture("assets/images/gui/pause.png", GL_NEAREST));
+        releaseTextures();
+
+        font        = &textImage;
+        buttonImage = &TextureLocator::getService().getTexture("assets/images/gui/pause.png", GL_NEAREST, false, TEXTURE_LOADING::Synchronous);
+
+        str.initialize(map, *font);
+        resumeButton.initialize(*buttonImage);
     }
 
 private:
+    void releaseTextures() {
+        if (font) {
+            TextureLocator::getService().releaseTexture(font->getHandle());
+        }
+        if (buttonImage) {
+            TextureLocator::getService().releaseTexture(buttonImage->getHandle());
+        }
+
+        font        = nullptr;
+        buttonImage = nullptr;
+    }
+
+    Texture* font        = nullptr;
+    Texture* buttonImage = nullptr;
+
     GuiString str = GuiString(10);
     GuiButton resumeButton;
     bool isShowing = false;
@@ -2,10 +2,17 @@
 #define SKY_BOX_H
 #include "Component.h"
 #include "Cube.h"
+#include "Locator.h"
 
 class SkyBox : public Component<SkyBox> {
 
 public:
+    ~SkyBox() {
+        if (map) {
+            TextureLocator::getService().releaseCubeMap(map->getHandle());
+        }
+    }
+
     CubeShape* getCube() { return &cube; }
     CubeMap* getCubeMap() {
 
@@ -17,7 +24,7 @@ public:
 
 private:
     CubeShape cube;
-    CubeMap* map;
+    CubeMap* map = nullptr;
 };
 
 #endif
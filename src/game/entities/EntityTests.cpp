@@ -228,10 +228,17 @@ void FloorObject::initialize(EntityVitals& vitals) {
 
     collisionMesh.getShape()->setLocalScaling(btVector3(1, 1, 1));
 
+    //The collision mesh is a simplified version of the level, so it is used to occlude the rest of the scene.
+    occluder.initialize(cm);
+
+    //The level never moves, so it is merged into the static geometry batches.
+    model.setStatic(true);
+
     vitals.scene->addComponent(id, floorMaterial);
     vitals.scene->addComponent(id, model);
     vitals.scene->addComponent(id, shader);
     vitals.scene->addComponent(id, collisionMesh);
+    vitals.scene->addComponent(id, occluder);
 }
 
 void LightTest::initialize(EntityVitals& vitals) {
@@ -12,6 +12,7 @@
 #include "GuiString.h"
 #include "Lights.h"
 #include "Material.h"
+#include "Occluder.h"
 #include "Particles.h"
 #include "PauseMenu.h"
 #include "PlayerCameraHandler.h"
@@ -154,6 +155,7 @@ private:
     _3DM::Model model = _3DM::Model("assets/models/scenes/test/testlevel.3DM");
     _3DM::Model cm    = _3DM::Model("assets/models/scenes/test/testlevel-cm.3DM");
     CollisionMesh collisionMesh;
+    Occluder occluder;
     Material floorMaterial;
     Shader shader;
 };
@@ -17,6 +17,9 @@ public:
     const float MIN_SHADOW_INTENSITY = 0.5f;
     const float MAX_SHADOW_INTENSITY = 7;
 
+    const float MIN_TARGET_FRAME_RATE = 20;
+    const float MAX_TARGET_FRAME_RATE = 240;
+
     glm::vec3 getGravity() const { return worldGravity; }
     glm::vec3 getWind() const { return worldWind; }
 
@@ -24,6 +27,10 @@ public:
     unsigned short getShadowFilterAmount() const { return shadowFilteringAmount; }
     float getShadowIntensity() const { return shadowIntesity; }
 
+    //The frame rate the dynamic resolution tries to hold by lowering the resolution and MSAA samples of the scene.
+    float getTargetFrameRate() const { return targetFrameRate; }
+    bool isDynamicResolutionEnabled() const { return dynamicResolution; }
+
     void setWorldWind(glm::vec3 wind) { worldWind = wind; }
     void setWorldGravity(glm::vec3 gravity) { worldGravity = gravity; }
 
@@ -45,10 +52,20 @@ public:
         }
     }
 
+    void setTargetFrameRate(float frameRate) {
+        if (frameRate >= MIN_TARGET_FRAME_RATE && frameRate <= MAX_TARGET_FRAME_RATE) {
+            targetFrameRate = frameRate;
+        }
+    }
+
+    void setDynamicResolution(bool enabled) { dynamicResolution = enabled; }
+
 private:
     unsigned short amountOfLightsPerEntity = 10;
     unsigned short shadowFilteringAmount   = 4;
     float shadowIntesity                   = 1.f;
+    float targetFrameRate                  = 60.f;
+    bool dynamicResolution                 = true;
     glm::vec3 worldWind;
     glm::vec3 worldGravity;
 };
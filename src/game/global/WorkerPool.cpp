@@ -0,0 +1,82 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    jobsQueued.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned int WorkerPool::getAmountOfThreads() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void WorkerPool::run(unsigned int jobs, const std::function<void(unsigned int)>& job) {
+    if (jobs == 0) {
+        return;
+    }
+
+    if (workers.empty()) {
+        startWorkers();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    currentJob     = &job;
+    nextJob        = 0;
+    amountOfJobs   = jobs;
+    unfinishedJobs = jobs;
+
+    jobsQueued.notify_all();
+
+    runJobs(lock);
+
+    //Workers may still be running the last jobs they took.
+    jobsFinished.wait(lock, [this]() { return unfinishedJobs == 0; });
+
+    currentJob = nullptr;
+}
+
+void WorkerPool::startWorkers() {
+    const unsigned int amountOfWorkers = getAmountOfThreads() - 1;
+
+    for (unsigned int i = 0; i < amountOfWorkers; i++) {
+        workers.emplace_back(&WorkerPool::work, this);
+    }
+}
+
+void WorkerPool::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        jobsQueued.wait(lock, [this]() { return stopping || nextJob < amountOfJobs; });
+
+        if (stopping) {
+            return;
+        }
+
+        runJobs(lock);
+    }
+}
+
+void WorkerPool::runJobs(std::unique_lock<std::mutex>& lock) {
+    while (nextJob < amountOfJobs) {
+        const unsigned int index                     = nextJob++;
+        const std::function<void(unsigned int)>& job = *currentJob;
+
+        lock.unlock();
+        job(index);
+        lock.lock();
+
+        if (--unfinishedJobs == 0) {
+            jobsFinished.notify_all();
+        }
+    }
+}
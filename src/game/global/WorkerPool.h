@@ -0,0 +1,58 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!A few threads kept alive to split work that is done every frame, such as updating large particle emitters.
+
+run hands out the indices of its jobs to the workers and to the calling thread, and returns once every job finished,
+so starting a job costs a wake up instead of creating a thread. The workers are started on the first run, one less
+than the hardware threads since the calling thread works too. Only one thread should call run at a time.
+*/
+class WorkerPool {
+
+public:
+    //!Keep in mind that the destructor will join the workers if they were started.
+    WorkerPool() {}
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&)      = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    //!Calls job once with every index from 0 up to (not including) jobs, and waits until every call returned.
+    //!Jobs run at the same time, so they must not write to the same memory.
+    void run(unsigned int jobs, const std::function<void(unsigned int)>& job);
+
+    //!The workers plus the thread that calls run.
+    static unsigned int getAmountOfThreads();
+
+private:
+    void startWorkers();
+    void work();
+
+    //!Runs jobs until none are left to hand out. lock must hold mutex, and holds it again when this returns.
+    void runJobs(std::unique_lock<std::mutex>& lock);
+
+    std::vector<std::thread> workers;
+
+    //!Guards every member below.
+    std::mutex mutex;
+    std::condition_variable jobsQueued;
+    std::condition_variable jobsFinished;
+
+    const std::function<void(unsigned int)>* currentJob = nullptr;
+
+    unsigned int nextJob        = 0;
+    unsigned int amountOfJobs   = 0;
+    unsigned int unfinishedJobs = 0;
+
+    bool stopping = false;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef XOR_SHIFT_RANDOM_H
+#define XOR_SHIFT_RANDOM_H
+#include <stdint.h>
+
+/*!A small xorshift random number generator.
+
+Every owner keeps its own state, so unlike std::rand it can be used from several threads as long as each thread uses
+its own generator. It is fast and good enough for visuals, but should not be used for anything that needs quality randomness.
+*/
+class XorShiftRandom {
+
+public:
+    //!The state can't be 0, so a seed of 0 is replaced.
+    explicit XorShiftRandom(uint32_t seed = 2463534242u) { setSeed(seed); }
+
+    void setSeed(uint32_t seed) { state = seed != 0 ? seed : 2463534242u; }
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    //!Returns a float from 0 (inclusive) to 1 (exclusive).
+    float nextFloat() {
+        //The top 24 bits fit a float's mantissa exactly.
+        return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    //!Returns a float from minInclusive to maxExclusive.
+    float range(float minInclusive, float maxExclusive) {
+        return minInclusive + nextFloat() * (maxExclusive - minInclusive);
+    }
+
+private:
+    uint32_t state;
+};
+
+#endif
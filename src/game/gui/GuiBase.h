@@ -1,13 +1,14 @@
 #ifndef GUI_BASE
 #define GUI_BASE
 
-#include "Shader.h"
+#include "SpriteBatch.h"
 #include <stdint.h>
 
 class GuiBase {
 
 public:
-    virtual void render(Shader& shader) = 0;
+    //!Adds the element to the batch. It is drawn once the batch ends.
+    virtual void render(SpriteBatch& batch) = 0;
 };
 
 #endif
@@ -2,7 +2,6 @@
 #define GUI_SPRITE_H
 
 #include "GuiBase.h"
-#include "Quad.h"
 
 class GuiSprite : public GuiBase {
 
@@ -50,16 +49,11 @@ public:
         position = pos;
     }
 
-    void render(Shader& shader) {
+    void render(SpriteBatch& batch) override {
 
         DBG_CHECK(texture);
 
-        GLboolean currentDepth;
-        glGetBooleanv(GL_DEPTH_WRITEMASK, &currentDepth);
-
-        glDepthMask(GL_FALSE);
-        quad.render3D(shader, *texture, glm::vec4(spriteXStart, spriteYStart, spriteWidth, spriteHeight), position, scale);
-        glDepthMask(currentDepth);
+        batch.draw(*texture, glm::vec4(spriteXStart, spriteYStart, spriteWidth, spriteHeight), position, scale);
     }
 
 protected:
@@ -73,7 +67,6 @@ protected:
     float spriteHeight = 0;
 
     Texture* texture = nullptr;
-    Quad quad;
 };
 
 #endif
@@ -3,58 +3,129 @@
 void GuiString::initialize(TextMap& textMap, Texture& texture) {
     currentTextMap = &textMap;
     currentTexture = &texture;
+    layoutDirty    = true;
 }
 
 GuiString::GuiString(unsigned int capacity, const std::string& string) {
-    characters.resize(capacity);
+    characterCapacity = capacity;
 
     if (!string.empty()) {
         currentString = string;
     }
 }
 
-void GuiString::render(Shader& shader) {
-    mainRender(shader);
+void GuiString::render(SpriteBatch& batch) {
+    mainRender(batch);
 }
 
-void GuiString::render(Shader& shader, const std::string& string) {
-    currentString = string;
-    mainRender(shader);
+void GuiString::render(SpriteBatch& batch, const std::string& string) {
+    setString(string);
+    mainRender(batch);
 }
 
 void GuiString::render(
-    Shader& shader,
+    SpriteBatch& batch,
     const std::string& string,
     int horizontalpad,
     int verticalpad,
     int spacesize,
     const glm::ivec2& position) {
 
-    horizontalPadding = horizontalpad;
-    verticalPadding   = verticalpad;
-    spaceSize         = spacesize;
-    textPosition      = position;
-    currentString     = string;
+    setHorizontalPadding(horizontalpad);
+    setVerticalPadding(verticalpad);
+    setSpaceSize(spacesize);
+    setPosition(glm::vec2(position));
+    setString(string);
 
-    mainRender(shader);
+    mainRender(batch);
 }
 
-void GuiString::render(Shader& shader, const std::string& string, unsigned int newCapacity) {
-    characters.resize(newCapacity);
-    currentString = string;
-    mainRender(shader);
+void GuiString::render(SpriteBatch& batch, const std::string& string, unsigned int newCapacity) {
+    setCapacity(newCapacity);
+    setString(string);
+    mainRender(batch);
 }
 
-void GuiString::render(Shader& shader, int horizontalpad, int verticalpad, int spacesize, const glm::ivec2&) {
+void GuiString::render(SpriteBatch& batch, int horizontalpad, int verticalpad, int spacesize, const glm::ivec2&) {
 
-    horizontalPadding = horizontalpad;
-    verticalPadding   = verticalpad;
-    spaceSize         = spacesize;
+    setHorizontalPadding(horizontalpad);
+    setVerticalPadding(verticalpad);
+    setSpaceSize(spacesize);
 
-    mainRender(shader);
+    mainRender(batch);
 }
 
-void GuiString::mainRender(Shader& shader) {
+void GuiString::setTexture(Texture& texture) {
+    if (currentTexture != &texture) {
+        currentTexture = &texture;
+        layoutDirty    = true;
+    }
+}
+
+void GuiString::setTextMap(TextMap& textmap) {
+    if (currentTextMap != &textmap) {
+        currentTextMap = &textmap;
+        layoutDirty    = true;
+    }
+}
+
+void GuiString::setPosition(const glm::vec2& position) {
+    if (textPosition != position) {
+        textPosition = position;
+        layoutDirty  = true;
+    }
+}
+
+void GuiString::setScale(const glm::vec2& scl) {
+    if (scale != scl) {
+        scale       = scl;
+        layoutDirty = true;
+    }
+}
+
+void GuiString::setString(const std::string& string) {
+    if (currentString != string) {
+        currentString = string;
+        layoutDirty   = true;
+    }
+}
+
+void GuiString::setString(const char* string) {
+    if (currentString.compare(string) != 0) {
+        currentString.assign(string);
+        layoutDirty = true;
+    }
+}
+
+void GuiString::setCapacity(unsigned int capacity) {
+    if (characterCapacity != capacity) {
+        characterCapacity = capacity;
+        layoutDirty       = true;
+    }
+}
+
+void GuiString::setHorizontalPadding(int hPadding) {
+    if (horizontalPadding != hPadding) {
+        horizontalPadding = hPadding;
+        layoutDirty       = true;
+    }
+}
+
+void GuiString::setVerticalPadding(int vPadding) {
+    if (verticalPadding != vPadding) {
+        verticalPadding = vPadding;
+        layoutDirty     = true;
+    }
+}
+
+void GuiString::setSpaceSize(int spacesize) {
+    if (spaceSize != spacesize) {
+        spaceSize   = spacesize;
+        layoutDirty = true;
+    }
+}
+
+void GuiString::mainRender(SpriteBatch& batch) {
     if (!currentTexture) {
         DBG_LOG("Current Font Texture is Null (GuiString::render())\n");
         return;
@@ -64,17 +135,24 @@ void GuiString::mainRender(Shader& shader) {
         return;
     }
 
+    if (layoutDirty) {
+        layout();
+    }
+
+    for (const GlyphQuad& glyphQuad : glyphQuads) {
+        batch.draw(*currentTexture, glyphQuad.spriteOrientation, glyphQuad.position, glyphQuad.scale, distanceField);
+    }
+}
+
+void GuiString::layout() {
     float currentX    = 0;
     float currentY    = 0;
     int indexModifier = 0;
 
     widthOfString = 0;
+    glyphQuads.clear();
 
-    GLboolean currentDepth;
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &currentDepth);
-    glDepthMask(GL_FALSE);
-
-    for (unsigned int i = 0; i < characters.size() && i + indexModifier < currentString.size(); i++) {
+    for (unsigned int i = 0; i < characterCapacity && i + indexModifier < currentString.size(); i++) {
 
         const char currentChar = currentString.at(i + indexModifier);
 
@@ -93,10 +171,14 @@ void GuiString::mainRender(Shader& shader) {
         } else {
             if (currentGlyph) {
 
-                characters[i].xPosition = textPosition.x + currentX * 2 + currentGlyph->getWidth() * scale.x;
-                characters[i].yPosition = textPosition.y + currentY * 2 - currentGlyph->getHeight() * scale.y;
+                GlyphQuad glyphQuad;
+                glyphQuad.spriteOrientation = glm::vec4(currentGlyph->x, currentGlyph->y, currentGlyph->getWidth(), currentGlyph->getHeight());
+                glyphQuad.position          = glm::vec2(
+                    textPosition.x + currentX * 2 + currentGlyph->getWidth() * scale.x,
+                    textPosition.y + currentY * 2 - currentGlyph->getHeight() * scale.y);
+                glyphQuad.scale = glm::vec2(currentGlyph->getWidth() * scale.x, currentGlyph->getHeight() * scale.y);
 
-                characters[i].render(shader, *currentTexture, *currentGlyph, scale);
+                glyphQuads.push_back(glyphQuad);
                 currentX += currentGlyph->getWidth() * scale.x + horizontalPadding;
             }
         }
@@ -106,5 +188,5 @@ void GuiString::mainRender(Shader& shader) {
         }
     }
 
-    glDepthMask(currentDepth);
+    layoutDirty = false;
 }
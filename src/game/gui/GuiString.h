@@ -1,7 +1,6 @@
 #ifndef GUI_STRING_H
 #define GUI_STRING_H
 #include "GuiBase.h"
-#include "GuiTextCharacter.h"
 #include "TextMap.h"
 #include <glm/vec2.hpp>
 #include <string>
@@ -14,34 +13,39 @@ public:
 
     GuiString(unsigned int capacity = 5, const std::string& string = "");
 
-    void render(Shader& shader);
-    void render(Shader& shader, const std::string& string);
-    void render(Shader& shader, const std::string& string, unsigned int newCapacity);
+    void render(SpriteBatch& batch) override;
+    void render(SpriteBatch& batch, const std::string& string);
+    void render(SpriteBatch& batch, const std::string& string, unsigned int newCapacity);
 
     void render(
-        Shader& shader,
+        SpriteBatch& batch,
         int horizontalpad,
         int verticalpad   = 1,
         int spacesize     = 8,
         const glm::ivec2& = glm::ivec2(0));
 
     void render(
-        Shader& shader,
+        SpriteBatch& batch,
         const std::string& string,
         int horizontalpad,
         int verticalpad            = 1,
         int spacesize              = 8,
         const glm::ivec2& position = glm::ivec2(0));
 
-    void setTexture(Texture& texture) { currentTexture = &texture; }
-    void setTextMap(TextMap& textmap) { currentTextMap = &textmap; }
-    void setPosition(const glm::vec2& position) { textPosition = position; }
-    void setScale(const glm::vec2& scl) { scale = scl; }
-    void setString(const std::string& string) { currentString = string; }
-    void setCapacity(unsigned int capacity) { characters.resize(capacity); }
-    void setHorizontalPadding(int hPadding = 2) { horizontalPadding = hPadding; }
-    void setVerticalPadding(int vPadding = 1) { verticalPadding = vPadding; }
-    void setSpaceSize(int spacesize = 8) { spaceSize = spacesize; }
+    //!Every setter only marks the layout dirty if the value changed, so setting the same values every frame is cheap.
+    void setTexture(Texture& texture);
+    void setTextMap(TextMap& textmap);
+    void setPosition(const glm::vec2& position);
+    void setScale(const glm::vec2& scl);
+    void setString(const std::string& string);
+    //!Copies string into the existing storage, so it doesn't allocate once the string has grown to its longest.
+    void setString(const char* string);
+    void setCapacity(unsigned int capacity);
+    void setHorizontalPadding(int hPadding = 2);
+    void setVerticalPadding(int vPadding = 1);
+    void setSpaceSize(int spacesize = 8);
+    //!Set to true if the texture is a signed distance field atlas, see SdfFont.h. The sprite batch then draws it with its distance field shader.
+    void setDistanceField(bool isDistanceField) { distanceField = isDistanceField; }
 
     const std::string* const getString() {
         return &currentString;
@@ -59,6 +63,8 @@ public:
         return spaceSize;
     }
 
+    bool isDistanceField() const { return distanceField; }
+
     const glm::ivec2 getPosition() const {
         return textPosition;
     }
@@ -70,7 +76,17 @@ public:
     float getWidthOfString() const { return widthOfString; }
 
 private:
-    void mainRender(Shader& shader);
+    //!A glyph quad, positioned and scaled in pixels.
+    struct GlyphQuad {
+        glm::vec4 spriteOrientation;
+        glm::vec2 position;
+        glm::vec2 scale;
+    };
+
+    void mainRender(SpriteBatch& batch);
+
+    //!Lays out every glyph of the string into glyphQuads and measures the string.
+    void layout();
 
     float widthOfString = 0;
 
@@ -84,8 +100,16 @@ private:
     Texture* currentTexture = nullptr;
     TextMap* currentTextMap = nullptr;
 
+    bool distanceField = false;
+
     std::string currentString;
-    std::vector<GuiTextCharacter> characters;
+
+    //!The most characters that are drawn, spaces and new lines aren't counted.
+    unsigned int characterCapacity = 0;
+
+    //!The laid out string. Only rebuilt when the layout is dirty.
+    std::vector<GlyphQuad> glyphQuads;
+    bool layoutDirty = true;
 };
 
 #endif // !GUI_STRING_H
@@ -0,0 +1,238 @@
+#include "SdfFont.h"
+#include "Serialization.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    const float INFINITE_DISTANCE = 1e20f;
+
+    //Felzenszwalb and Huttenlocher's squared distance transform of a single row or column.
+    //f holds 0 for the pixels distances are measured to and INFINITE_DISTANCE for every other pixel.
+    void distanceTransform(const std::vector<float>& f, std::vector<float>& d, std::vector<int>& v, std::vector<float>& z, int n) {
+        int k = 0;
+        v[0]  = 0;
+        z[0]  = -INFINITE_DISTANCE;
+        z[1]  = INFINITE_DISTANCE;
+
+        for (int q = 1; q < n; q++) {
+            float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+
+            while (s <= z[k]) {
+                k--;
+                s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            }
+
+            k++;
+            v[k]     = q;
+            z[k]     = s;
+            z[k + 1] = INFINITE_DISTANCE;
+        }
+
+        k = 0;
+        for (int q = 0; q < n; q++) {
+            while (z[k + 1] < q) {
+                k++;
+            }
+
+            d[q] = static_cast<float>((q - v[k]) * (q - v[k])) + f[v[k]];
+        }
+    }
+
+    //Returns the squared distance of every pixel to the nearest pixel whose inside state equals target.
+    std::vector<float> squaredDistancesTo(const SdfFont::Image& coverage, bool target) {
+        const int width   = static_cast<int>(coverage.width);
+        const int height  = static_cast<int>(coverage.height);
+        const int longest = std::max(width, height);
+
+        std::vector<float> grid(coverage.pixels.size());
+        for (size_t i = 0; i < grid.size(); i++) {
+            grid[i] = (coverage.pixels[i] >= 128) == target ? 0.0f : INFINITE_DISTANCE;
+        }
+
+        std::vector<float> f(longest);
+        std::vector<float> d(longest);
+        std::vector<int> v(longest);
+        std::vector<float> z(longest + 1);
+
+        for (int x = 0; x < width; x++) {
+            for (int y = 0; y < height; y++) {
+                f[y] = grid[y * width + x];
+            }
+
+            distanceTransform(f, d, v, z, height);
+
+            for (int y = 0; y < height; y++) {
+                grid[y * width + x] = d[y];
+            }
+        }
+
+        for (int y = 0; y < height; y++) {
+            std::copy(grid.begin() + y * width, grid.begin() + (y + 1) * width, f.begin());
+
+            distanceTransform(f, d, v, z, width);
+
+            std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+        }
+
+        return grid;
+    }
+
+    uint32_t nextPowerOfTwo(uint32_t value) {
+        uint32_t powerOfTwo = 1;
+        while (powerOfTwo < value) {
+            powerOfTwo <<= 1;
+        }
+
+        return powerOfTwo;
+    }
+}
+
+std::vector<float> SdfFont::computeSignedDistances(const Image& coverage) {
+    const std::vector<float> toInside  = squaredDistancesTo(coverage, true);
+    const std::vector<float> toOutside = squaredDistancesTo(coverage, false);
+
+    std::vector<float> distances(coverage.pixels.size());
+
+    //The edge lies half a pixel away from the centers of the pixels on either side of it.
+    for (size_t i = 0; i < distances.size(); i++) {
+        if (coverage.pixels[i] >= 128) {
+            distances[i] = std::sqrt(toOutside[i]) - 0.5f;
+        } else {
+            distances[i] = 0.5f - std::sqrt(toInside[i]);
+        }
+    }
+
+    return distances;
+}
+
+SdfFont::Image SdfFont::buildAtlas(const Image& coverage, const std::vector<Glyph>& glyphs, const AtlasSettings& settings, std::vector<Glyph>& outGlyphs) {
+    const uint32_t downscale     = std::max(settings.downscale, 1u);
+    const uint32_t spread        = std::max(settings.spread, 1u);
+    const uint32_t sourcePadding = spread * downscale;
+
+    //Glyphs are packed in rows, every glyph keeps spread pixels of padding so the fields don't bleed into each other.
+    struct Cell {
+        uint32_t x      = 0;
+        uint32_t y      = 0;
+        uint32_t width  = 0;
+        uint32_t height = 0;
+    };
+
+    std::vector<Cell> cells(glyphs.size());
+
+    uint32_t cursorX   = 0;
+    uint32_t cursorY   = 0;
+    uint32_t rowHeight = 0;
+
+    for (size_t i = 0; i < glyphs.size(); i++) {
+        Cell& cell  = cells[i];
+        cell.width  = (glyphs[i].getWidth() + downscale - 1) / downscale;
+        cell.height = (glyphs[i].getHeight() + downscale - 1) / downscale;
+
+        const uint32_t paddedWidth  = cell.width + 2 * spread;
+        const uint32_t paddedHeight = cell.height + 2 * spread;
+
+        if (cursorX + paddedWidth > settings.atlasWidth) {
+            cursorX = 0;
+            cursorY += rowHeight;
+            rowHeight = 0;
+        }
+
+        cell.x = cursorX + spread;
+        cell.y = cursorY + spread;
+
+        cursorX += paddedWidth;
+        rowHeight = std::max(rowHeight, paddedHeight);
+    }
+
+    Image atlas;
+    atlas.width  = settings.atlasWidth;
+    atlas.height = nextPowerOfTwo(cursorY + rowHeight);
+    atlas.pixels.assign(atlas.width * atlas.height, 0);
+
+    outGlyphs.resize(glyphs.size());
+
+    for (size_t i = 0; i < glyphs.size(); i++) {
+        const Glyph& glyph = glyphs[i];
+        const Cell& cell   = cells[i];
+
+        //Only the glyph's own rectangle is copied, with empty padding, so neighbouring glyphs in the source don't leak in.
+        Image source;
+        source.width  = glyph.getWidth() + 2 * sourcePadding;
+        source.height = glyph.getHeight() + 2 * sourcePadding;
+        source.pixels.assign(source.width * source.height, 0);
+
+        const uint32_t sourceTop = coverage.height - glyph.yMax;
+
+        for (uint32_t y = 0; y < glyph.getHeight(); y++) {
+            for (uint32_t x = 0; x < glyph.getWidth(); x++) {
+                const uint32_t sourceX = glyph.x + x;
+                const uint32_t sourceY = sourceTop + y;
+
+                if (sourceX < coverage.width && sourceY < coverage.height) {
+                    source.pixels[(y + sourcePadding) * source.width + x + sourcePadding] = coverage.pixels[sourceY * coverage.width + sourceX];
+                }
+            }
+        }
+
+        const std::vector<float> distances = computeSignedDistances(source);
+
+        const uint32_t paddedWidth  = cell.width + 2 * spread;
+        const uint32_t paddedHeight = cell.height + 2 * spread;
+
+        for (uint32_t y = 0; y < paddedHeight; y++) {
+            for (uint32_t x = 0; x < paddedWidth; x++) {
+                const uint32_t sourceX = std::min(x * downscale + downscale / 2, source.width - 1);
+                const uint32_t sourceY = std::min(y * downscale + downscale / 2, source.height - 1);
+
+                const float distance = distances[sourceY * source.width + sourceX] / downscale;
+                const float value    = std::min(std::max(0.5f + distance / (2.0f * spread), 0.0f), 1.0f);
+
+                const uint32_t atlasX = cell.x - spread + x;
+                const uint32_t atlasY = cell.y - spread + y;
+
+                atlas.pixels[atlasY * atlas.width + atlasX] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+            }
+        }
+
+        Glyph& outGlyph    = outGlyphs[i];
+        outGlyph.character = glyph.character;
+        outGlyph.x         = cell.x;
+        outGlyph.xMax      = cell.x + cell.width - 1;
+        outGlyph.y         = atlas.height - (cell.y + cell.height);
+        outGlyph.yMax      = atlas.height - cell.y;
+    }
+
+    return atlas;
+}
+
+bool SdfFont::writeFontDat(const std::string& fontDatLocation, const std::vector<Glyph>& glyphs) {
+    std::ofstream outputFileStream(fontDatLocation.c_str(), std::ios::out | std::ios::binary);
+
+    if (!outputFileStream) {
+        return false;
+    }
+
+    const bool swapEndianness = Serialization::isBigEndian();
+
+    uint32_t sizeOfMap = static_cast<uint32_t>(glyphs.size());
+    Serialization::writeBytes(sizeOfMap, 4, outputFileStream);
+
+    for (Glyph glyph : glyphs) {
+        if (swapEndianness) {
+            Serialization::swapEndian(&glyph.x);
+            Serialization::swapEndian(&glyph.xMax);
+            Serialization::swapEndian(&glyph.y);
+            Serialization::swapEndian(&glyph.yMax);
+        }
+
+        Serialization::writeBytes(glyph.x, 4, outputFileStream);
+        Serialization::writeBytes(glyph.xMax, 4, outputFileStream);
+        Serialization::writeBytes(glyph.y, 4, outputFileStream);
+        Serialization::writeBytes(glyph.yMax, 4, outputFileStream);
+        Serialization::writeBytes(glyph.character, 1, outputFileStream);
+    }
+
+    return static_cast<bool>(outputFileStream);
+}
@@ -0,0 +1,46 @@
+#ifndef SDF_FONT_H
+#define SDF_FONT_H
+
+#include "Glyph.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!Builds signed distance field font atlases from bitmap atlases.
+
+Every texel of a distance field atlas holds the distance to the nearest glyph edge, 128 being the edge itself and
+higher values being inside the glyph. gui-sdf.frag rebuilds a sharp edge from it at any scale, so one small atlas
+replaces an atlas per text size. Used by the sdf_font_tool, see tools/sdf-font.
+*/
+namespace SdfFont {
+
+    //!An 8 bit image, rows are stored from the top.
+    struct Image {
+        uint32_t width  = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    struct AtlasSettings {
+        //!How far from an edge the distance is stored, in atlas pixels. Also the padding around every glyph.
+        uint32_t spread = 4;
+
+        //!The source atlas is this many times bigger than the generated one.
+        uint32_t downscale = 1;
+
+        //!Should be a power of two. The height is the smallest power of two that fits every glyph.
+        uint32_t atlasWidth = 256;
+    };
+
+    //!Returns the distance of every pixel to the nearest edge, in pixels. Pixels with a coverage of 128 or more are inside, and positive.
+    std::vector<float> computeSignedDistances(const Image& coverage);
+
+    //!Builds a distance field atlas from a bitmap atlas and its glyphs. outGlyphs are the glyphs' rectangles in the new atlas.
+    //!Glyph rectangles follow the FontDat convention: y is measured from the bottom of the atlas.
+    Image buildAtlas(const Image& coverage, const std::vector<Glyph>& glyphs, const AtlasSettings& settings, std::vector<Glyph>& outGlyphs);
+
+    //!Writes the glyphs in the format TextMap::createMap reads. Returns false if the file can't be written.
+    bool writeFontDat(const std::string& fontDatLocation, const std::vector<Glyph>& glyphs);
+}
+
+#endif
@@ -1,25 +1,5 @@
 #include "TextMap.h"
 
-const Glyph* const TextMap::getGlyph(const char& key) {
-    unsigned int mid   = 0;
-    unsigned int left  = 0;
-    unsigned int right = map.size();
-
-    while (left < right) {
-        mid = left + (right - left) / 2;
-
-        if (key > map.at(mid).character) {
-            left = mid + 1;
-        } else if (key < map.at(mid).character) {
-            right = mid;
-        } else {
-            return &map.at(mid);
-        }
-    }
-
-    return nullptr;
-}
-
 void TextMap::createMap(const std::string& textDatLocation) {
     isBigEndianness = Serialization::isBigEndian();
 
@@ -53,4 +33,10 @@ void TextMap::createMap(const std::string& textDatLocation) {
         {
             return a.character < b.character;
         });
+
+    glyphIndices.fill(-1);
+
+    for (uint32_t i = 0; i < map.size(); i++) {
+        glyphIndices[static_cast<unsigned char>(map[i].character)] = static_cast<int32_t>(i);
+    }
 }
@@ -3,14 +3,24 @@
 #include "Glyph.h"
 #include "Serialization.h"
 #include "Texture.h"
+#include <array>
 #include <vector>
 
 class TextMap {
 
 public:
+    TextMap() { glyphIndices.fill(-1); }
+
     void createMap(const std::string& textDatMapLocation);
 
-    const Glyph* const getGlyph(const char& key);
+    //!Returns nullptr if the map has no glyph for key.
+    const Glyph* const getGlyph(const char& key) const {
+        const int32_t index = glyphIndices[static_cast<unsigned char>(key)];
+        return index >= 0 ? &map[index] : nullptr;
+    }
+
+    //!Every glyph of the map, sorted by character.
+    const std::vector<Glyph>& getGlyphs() const { return map; }
 
     uint32_t getMaxPixelHeightOfAllGlyphs() {
         return maxPixelHeight;
@@ -22,6 +32,9 @@ private:
     uint32_t maxPixelHeight = 0;
 
     std::vector<Glyph> map;
+
+    //!Index of every character's glyph in map, or -1. Indices are stored instead of pointers so copies of the map stay valid.
+    std::array<int32_t, 256> glyphIndices;
 };
 
 #endif // !TEXT_MAP_H
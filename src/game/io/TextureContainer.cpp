@@ -0,0 +1,423 @@
+#include "TextureContainer.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace {
+
+    const uint32_t HEADER_SIZE      = 16;
+    const uint32_t LEVEL_ENTRY_SIZE = 12;
+
+    //The file is always little endian, bytes are composed by hand so it doesn't matter what the system is.
+    void appendUint32(std::vector<uint8_t>& bytes, uint32_t value) {
+        bytes.push_back(static_cast<uint8_t>(value));
+        bytes.push_back(static_cast<uint8_t>(value >> 8));
+        bytes.push_back(static_cast<uint8_t>(value >> 16));
+        bytes.push_back(static_cast<uint8_t>(value >> 24));
+    }
+
+    uint32_t readUint32(const uint8_t* bytes) {
+        return static_cast<uint32_t>(bytes[0])
+            | static_cast<uint32_t>(bytes[1]) << 8
+            | static_cast<uint32_t>(bytes[2]) << 16
+            | static_cast<uint32_t>(bytes[3]) << 24;
+    }
+
+    uint16_t toRgb565(const float color[3]) {
+        const uint32_t r = static_cast<uint32_t>(std::min(std::max(color[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+        const uint32_t g = static_cast<uint32_t>(std::min(std::max(color[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+        const uint32_t b = static_cast<uint32_t>(std::min(std::max(color[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+
+        return static_cast<uint16_t>(r << 11 | g << 5 | b);
+    }
+
+    void fromRgb565(uint16_t packed, int color[3]) {
+        const int r = packed >> 11 & 31;
+        const int g = packed >> 5 & 63;
+        const int b = packed & 31;
+
+        color[0] = r << 3 | r >> 2;
+        color[1] = g << 2 | g >> 4;
+        color[2] = b << 3 | b >> 2;
+    }
+
+    //Endpoints are the extremes of the block's colors along their principal axis, pulled in slightly since the
+    //palette's end points are rarely hit exactly.
+    void compressColorBlock(const uint8_t rgbaBlock[64], uint8_t* output) {
+        float mean[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 3; c++) {
+                mean[c] += rgbaBlock[i * 4 + c] / 16.0f;
+            }
+        }
+
+        float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; i++) {
+            const float r = rgbaBlock[i * 4 + 0] - mean[0];
+            const float g = rgbaBlock[i * 4 + 1] - mean[1];
+            const float b = rgbaBlock[i * 4 + 2] - mean[2];
+
+            covariance[0] += r * r;
+            covariance[1] += r * g;
+            covariance[2] += r * b;
+            covariance[3] += g * g;
+            covariance[4] += g * b;
+            covariance[5] += b * b;
+        }
+
+        float axis[3] = { 1.0f, 1.0f, 1.0f };
+        for (int iteration = 0; iteration < 8; iteration++) {
+            const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+            const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+            const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+
+            const float longest = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+            if (longest <= 0.0f) {
+                break;
+            }
+
+            axis[0] = x / longest;
+            axis[1] = y / longest;
+            axis[2] = z / longest;
+        }
+
+        float minProjection = 1e20f;
+        float maxProjection = -1e20f;
+        for (int i = 0; i < 16; i++) {
+            const float projection = (rgbaBlock[i * 4 + 0] - mean[0]) * axis[0]
+                + (rgbaBlock[i * 4 + 1] - mean[1]) * axis[1]
+                + (rgbaBlock[i * 4 + 2] - mean[2]) * axis[2];
+
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        const float inset = (maxProjection - minProjection) / 16.0f;
+        minProjection += inset;
+        maxProjection -= inset;
+
+        float high[3];
+        float low[3];
+        for (int c = 0; c < 3; c++) {
+            high[c] = mean[c] + axis[c] * maxProjection;
+            low[c]  = mean[c] + axis[c] * minProjection;
+        }
+
+        uint16_t color0 = toRgb565(high);
+        uint16_t color1 = toRgb565(low);
+
+        //color0 > color1 selects the four color mode, the three color mode would make index 3 transparent black.
+        if (color0 < color1) {
+            std::swap(color0, color1);
+        }
+
+        uint32_t indices = 0;
+
+        if (color0 != color1) {
+            int palette[4][3];
+            fromRgb565(color0, palette[0]);
+            fromRgb565(color1, palette[1]);
+
+            for (int c = 0; c < 3; c++) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            for (int i = 0; i < 16; i++) {
+                int closest         = 0;
+                int closestDistance = 0x7fffffff;
+
+                for (int p = 0; p < 4; p++) {
+                    int distance = 0;
+                    for (int c = 0; c < 3; c++) {
+                        const int difference = rgbaBlock[i * 4 + c] - palette[p][c];
+                        distance += difference * difference;
+                    }
+
+                    if (distance < closestDistance) {
+                        closest         = p;
+                        closestDistance = distance;
+                    }
+                }
+
+                indices |= static_cast<uint32_t>(closest) << (i * 2);
+            }
+        }
+
+        output[0] = static_cast<uint8_t>(color0);
+        output[1] = static_cast<uint8_t>(color0 >> 8);
+        output[2] = static_cast<uint8_t>(color1);
+        output[3] = static_cast<uint8_t>(color1 >> 8);
+        output[4] = static_cast<uint8_t>(indices);
+        output[5] = static_cast<uint8_t>(indices >> 8);
+        output[6] = static_cast<uint8_t>(indices >> 16);
+        output[7] = static_cast<uint8_t>(indices >> 24);
+    }
+
+    //BC4, used for BC3's alpha and both of BC5's channels.
+    void compressChannelBlock(const uint8_t rgbaBlock[64], int channel, uint8_t* output) {
+        int high = 0;
+        int low  = 255;
+        for (int i = 0; i < 16; i++) {
+            high = std::max(high, static_cast<int>(rgbaBlock[i * 4 + channel]));
+            low  = std::min(low, static_cast<int>(rgbaBlock[i * 4 + channel]));
+        }
+
+        uint64_t indices = 0;
+
+        //high > low selects the eight value mode.
+        if (high != low) {
+            int palette[8];
+            palette[0] = high;
+            palette[1] = low;
+            for (int p = 2; p < 8; p++) {
+                palette[p] = ((8 - p) * high + (p - 1) * low) / 7;
+            }
+
+            for (int i = 0; i < 16; i++) {
+                const int value = rgbaBlock[i * 4 + channel];
+
+                int closest         = 0;
+                int closestDistance = 256;
+
+                for (int p = 0; p < 8; p++) {
+                    const int distance = std::abs(value - palette[p]);
+
+                    if (distance < closestDistance) {
+                        closest         = p;
+                        closestDistance = distance;
+                    }
+                }
+
+                indices |= static_cast<uint64_t>(closest) << (i * 3);
+            }
+        }
+
+        output[0] = static_cast<uint8_t>(high);
+        output[1] = static_cast<uint8_t>(low);
+        for (int i = 0; i < 6; i++) {
+            output[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+        }
+    }
+
+    uint32_t getBlockSize(TextureContainer::FORMAT format) {
+        return format == TextureContainer::FORMAT::BC1 ? 8 : 16;
+    }
+}
+
+std::string TextureContainer::getCookedLocation(const std::string& imageLocation) {
+    const size_t extension = imageLocation.find_last_of('.');
+    const size_t directory = imageLocation.find_last_of("/\\");
+
+    if (extension == std::string::npos || (directory != std::string::npos && extension < directory)) {
+        return imageLocation + ".ltex";
+    }
+
+    return imageLocation.substr(0, extension) + ".ltex";
+}
+
+bool TextureContainer::isCompressed(FORMAT format) {
+    return format != FORMAT::RGBA8;
+}
+
+uint32_t TextureContainer::getLevelSize(FORMAT format, uint32_t width, uint32_t height) {
+    if (!isCompressed(format)) {
+        return width * height * 4;
+    }
+
+    return std::max((width + 3) / 4, 1u) * std::max((height + 3) / 4, 1u) * getBlockSize(format);
+}
+
+std::vector<uint8_t> TextureContainer::downsample(const std::vector<uint8_t>& rgbaPixels, uint32_t width, uint32_t height) {
+    const uint32_t nextWidth  = std::max(width / 2, 1u);
+    const uint32_t nextHeight = std::max(height / 2, 1u);
+
+    std::vector<uint8_t> next(nextWidth * nextHeight * 4);
+
+    for (uint32_t y = 0; y < nextHeight; y++) {
+        for (uint32_t x = 0; x < nextWidth; x++) {
+            float color[3] = { 0.0f, 0.0f, 0.0f };
+            float alpha    = 0.0f;
+
+            for (uint32_t sample = 0; sample < 4; sample++) {
+                const uint32_t sourceX = std::min(x * 2 + (sample & 1), width - 1);
+                const uint32_t sourceY = std::min(y * 2 + (sample >> 1), height - 1);
+                const uint8_t* pixel   = &rgbaPixels[(sourceY * width + sourceX) * 4];
+
+                //Colors are weighted by alpha, so transparent pixels don't bleed their color into the edges.
+                for (int c = 0; c < 3; c++) {
+                    color[c] += pixel[c] * (pixel[3] / 255.0f);
+                }
+                alpha += pixel[3] / 255.0f;
+            }
+
+            uint8_t* output = &next[(y * nextWidth + x) * 4];
+
+            for (int c = 0; c < 3; c++) {
+                output[c] = alpha > 0.0f ? static_cast<uint8_t>(color[c] / alpha + 0.5f) : 0;
+            }
+            output[3] = static_cast<uint8_t>(alpha / 4.0f * 255.0f + 0.5f);
+        }
+    }
+
+    return next;
+}
+
+void TextureContainer::compressBlock(const uint8_t rgbaBlock[64], FORMAT format, uint8_t* output) {
+    switch (format) {
+    case FORMAT::BC1:
+        compressColorBlock(rgbaBlock, output);
+        break;
+    case FORMAT::BC3:
+        compressChannelBlock(rgbaBlock, 3, output);
+        compressColorBlock(rgbaBlock, output + 8);
+        break;
+    case FORMAT::BC5:
+        compressChannelBlock(rgbaBlock, 0, output);
+        compressChannelBlock(rgbaBlock, 1, output + 8);
+        break;
+    case FORMAT::RGBA8:
+        break;
+    }
+}
+
+TextureContainer::CookedTexture TextureContainer::cook(const uint8_t* rgbaPixels, uint32_t width, uint32_t height, const CookSettings& settings) {
+    CookedTexture texture;
+    texture.format = settings.format;
+
+    std::vector<uint8_t> level(rgbaPixels, rgbaPixels + width * height * 4);
+
+    while (true) {
+        Level entry;
+        entry.width  = width;
+        entry.height = height;
+        entry.offset = static_cast<uint32_t>(texture.data.size());
+        entry.size   = getLevelSize(settings.format, width, height);
+
+        texture.data.resize(entry.offset + entry.size);
+        uint8_t* output = &texture.data[entry.offset];
+
+        if (!isCompressed(settings.format)) {
+            std::copy(level.begin(), level.end(), output);
+        } else {
+            const uint32_t blockSize = getBlockSize(settings.format);
+
+            //Blocks hanging over the edge repeat the last row and column.
+            for (uint32_t blockY = 0; blockY < height; blockY += 4) {
+                for (uint32_t blockX = 0; blockX < width; blockX += 4) {
+                    uint8_t block[64];
+
+                    for (uint32_t i = 0; i < 16; i++) {
+                        const uint32_t x = std::min(blockX + i % 4, width - 1);
+                        const uint32_t y = std::min(blockY + i / 4, height - 1);
+
+                        std::copy(&level[(y * width + x) * 4], &level[(y * width + x) * 4] + 4, &block[i * 4]);
+                    }
+
+                    compressBlock(block, settings.format, output);
+                    output += blockSize;
+                }
+            }
+        }
+
+        texture.levels.push_back(entry);
+
+        if (!settings.generateMips || (width == 1 && height == 1)) {
+            break;
+        }
+
+        level  = downsample(level, width, height);
+        width  = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+
+    return texture;
+}
+
+bool TextureContainer::write(const std::string& location, const CookedTexture& texture) {
+    std::vector<uint8_t> bytes;
+    bytes.reserve(HEADER_SIZE + texture.levels.size() * LEVEL_ENTRY_SIZE + texture.data.size());
+
+    appendUint32(bytes, MAGIC);
+    appendUint32(bytes, VERSION);
+    appendUint32(bytes, static_cast<uint32_t>(texture.format));
+    appendUint32(bytes, static_cast<uint32_t>(texture.levels.size()));
+
+    for (const Level& level : texture.levels) {
+        appendUint32(bytes, level.width);
+        appendUint32(bytes, level.height);
+        appendUint32(bytes, level.size);
+    }
+
+    for (const Level& level : texture.levels) {
+        bytes.insert(bytes.end(), texture.data.begin() + level.offset, texture.data.begin() + level.offset + level.size);
+    }
+
+    std::ofstream outputFileStream(location.c_str(), std::ios::out | std::ios::binary);
+
+    if (!outputFileStream) {
+        return false;
+    }
+
+    outputFileStream.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+    return static_cast<bool>(outputFileStream);
+}
+
+bool TextureContainer::read(const std::string& location, CookedTexture& texture) {
+    std::ifstream inputFileStream(location.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+
+    if (!inputFileStream) {
+        return false;
+    }
+
+    const std::streamoff fileSize = inputFileStream.tellg();
+    if (fileSize < HEADER_SIZE) {
+        return false;
+    }
+
+    //The levels are left in place, so the file is read with a single call and never copied.
+    texture.data.resize(static_cast<size_t>(fileSize));
+    inputFileStream.seekg(0);
+    inputFileStream.read(reinterpret_cast<char*>(texture.data.data()), fileSize);
+
+    if (!inputFileStream) {
+        return false;
+    }
+
+    const uint8_t* bytes = texture.data.data();
+
+    if (readUint32(bytes) != MAGIC || readUint32(bytes + 4) != VERSION) {
+        return false;
+    }
+
+    const uint32_t format       = readUint32(bytes + 8);
+    const uint32_t amountLevels = readUint32(bytes + 12);
+
+    if (format > static_cast<uint32_t>(FORMAT::BC5) || amountLevels == 0 || HEADER_SIZE + static_cast<uint64_t>(amountLevels) * LEVEL_ENTRY_SIZE > texture.data.size()) {
+        return false;
+    }
+
+    texture.format = static_cast<FORMAT>(format);
+    texture.levels.resize(amountLevels);
+
+    uint64_t offset = HEADER_SIZE + amountLevels * LEVEL_ENTRY_SIZE;
+
+    for (uint32_t i = 0; i < amountLevels; i++) {
+        const uint8_t* entry = bytes + HEADER_SIZE + i * LEVEL_ENTRY_SIZE;
+
+        Level& level = texture.levels[i];
+        level.width  = readUint32(entry);
+        level.height = readUint32(entry + 4);
+        level.size   = readUint32(entry + 8);
+        level.offset = static_cast<uint32_t>(offset);
+
+        if (level.size != getLevelSize(texture.format, level.width, level.height) || offset + level.size > texture.data.size()) {
+            return false;
+        }
+
+        offset += level.size;
+    }
+
+    return true;
+}
@@ -0,0 +1,83 @@
+#ifndef TEXTURE_CONTAINER_H
+#define TEXTURE_CONTAINER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!Cooked textures, made offline by the texture_cooker from pngs, see tools/texture-cooker.
+
+A cooked texture (.ltex) holds every mip level of a texture, already filtered and, unless it was cooked uncompressed,
+block compressed in the format the GPU samples from. Loading one is a single file read and one upload per level,
+with no decoding or glGenerateMipmap at runtime.
+
+Layout, little endian: the header, a level table, then the levels' data from the biggest level to the smallest.
+*/
+namespace TextureContainer {
+
+    enum class FORMAT : uint32_t {
+        //!Uncompressed, 4 bytes per pixel.
+        RGBA8 = 0,
+        //!4 bits per pixel, opaque color.
+        BC1 = 1,
+        //!8 bits per pixel, color with a smooth alpha.
+        BC3 = 2,
+        //!8 bits per pixel, two independent channels. Used for tangent space normal maps.
+        BC5 = 3
+    };
+
+    const uint32_t MAGIC   = 0x5845544c; //"LTEX"
+    const uint32_t VERSION = 1;
+
+    struct Level {
+        uint32_t width  = 0;
+        uint32_t height = 0;
+
+        //!Offset of the level in CookedTexture::data.
+        uint32_t offset = 0;
+        uint32_t size   = 0;
+    };
+
+    struct CookedTexture {
+        FORMAT format = FORMAT::RGBA8;
+        std::vector<Level> levels;
+
+        //!Every level's data, back to back.
+        std::vector<uint8_t> data;
+
+        uint32_t getWidth() const { return levels.empty() ? 0 : levels.front().width; }
+        uint32_t getHeight() const { return levels.empty() ? 0 : levels.front().height; }
+    };
+
+    struct CookSettings {
+        FORMAT format = FORMAT::BC1;
+
+        //!If false only the full sized level is stored.
+        bool generateMips = true;
+    };
+
+    //!Returns where the cooked version of an image is expected. IE assets/images/a.png becomes assets/images/a.ltex
+    std::string getCookedLocation(const std::string& imageLocation);
+
+    bool isCompressed(FORMAT format);
+
+    //!Returns the size in bytes of a level of format.
+    uint32_t getLevelSize(FORMAT format, uint32_t width, uint32_t height);
+
+    //!Cooks a texture from RGBA8 pixels, rows stored from the top.
+    CookedTexture cook(const uint8_t* rgbaPixels, uint32_t width, uint32_t height, const CookSettings& settings);
+
+    //!Returns the next mip level of an RGBA8 image, each pixel being the average of up to four pixels of the previous one.
+    std::vector<uint8_t> downsample(const std::vector<uint8_t>& rgbaPixels, uint32_t width, uint32_t height);
+
+    //!Compresses one 4x4 block of RGBA8 pixels, rows stored from the top. Writes 8 bytes for BC1 and 16 for BC3 and BC5.
+    void compressBlock(const uint8_t rgbaBlock[64], FORMAT format, uint8_t* output);
+
+    //!Returns false if the file can't be written.
+    bool write(const std::string& location, const CookedTexture& texture);
+
+    //!Reads the whole file at once. Returns false if it doesn't exist or isn't a valid cooked texture.
+    bool read(const std::string& location, CookedTexture& texture);
+}
+
+#endif
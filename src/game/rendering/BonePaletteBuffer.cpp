@@ -0,0 +1,62 @@
+#include "BonePaletteBuffer.h"
+
+void BonePaletteBuffer::initialize() {
+    if (initialized) {
+        return;
+    }
+
+    glGenBuffers(1, &bufferObject);
+    glGenTextures(1, &texture);
+
+    //Each matrix is read as 4 RGBA32F texels (one per column).
+    glBindBuffer(GL_TEXTURE_BUFFER, bufferObject);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, bufferObject);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    initialized = true;
+}
+
+BonePaletteBuffer::~BonePaletteBuffer() {
+    if (!initialized) {
+        return;
+    }
+
+    glDeleteBuffers(1, &bufferObject);
+    glDeleteTextures(1, &texture);
+}
+
+unsigned int BonePaletteBuffer::addPalette(const std::vector<glm::mat4>& bones) {
+    const unsigned int offset = static_cast<unsigned int>(palettes.size());
+
+    palettes.insert(palettes.end(), bones.begin(), bones.end());
+
+    return offset;
+}
+
+void BonePaletteBuffer::upload() {
+    if (!initialized || palettes.empty()) {
+        return;
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, bufferObject);
+
+    //New storage every upload, the previous frame's draws keep reading the old one.
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::mat4) * palettes.size(), palettes.data(), GL_STREAM_DRAW);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void BonePaletteBuffer::bind(Shader& shader) const {
+    if (!initialized) {
+        DBG_LOG("Please initialize the bone palette buffer before binding it (BonePaletteBuffer.cpp bind)\n");
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + Shaders::BONE_PALETTE_LOCATION);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+
+    glUniform1i(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::BonePalettes), Shaders::BONE_PALETTE_LOCATION);
+}
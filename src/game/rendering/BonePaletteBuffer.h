@@ -0,0 +1,54 @@
+#ifndef BONE_PALETTE_BUFFER_H
+#define BONE_PALETTE_BUFFER_H
+
+#include "Debug.h"
+#include "Shader.h"
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+/*!The BonePaletteBuffer holds the bone transformations of every animated model drawn this frame.
+
+The palettes are gathered on the CPU, uploaded once per frame into a texture buffer, and every render pass reads from
+that same buffer. The animated shaders find a model's bones with the bonePaletteOffset uniform (plus
+gl_InstanceID * bonesPerInstance for instanced draws), so nothing is re-uploaded per mesh or per pass.
+*/
+class BonePaletteBuffer {
+
+public:
+    //!Keep in mind that the destructor will call glDelete on the buffer if it was properly initialized.
+    BonePaletteBuffer() {}
+    ~BonePaletteBuffer();
+
+    BonePaletteBuffer(const BonePaletteBuffer&) = delete;
+    BonePaletteBuffer(BonePaletteBuffer&&)      = delete;
+    BonePaletteBuffer& operator=(const BonePaletteBuffer&) = delete;
+    BonePaletteBuffer& operator=(BonePaletteBuffer&&) = delete;
+
+    void initialize();
+
+    //!Removes every palette. Should be called at the start of a frame.
+    void clear() { palettes.clear(); }
+
+    //!Appends a palette and returns its offset (in bones) into the buffer. Palettes added one after another are contiguous.
+    unsigned int addPalette(const std::vector<glm::mat4>& bones);
+
+    //!Uploads every palette added since the last clear.
+    void upload();
+
+    //!Binds the buffer to Shaders::BONE_PALETTE_LOCATION and points the shader's sampler at it. The shader should be in use.
+    void bind(Shader& shader) const;
+
+    //!Amount of bones in the buffer.
+    unsigned int getAmountOfBones() const { return static_cast<unsigned int>(palettes.size()); }
+
+private:
+    std::vector<glm::mat4> palettes;
+
+    GLuint bufferObject = 0;
+    GLuint texture      = 0;
+
+    bool initialized = false;
+};
+
+#endif
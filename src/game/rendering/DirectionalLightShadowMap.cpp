@@ -1,17 +1,8 @@
 #include "DirectionalLightShadowMap.h"
+#include <algorithm>
+#include <cmath>
 
-void DirectionalLightShadowMap::updateDepthMap(const Camera& camera) {
-
-    lightSpaceMatrix = glm::ortho(bounds.left, bounds.right, bounds.bottom, bounds.top, bounds.zNear, bounds.zFar) * glm::lookAt(-lightDirection + camera.getTargetPosition(), camera.getTargetPosition(), hh::UP_VECTOR);
-
-    depthMapShader.useProgram();
-
-    glUniformMatrix4fv(
-        Shaders::getUniformLocation(depthMapShader.getProgramID(), Shaders::UniformName::LightSpaceMatrix),
-        1,
-        GL_FALSE,
-        glm::value_ptr(lightSpaceMatrix));
-}
+const unsigned int DirectionalLightShadowMap::AMOUNT_OF_CASCADES;
 
 void DirectionalLightShadowMap::initialize() {
 
@@ -22,54 +13,325 @@ void DirectionalLightShadowMap::initialize() {
 
     depthMapShader = x;
 
-    glGenFramebuffers(1, &depthMapFBO);
-    glGenTextures(1, &depthMap);
+    lightView = glm::lookAt(glm::vec3(0), lightDirection, hh::UP_VECTOR);
+
+    for (unsigned int i = 0; i < AMOUNT_OF_CASCADES; i++) {
+        glGenTextures(1, &cascades[i].depthMap);
+        glGenTextures(1, &cascades[i].staticDepthMap);
+    }
 
     updateDepthMapResolution();
 
+    for (unsigned int i = 0; i < AMOUNT_OF_CASCADES; i++) {
+        initializeFramebuffer(cascades[i].depthMapFBO, cascades[i].depthMap);
+        initializeFramebuffer(cascades[i].staticDepthMapFBO, cascades[i].staticDepthMap);
+    }
+
+    initialized = true;
+}
+
+void DirectionalLightShadowMap::initializeFramebuffer(GLuint& framebuffer, GLuint texture) {
+
     GLfloat borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
 
+    glBindTexture(GL_TEXTURE_2D, texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    initialized = true;
 }
+
 void DirectionalLightShadowMap::updateDepthMapResolution() {
-    if (DEPTH_MAP_HEIGHT > 0 && DEPTH_MAP_WIDTH > 0) {
-
-        glBindTexture(GL_TEXTURE_2D, depthMap);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_DEPTH_COMPONENT24, // GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT32 also should work but 24 is a good inbetween
-            DEPTH_MAP_WIDTH,
-            DEPTH_MAP_HEIGHT,
-            0,
-            GL_DEPTH_COMPONENT,
-            GL_FLOAT,
-            NULL);
+    if (DEPTH_MAP_HEIGHT > 1 && DEPTH_MAP_WIDTH > 1) {
+
+        for (unsigned int i = 0; i < AMOUNT_OF_CASCADES; i++) {
+            Cascade& cascade = cascades[i];
+
+            //The farther cascades cover more of the scene with less detail, so they get half the resolution.
+            cascade.width  = i == 0 ? DEPTH_MAP_WIDTH : DEPTH_MAP_WIDTH / 2;
+            cascade.height = i == 0 ? DEPTH_MAP_HEIGHT : DEPTH_MAP_HEIGHT / 2;
+
+            allocateDepthMap(cascade.depthMap, cascade.width, cascade.height);
+            allocateDepthMap(cascade.staticDepthMap, cascade.width, cascade.height);
+        }
+
+        invalidateStaticCache();
     } else {
-        DBG_LOG("The Depth Map Resolution Needs To Be Greater Than 0.\n");
+        DBG_LOG("The Depth Map Resolution Needs To Be Greater Than 1.\n");
     }
 }
 
+void DirectionalLightShadowMap::allocateDepthMap(GLuint texture, unsigned int width, unsigned int height) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(
+        GL_TEXTURE_2D,
+        0,
+        GL_DEPTH_COMPONENT24, // GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT32 also should work but 24 is a good inbetween
+        width,
+        height,
+        0,
+        GL_DEPTH_COMPONENT,
+        GL_FLOAT,
+        NULL);
+}
+
 DirectionalLightShadowMap::~DirectionalLightShadowMap() {
     if (!initialized) {
         return;
     }
     DBG_LOG("Freeing memory for Directional light depth map.\n");
 
-    glDeleteFramebuffers(1, &depthMapFBO);
-    glDeleteTextures(1, &depthMap);
-    depthMapFBO = 0;
-    depthMap    = 0;
+    for (unsigned int i = 0; i < AMOUNT_OF_CASCADES; i++) {
+        Cascade& cascade = cascades[i];
+
+        glDeleteFramebuffers(1, &cascade.depthMapFBO);
+        glDeleteFramebuffers(1, &cascade.staticDepthMapFBO);
+        glDeleteTextures(1, &cascade.depthMap);
+        glDeleteTextures(1, &cascade.staticDepthMap);
+        cascade.depthMapFBO       = 0;
+        cascade.staticDepthMapFBO = 0;
+        cascade.depthMap          = 0;
+        cascade.staticDepthMap    = 0;
+    }
+
     initialized = false;
 }
+
+const glm::mat4* const DirectionalLightShadowMap::getLightSpaceMatrix(unsigned int cascade) const {
+    if (cascade >= AMOUNT_OF_CASCADES) {
+        DBG_LOG("This index goes out of bounds (DirectionalLightShadowMap.cpp getLightSpaceMatrix)\n");
+        return &cascades[0].lightSpaceMatrix;
+    }
+
+    return &cascades[cascade].lightSpaceMatrix;
+}
+
+GLuint DirectionalLightShadowMap::getDepthMap(unsigned int cascade) const {
+    if (cascade >= AMOUNT_OF_CASCADES) {
+        DBG_LOG("This index goes out of bounds (DirectionalLightShadowMap.cpp getDepthMap)\n");
+        return 0;
+    }
+
+    return cascades[cascade].depthMap;
+}
+
+float DirectionalLightShadowMap::getCascadeSplit(unsigned int cascade) const {
+    if (cascade >= AMOUNT_OF_CASCADES) {
+        DBG_LOG("This index goes out of bounds (DirectionalLightShadowMap.cpp getCascadeSplit)\n");
+        return 0.0f;
+    }
+
+    return cascades[cascade].splitFar;
+}
+
+const OcclusionCuller& DirectionalLightShadowMap::getCascadeCuller(unsigned int cascade) const {
+    if (cascade >= AMOUNT_OF_CASCADES) {
+        DBG_LOG("This index goes out of bounds (DirectionalLightShadowMap.cpp getCascadeCuller)\n");
+        return cascades[0].culler;
+    }
+
+    return cascades[cascade].culler;
+}
+
+bool DirectionalLightShadowMap::isCascadeScheduled(unsigned int cascade) const {
+    return cascade < AMOUNT_OF_CASCADES && cascades[cascade].scheduled;
+}
+
+void DirectionalLightShadowMap::invalidateStaticCache() {
+    for (unsigned int i = 0; i < AMOUNT_OF_CASCADES; i++) {
+        cascades[i].fitted      = false;
+        cascades[i].staticValid = false;
+    }
+}
+
+void DirectionalLightShadowMap::setCurrentLightDirection(const glm::vec3& lightDir) {
+    const glm::vec3 direction = glm::vec3(lightDir.x + securityAdditiveForDirection, lightDir.y + securityAdditiveForDirection, lightDir.z);
+
+    if (direction == lightDirection) {
+        return;
+    }
+
+    //Small turns are ignored, the static caches would be redrawn every fixed step while the sun moves otherwise.
+    const float cosine = glm::dot(glm::normalize(direction), glm::normalize(lightDirection));
+    if (cosine >= std::cos(glm::radians(DIRECTION_THRESHOLD))) {
+        return;
+    }
+
+    lightDirection = direction;
+    lightView      = glm::lookAt(glm::vec3(0), lightDirection, hh::UP_VECTOR);
+
+    invalidateStaticCache();
+}
+
+void DirectionalLightShadowMap::setShadowDistance(float distance) {
+    if (distance <= 0.0f) {
+        DBG_LOG("The shadow distance needs to be greater than 0 (DirectionalLightShadowMap.cpp setShadowDistance)\n");
+        return;
+    }
+
+    shadowDistance = distance;
+}
+
+void DirectionalLightShadowMap::updateSplits(Camera& camera) {
+    const float nearPlane = camera.getNearPlane();
+    const float farPlane  = std::min(shadowDistance, camera.getFarPlane());
+
+    for (unsigned int i = 0; i < AMOUNT_OF_CASCADES; i++) {
+        const float part        = static_cast<float>(i + 1) / static_cast<float>(AMOUNT_OF_CASCADES);
+        const float logarithmic = nearPlane * std::pow(farPlane / nearPlane, part);
+        const float uniform     = nearPlane + (farPlane - nearPlane) * part;
+        const float split       = SPLIT_WEIGHT * logarithmic + (1.0f - SPLIT_WEIGHT) * uniform;
+
+        if (split != cascades[i].splitFar) {
+            cascades[i].splitFar = split;
+            cascades[i].fitted   = false;
+        }
+    }
+}
+
+void DirectionalLightShadowMap::fitCascade(Cascade& cascade, Camera& camera, float splitNear, float splitFar) {
+
+    const float tanHalfFOV      = std::tan(glm::radians(camera.getFOV()) * 0.5f);
+    const float aspect          = static_cast<float>(GameInfo::getWindowWidth()) / static_cast<float>(GameInfo::getWindowHeight());
+    const glm::mat4 viewToWorld = glm::inverse(*camera.getViewMatrix());
+
+    glm::vec3 corners[8];
+    glm::vec3 center = glm::vec3(0);
+
+    for (unsigned int i = 0; i < 8; i++) {
+        const float distance = (i & 4) ? splitFar : splitNear;
+
+        const glm::vec3 corner(
+            ((i & 1) ? 1.0f : -1.0f) * distance * tanHalfFOV * aspect,
+            ((i & 2) ? 1.0f : -1.0f) * distance * tanHalfFOV,
+            -distance);
+
+        corners[i] = glm::vec3(viewToWorld * glm::vec4(corner, 1.0f));
+        center += corners[i] / 8.0f;
+    }
+
+    //The radius doesn't depend on the camera's orientation, so the size of the cascade stays the same while looking around.
+    float radius = 0.0f;
+
+    for (unsigned int i = 0; i < 8; i++) {
+        radius = std::max(radius, glm::length(corners[i] - center));
+    }
+
+    radius = std::ceil(radius);
+
+    const glm::vec3 lightSpaceCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+    const glm::vec3 offset           = glm::abs(lightSpaceCenter - cascade.center);
+
+    if (cascade.fitted && radius == cascade.radius && std::max(offset.x, std::max(offset.y, offset.z)) <= radius * FIT_MARGIN) {
+        return;
+    }
+
+    const float halfSize  = radius * (1.0f + FIT_MARGIN);
+    const float texelSize = (2.0f * halfSize) / static_cast<float>(cascade.width);
+
+    //Snapping to whole texels keeps the shadow edges from crawling when the cascade moves.
+    cascade.center = glm::vec3(
+        std::floor(lightSpaceCenter.x / texelSize) * texelSize,
+        std::floor(lightSpaceCenter.y / texelSize) * texelSize,
+        lightSpaceCenter.z);
+
+    cascade.radius = radius;
+
+    const glm::mat4 projection = glm::ortho(
+        cascade.center.x - halfSize,
+        cascade.center.x + halfSize,
+        cascade.center.y - halfSize,
+        cascade.center.y + halfSize,
+        -(cascade.center.z + halfSize + CASTER_DISTANCE),
+        -(cascade.center.z - halfSize));
+
+    cascade.lightSpaceMatrix = projection * lightView;
+    cascade.fitted           = true;
+    cascade.staticValid      = false;
+
+    //Nothing is rasterized into the culler, so it only tests whether bounds are inside of the cascade.
+    cascade.culler.beginFrame(cascade.lightSpaceMatrix);
+    cascade.culler.buildHierarchy();
+}
+
+void DirectionalLightShadowMap::scheduleCascades(Camera& camera) {
+
+    updateSplits(camera);
+
+    frameCount++;
+
+    for (unsigned int i = 0; i < AMOUNT_OF_CASCADES; i++) {
+        Cascade& cascade = cascades[i];
+
+        //The first cascade is updated every frame, the others take turns every other frame.
+        cascade.scheduled = i == 0 || !cascade.fitted || !cascade.staticValid || (frameCount % 2) == (i % 2);
+
+        if (cascade.scheduled) {
+            fitCascade(cascade, camera, i == 0 ? camera.getNearPlane() : cascades[i - 1].splitFar, cascade.splitFar);
+        }
+    }
+}
+
+void DirectionalLightShadowMap::supplyLightSpaceMatrix(const Cascade& cascade) {
+    //Models pick the variant they're drawn with, so every variant needs the cascade's matrix.
+    depthMapShader.forEachVariant([&cascade](GLint programID) {
+        Shader::bindProgram(programID);
+
+        glUniformMatrix4fv(
+            Shaders::getUniformLocation(programID, Shaders::UniformName::LightSpaceMatrix),
+            1,
+            GL_FALSE,
+            glm::value_ptr(cascade.lightSpaceMatrix));
+    });
+}
+
+bool DirectionalLightShadowMap::beginStaticPass(unsigned int index) {
+    if (index >= AMOUNT_OF_CASCADES) {
+        DBG_LOG("This index goes out of bounds (DirectionalLightShadowMap.cpp beginStaticPass)\n");
+        return false;
+    }
+
+    Cascade& cascade = cascades[index];
+
+    if (cascade.staticValid) {
+        return false;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, cascade.staticDepthMapFBO);
+    glViewport(0, 0, cascade.width, cascade.height);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    supplyLightSpaceMatrix(cascade);
+
+    cascade.staticValid = true;
+    return true;
+}
+
+void DirectionalLightShadowMap::beginDynamicPass(unsigned int index) {
+    if (index >= AMOUNT_OF_CASCADES) {
+        DBG_LOG("This index goes out of bounds (DirectionalLightShadowMap.cpp beginDynamicPass)\n");
+        return;
+    }
+
+    Cascade& cascade = cascades[index];
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, cascade.staticDepthMapFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, cascade.depthMapFBO);
+
+    glBlitFramebuffer(0, 0, cascade.width, cascade.height,
+                      0, 0, cascade.width, cascade.height,
+                      GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, cascade.depthMapFBO);
+    glViewport(0, 0, cascade.width, cascade.height);
+
+    supplyLightSpaceMatrix(cascade);
+}
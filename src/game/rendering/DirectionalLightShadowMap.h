@@ -4,24 +4,29 @@
 #include "Debug.h"
 #include "HelpingHand.h"
 #include "Locator.h"
+#include "OcclusionCuller.h"
 #include "Shader.h"
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-struct OrthographicBounds {
-    float left;
-    float right;
-    float bottom;
-    float top;
-    float zNear;
-    float zFar;
-};
+/*!The DirectionalLightShadowMap renders the scene's depth from the directional light into cascaded shadow maps.
+
+The camera's view is split into slices by distance, and every slice gets its own depth texture fitted around it.
+The first cascade is updated every frame, the farther (and lower resolution) ones take turns every other frame.
 
+Static casters are cached in a second depth texture per cascade, which is only redrawn when the cascade is re-fitted.
+A cascade is only re-fitted once its slice of the camera's view leaves the area it covers, and its position is
+snapped to whole texels so the shadows don't shimmer when that happens. The light's direction only moves once it turned
+more than DIRECTION_THRESHOLD degrees, so a slowly rotating sun rebuilds the caches every few seconds, not every step.
+*/
 class DirectionalLightShadowMap {
 
 public:
+    //!Must match AMOUNT_OF_CASCADES in the lit shaders.
+    static const unsigned int AMOUNT_OF_CASCADES = 3;
+
     void initialize();
 
     //!Keep in mind that the destructor will call glDelete on FBO's and textures generated if the shadow map was properly initialized.
@@ -34,11 +39,14 @@ public:
     DirectionalLightShadowMap& operator=(const DirectionalLightShadowMap&) = delete;
     DirectionalLightShadowMap& operator=(DirectionalLightShadowMap&&) = delete;
 
-    const glm::mat4* const getLightSpaceMatrix() { return &lightSpaceMatrix; }
-    GLint getDepthMapShader() const { return depthMapShader.getProgramID(); }
-    GLint getDepthMap() const { return depthMap; }
-    GLuint getFBO() const { return depthMapFBO; }
+    const glm::mat4* const getLightSpaceMatrix(unsigned int cascade) const;
+    const Shader& getDepthMapShader() const { return depthMapShader; }
+    GLuint getDepthMap(unsigned int cascade) const;
+
+    //!Distance from the camera at which the cascade ends.
+    float getCascadeSplit(unsigned int cascade) const;
 
+    //!The resolution of the first cascade. The farther cascades use half of it.
     unsigned int getDepthMapWidth() const { return DEPTH_MAP_WIDTH; }
     unsigned int getDepthMapHeight() const { return DEPTH_MAP_HEIGHT; }
 
@@ -51,32 +59,101 @@ public:
     void setShadowActive(bool t) { lightSupplied = t; }
     bool isActive() { return lightSupplied; }
 
+    //!Forces every cascade to be re-fitted and its static casters to be rendered again, such as when a new scene is loaded.
+    void invalidateStaticCache();
+
     glm::vec3 getCurrentLightDirection() { return lightDirection; }
-    void setCurrentLightDirection(const glm::vec3& lightDir) { lightDirection = glm::vec3(lightDir.x + securityAdditiveForDirection, lightDir.y + securityAdditiveForDirection, lightDir.z); }
 
-    void updateDepthMap(const Camera& camera);
+    //!Does nothing until lightDir is more than DIRECTION_THRESHOLD degrees away from the current direction.
+    void setCurrentLightDirection(const glm::vec3& lightDir);
+
+    //!Distance from the camera shadows are rendered up to.
+    void setShadowDistance(float distance);
+
+    //!Re-fits the cascades that need it and picks the ones to render this frame. Should be called once per frame, before rendering.
+    void scheduleCascades(Camera& camera);
+
+    bool isCascadeScheduled(unsigned int cascade) const;
+
+    //!Culler set up with the cascade's matrix, used to skip casters that are outside of the cascade.
+    const OcclusionCuller& getCascadeCuller(unsigned int cascade) const;
+
+    //!Prepares rendering the static casters of the cascade if its cached depth is outdated.
+    //!Returns false if the cache is still valid, in which case nothing should be rendered.
+    bool beginStaticPass(unsigned int cascade);
+
+    //!Copies the cached static depth into the cascade and prepares rendering the dynamic casters on top.
+    void beginDynamicPass(unsigned int cascade);
 
 private:
-    //4096 is amazing quality. Best quality would use multiple maps and csm
-    unsigned int DEPTH_MAP_WIDTH  = 4096;
-    unsigned int DEPTH_MAP_HEIGHT = 4096;
+    struct Cascade {
+        glm::mat4 lightSpaceMatrix = glm::mat4(1.0f);
+
+        //The centre (in light space) and radius of the area the cascade covers.
+        glm::vec3 center    = glm::vec3(0);
+        float radius        = 0.0f;
+        float splitFar      = 0.0f;
+        unsigned int width  = 0;
+        unsigned int height = 0;
+
+        GLuint depthMap          = 0;
+        GLuint depthMapFBO       = 0;
+        GLuint staticDepthMap    = 0;
+        GLuint staticDepthMapFBO = 0;
+
+        OcclusionCuller culler;
+
+        bool fitted      = false;
+        bool staticValid = false;
+        bool scheduled   = false;
+    };
+
+    //4096 was needed for one map covering everything, the cascades get the same detail near the camera at a fraction of the size.
+    unsigned int DEPTH_MAP_WIDTH  = 2048;
+    unsigned int DEPTH_MAP_HEIGHT = 2048;
 
     //This floating point value will be added to two of the light direction vector's axes.
     //If 2/3 of the direction vector's axes is equal to 0, the shadows will not work.
     float securityAdditiveForDirection = .0001f;
 
+    //How much larger than its slice a cascade is, so the camera can move a little before it has to be re-fitted.
+    const float FIT_MARGIN = 0.25f;
+
+    //How many degrees the light has to turn before the shadows follow it. Every change invalidates the static caches.
+    const float DIRECTION_THRESHOLD = 0.5f;
+
+    //How far towards the light casters are still rendered, past the area the cascade covers.
+    const float CASTER_DISTANCE = 150.0f;
+
+    //How the splits are placed between uniform (0) and logarithmic (1) distances.
+    const float SPLIT_WEIGHT = 0.6f;
+
     void updateDepthMapResolution();
+    void allocateDepthMap(GLuint texture, unsigned int width, unsigned int height);
+    void initializeFramebuffer(GLuint& framebuffer, GLuint texture);
 
-    OrthographicBounds bounds { -40.0f, 40.0f, -40.0f, 40.0f, -150.0f, 150.0f }; //TODO: better ? makes shadow map cover more distance
+    void updateSplits(Camera& camera);
+
+    //!Re-fits the cascade around its slice of the camera's view if the slice left the area it covers.
+    void fitCascade(Cascade& cascade, Camera& camera, float splitNear, float splitFar);
+
+    void supplyLightSpaceMatrix(const Cascade& cascade);
+
+    Cascade cascades[AMOUNT_OF_CASCADES];
+
+    float shadowDistance = 150.0f;
+
+    //Used to alternate the cascades that are updated every other frame.
+    unsigned int frameCount = 0;
 
     glm::vec3 lightDirection = glm::vec3(0.0001f, -1.f, 0);
 
+    //The rotation of the light's view, the cascades are positioned in this space.
+    glm::mat4 lightView = glm::mat4(1.0f);
+
     bool lightSupplied = false;
 
-    glm::mat4 lightSpaceMatrix;
-    GLuint depthMapFBO;
     Shader depthMapShader;
-    GLuint depthMap;
     bool initialized = false;
 };
 
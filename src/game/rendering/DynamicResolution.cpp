@@ -0,0 +1,108 @@
+#include "DynamicResolution.h"
+#include "Debug.h"
+
+void DynamicResolution::initialize(unsigned int maxSamples) {
+    levels.clear();
+
+    QualityLevel level;
+    level.samples = maxSamples > 0 ? maxSamples : 1;
+
+    //Fewer samples cost less than fewer pixels, so they go first.
+    for (; level.samples > 2; level.samples /= 2) {
+        levels.push_back(level);
+    }
+
+    //Steps are counted instead of accumulated so floating point error can't add or skip one.
+    const unsigned int scaleSteps = static_cast<unsigned int>((1.0f - MIN_SCALE) / SCALE_STEP + 0.5f);
+
+    for (unsigned int i = 0; i <= scaleSteps; i++) {
+        level.scale = 1.0f - SCALE_STEP * i;
+        levels.push_back(level);
+    }
+
+    if (level.samples > 1) {
+        level.samples = 1;
+        levels.push_back(level);
+    }
+
+    reset();
+}
+
+void DynamicResolution::reset() {
+    currentLevel      = 0;
+    averageFrameTime  = 0.0;
+    overBudgetFrames  = 0;
+    underBudgetFrames = 0;
+    cooldownFrames    = 0;
+}
+
+void DynamicResolution::setTargetFrameRate(float framesPerSecond) {
+    if (framesPerSecond <= 0.0f) {
+        DBG_LOG("The target frame rate must be above zero (DynamicResolution.cpp setTargetFrameRate)\n");
+        return;
+    }
+
+    targetFrameRate   = framesPerSecond;
+    overBudgetFrames  = 0;
+    underBudgetFrames = 0;
+}
+
+bool DynamicResolution::update(double frameMilliseconds) {
+    if (cooldownFrames > 0) {
+        cooldownFrames--;
+        return false;
+    }
+
+    averageFrameTime = averageFrameTime == 0.0 ? frameMilliseconds : averageFrameTime + (frameMilliseconds - averageFrameTime) * AVERAGE_WEIGHT;
+
+    const double budget = 1000.0 / targetFrameRate;
+
+    if (averageFrameTime > budget) {
+        underBudgetFrames = 0;
+
+        if (++overBudgetFrames >= DOWNGRADE_FRAMES && currentLevel + 1 < levels.size()) {
+            changeLevel(currentLevel + 1);
+            return true;
+        }
+
+        return false;
+    }
+
+    overBudgetFrames = 0;
+
+    if (currentLevel == 0) {
+        return false;
+    }
+
+    const double estimatedFrameTime = averageFrameTime * estimateCost(currentLevel - 1) / estimateCost(currentLevel);
+
+    if (estimatedFrameTime > budget * UPGRADE_HEADROOM) {
+        underBudgetFrames = 0;
+        return false;
+    }
+
+    if (++underBudgetFrames >= UPGRADE_FRAMES) {
+        changeLevel(currentLevel - 1);
+        return true;
+    }
+
+    return false;
+}
+
+double DynamicResolution::estimateCost(unsigned int level) const {
+    const QualityLevel& quality = levels[level];
+
+    return quality.scale * quality.scale * (1.0 + 0.25 * (quality.samples - 1));
+}
+
+void DynamicResolution::changeLevel(unsigned int level) {
+    //Assume the frame time follows the cost until new timings arrive.
+    averageFrameTime *= estimateCost(level) / estimateCost(currentLevel);
+
+    currentLevel      = level;
+    overBudgetFrames  = 0;
+    underBudgetFrames = 0;
+    cooldownFrames    = COOLDOWN_FRAMES;
+
+    DBG_LOG("Rendering at %.0f%% resolution with %u samples.\n", levels[currentLevel].scale * 100.0f, levels[currentLevel].samples);
+}
@@ -0,0 +1,74 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <vector>
+
+/*!Picks the resolution scale and MSAA sample count the scene is rendered at, to hold a target frame rate.
+
+Quality levels go from most to least expensive: the sample count is halved first, down to two samples, then the
+resolution is scaled down, and only the lowest level drops MSAA. A level is dropped once the averaged frame time
+stayed over budget for DOWNGRADE_FRAMES frames. A level is raised only after UPGRADE_FRAMES frames in which the next
+level's estimated frame time fit well under the budget. The gap between the two thresholds is the hysteresis that
+keeps the resolution from oscillating. Every change is followed by COOLDOWN_FRAMES frames that are ignored, since
+GPU timings arrive a few frames late.
+*/
+class DynamicResolution {
+
+public:
+    struct QualityLevel {
+        float scale          = 1.0f;
+        unsigned int samples = 1;
+    };
+
+    static constexpr float MIN_SCALE  = 0.5f;
+    static constexpr float SCALE_STEP = 0.1f;
+
+    static const unsigned int DOWNGRADE_FRAMES = 8;
+    static const unsigned int UPGRADE_FRAMES   = 90;
+    static const unsigned int COOLDOWN_FRAMES  = 8;
+
+    //!A level is raised only if its estimated frame time is below this share of the budget.
+    static constexpr double UPGRADE_HEADROOM = 0.85;
+
+    //!Weight of every new frame time in the average.
+    static constexpr double AVERAGE_WEIGHT = 0.1;
+
+    //!Builds the quality levels, starting at the full resolution with maxSamples.
+    void initialize(unsigned int maxSamples);
+
+    //!Feeds the time the last frame took. Returns true if the quality level changed.
+    bool update(double frameMilliseconds);
+
+    //!Goes back to the best quality level and forgets the frame times.
+    void reset();
+
+    void setTargetFrameRate(float framesPerSecond);
+    float getTargetFrameRate() const { return targetFrameRate; }
+
+    float getScale() const { return levels[currentLevel].scale; }
+    unsigned int getSamples() const { return levels[currentLevel].samples; }
+
+    unsigned int getLevel() const { return currentLevel; }
+    unsigned int amountOfLevels() const { return static_cast<unsigned int>(levels.size()); }
+
+    double getAverageFrameTime() const { return averageFrameTime; }
+
+private:
+    //!Rough cost of rendering at level relative to the others: the amount of pixels, with every extra sample adding a quarter.
+    double estimateCost(unsigned int level) const;
+
+    void changeLevel(unsigned int level);
+
+    std::vector<QualityLevel> levels = std::vector<QualityLevel>(1);
+
+    unsigned int currentLevel = 0;
+
+    float targetFrameRate   = 60.0f;
+    double averageFrameTime = 0.0;
+
+    unsigned int overBudgetFrames  = 0;
+    unsigned int underBudgetFrames = 0;
+    unsigned int cooldownFrames    = 0;
+};
+
+#endif
@@ -0,0 +1,187 @@
+#include "GpuProfiler.h"
+
+namespace {
+    const char* PassNames[GpuProfiler::AMOUNT_OF_PASSES] = {
+        "point shadows",
+        "directional shadows",
+        "main",
+        "multisample blit",
+        "screen resolve"
+    };
+}
+
+GpuProfiler::~GpuProfiler() {
+    if (!initialized) {
+        return;
+    }
+
+    for (unsigned int i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        glDeleteQueries(AMOUNT_OF_PASSES, frames[i].queries);
+    }
+}
+
+const char* GpuProfiler::getPassName(GPU_PASS pass) {
+    if (pass < GPU_PASS::GPU_PASS_MAX) {
+        return PassNames[static_cast<unsigned int>(pass)];
+    }
+
+    return "NA";
+}
+
+bool GpuProfiler::isSupported() {
+    return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+}
+
+void GpuProfiler::initialize() {
+    if (initialized) {
+        return;
+    }
+
+    if (!isSupported()) {
+        DBG_LOG("Timer queries are not supported, the GPU won't be profiled (GpuProfiler.cpp initialize)\n");
+        return;
+    }
+
+    //Implementations may support the query without a timer behind it.
+    GLint counterBits = 0;
+    glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &counterBits);
+
+    if (counterBits == 0) {
+        DBG_LOG("The GPU timer has no bits, the GPU won't be profiled (GpuProfiler.cpp initialize)\n");
+        return;
+    }
+
+    for (unsigned int i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        glGenQueries(AMOUNT_OF_PASSES, frames[i].queries);
+    }
+
+    initialized = true;
+}
+
+void GpuProfiler::beginFrame() {
+    if (!initialized || timingFrame) {
+        return;
+    }
+
+    Frame& frame = frames[currentFrame];
+
+    //The GPU is a whole ring behind. Skipping the frame avoids a stall.
+    if (frame.pending) {
+        return;
+    }
+
+    for (unsigned int i = 0; i < AMOUNT_OF_PASSES; i++) {
+        frame.issued[i] = false;
+    }
+
+    timingFrame = true;
+}
+
+void GpuProfiler::endFrame() {
+    if (!timingFrame) {
+        return;
+    }
+
+    endPass();
+
+    frames[currentFrame].pending = true;
+    currentFrame                 = (currentFrame + 1) % FRAMES_IN_FLIGHT;
+    timingFrame                  = false;
+}
+
+void GpuProfiler::beginPass(GPU_PASS pass) {
+    if (!timingFrame || pass >= GPU_PASS::GPU_PASS_MAX) {
+        return;
+    }
+
+    endPass();
+
+    Frame& frame                 = frames[currentFrame];
+    const unsigned int passIndex = static_cast<unsigned int>(pass);
+
+    //A pass begun twice in a frame keeps the time of its first run.
+    if (frame.issued[passIndex]) {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, frame.queries[passIndex]);
+
+    frame.issued[passIndex] = true;
+    activePass              = pass;
+}
+
+void GpuProfiler::endPass() {
+    if (activePass == GPU_PASS::GPU_PASS_MAX) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    activePass = GPU_PASS::GPU_PASS_MAX;
+}
+
+bool GpuProfiler::collect() {
+    bool found = false;
+
+    //Frames finish in the order they were issued, so reading stops at the first one that isn't available.
+    while (frames[oldestFrame].pending) {
+        Frame& frame = frames[oldestFrame];
+
+        //Passes are issued in the order of GPU_PASS, and the last one issued finishes last.
+        int lastIssued = -1;
+
+        for (unsigned int i = 0; i < AMOUNT_OF_PASSES; i++) {
+            if (frame.issued[i]) {
+                lastIssued = i;
+            }
+        }
+
+        if (lastIssued >= 0) {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(frame.queries[lastIssued], GL_QUERY_RESULT_AVAILABLE, &available);
+
+            if (available != GL_TRUE) {
+                break;
+            }
+        }
+
+        readFrame(frame);
+        found = true;
+
+        frame.pending = false;
+        oldestFrame   = (oldestFrame + 1) % FRAMES_IN_FLIGHT;
+    }
+
+    return found;
+}
+
+void GpuProfiler::readFrame(Frame& frame) {
+    frameMilliseconds = 0.0;
+
+    for (unsigned int i = 0; i < AMOUNT_OF_PASSES; i++) {
+        GLuint64 nanoseconds = 0;
+
+        if (frame.issued[i]) {
+            glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &nanoseconds);
+        }
+
+        passMilliseconds[i] = nanoseconds / 1000000.0;
+        frameMilliseconds += passMilliseconds[i];
+
+        averagePassMilliseconds[i] += (passMilliseconds[i] - averagePassMilliseconds[i]) * AVERAGE_WEIGHT;
+    }
+
+    averageFrameMilliseconds += (frameMilliseconds - averageFrameMilliseconds) * AVERAGE_WEIGHT;
+
+    if (++framesSinceLog >= LOG_INTERVAL) {
+        logSummary();
+        framesSinceLog = 0;
+    }
+}
+
+void GpuProfiler::logSummary() const {
+    DBG_LOG("GPU frame: %.2f ms\n", averageFrameMilliseconds);
+
+    for (unsigned int i = 0; i < AMOUNT_OF_PASSES; i++) {
+        DBG_LOG("    %s: %.2f ms\n", PassNames[i], averagePassMilliseconds[i]);
+    }
+}
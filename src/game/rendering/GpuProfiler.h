@@ -0,0 +1,113 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include "Debug.h"
+#include <GL/glew.h>
+#include <stdint.h>
+
+enum class GPU_PASS {
+    PointShadows       = 0,
+    DirectionalShadows = 1,
+    Main               = 2,
+    MultisampleBlit    = 3,
+    ScreenResolve      = 4,
+    GPU_PASS_MAX       = 5
+};
+
+/*!Times the render passes of every frame on the GPU with GL_TIME_ELAPSED queries.
+
+Every frame in flight has its own query per pass, in a ring of FRAMES_IN_FLIGHT frames. A frame's results are read
+once all of its queries are available, a few frames later, so the profiler never waits on the GPU. If the frame a new
+one would reuse is still in flight the new frame is not timed. Passes can't be nested, only one GL_TIME_ELAPSED
+query can be active at a time.
+
+Without timer queries, or on implementations whose timer has no bits (some software renderers), the profiler stays
+uninitialized and every call does nothing.
+*/
+class GpuProfiler {
+
+public:
+    static const unsigned int FRAMES_IN_FLIGHT = 4;
+    static const unsigned int AMOUNT_OF_PASSES = static_cast<unsigned int>(GPU_PASS::GPU_PASS_MAX);
+
+    //!Frames between two summaries written to the debug log.
+    static const unsigned int LOG_INTERVAL = 600;
+
+    //!Weight of every new frame in the averages.
+    static constexpr double AVERAGE_WEIGHT = 0.05;
+
+    //!Keep in mind that the destructor will call glDelete on the queries if properly initialized.
+    GpuProfiler() {}
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler(GpuProfiler&&)      = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(GpuProfiler&&) = delete;
+
+    static const char* getPassName(GPU_PASS pass);
+
+    //!True if the context can time GPU work. Timer queries are core since OpenGL 3.3.
+    static bool isSupported();
+
+    //!Generates the queries. Does nothing if timer queries aren't supported.
+    void initialize();
+
+    bool isInitialized() const { return initialized; }
+
+    void beginFrame();
+    void endFrame();
+
+    //!Starts timing pass. Ends the pass being timed, if there is one.
+    void beginPass(GPU_PASS pass);
+    void endPass();
+
+    //!Reads the frames that finished, oldest first. Returns true if any finished since the last call.
+    bool collect();
+
+    //!Timings of the last frame that finished, in milliseconds. Passes that weren't rendered took 0.
+    double getPassMilliseconds(GPU_PASS pass) const { return passMilliseconds[static_cast<unsigned int>(pass)]; }
+    double getFrameMilliseconds() const { return frameMilliseconds; }
+
+    //!Timings averaged over the last frames, for display.
+    double getAveragePassMilliseconds(GPU_PASS pass) const { return averagePassMilliseconds[static_cast<unsigned int>(pass)]; }
+    double getAverageFrameMilliseconds() const { return averageFrameMilliseconds; }
+
+private:
+    struct Frame {
+        GLuint queries[AMOUNT_OF_PASSES] = {};
+
+        //!True for the passes that were timed this frame.
+        bool issued[AMOUNT_OF_PASSES] = {};
+
+        //!True from the end of the frame until its results are read.
+        bool pending = false;
+    };
+
+    //!Adds the finished frame to the timings.
+    void readFrame(Frame& frame);
+
+    void logSummary() const;
+
+    Frame frames[FRAMES_IN_FLIGHT];
+
+    unsigned int currentFrame = 0;
+    unsigned int oldestFrame  = 0;
+
+    //!False if the current frame isn't being timed.
+    bool timingFrame = false;
+
+    //!The pass being timed, or GPU_PASS_MAX if there is none.
+    GPU_PASS activePass = GPU_PASS::GPU_PASS_MAX;
+
+    double passMilliseconds[AMOUNT_OF_PASSES]        = {};
+    double averagePassMilliseconds[AMOUNT_OF_PASSES] = {};
+    double frameMilliseconds                         = 0.0;
+    double averageFrameMilliseconds                  = 0.0;
+
+    unsigned int framesSinceLog = 0;
+
+    bool initialized = false;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "InstancedRenderer.h"
+
+const size_t InstancedRenderer::INITIAL_INSTANCES;
+
+void InstancedRenderer::initialize() {
+    if (initialized) {
+        return;
+    }
+
+    instanceStream.initialize(INITIAL_INSTANCES * sizeof(glm::mat4));
+
+    initialized = true;
+}
+
+void InstancedRenderer::renderInstances(const std::vector<_3DM::Model*>& models, Shader& shader, const OcclusionCuller* culler) {
+    if (!initialized || models.empty()) {
+        return;
+    }
+
+    _3DM::Model& firstModel = *models[0];
+
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+
+    for (unsigned int i = 0; i < firstModel.amountOfMeshes(); i++) {
+        instanceMatrices.clear();
+
+        for (unsigned int j = 0; j < models.size(); j++) {
+            const glm::mat4 transformation = models[j]->getMeshTransformation(i);
+
+            if (culler && models[j]->getMeshBounds(i, boundsMin, boundsMax) && !culler->isVisible(boundsMin, boundsMax, transformation)) {
+                continue;
+            }
+
+            instanceMatrices.push_back(transformation);
+        }
+
+        if (instanceMatrices.empty()) {
+            continue;
+        }
+
+        if (!uploadInstanceMatrices()) {
+            continue;
+        }
+
+        firstModel.renderMeshInstanced(i, shader, instanceStream.getBufferObject(), instanceStream.getOffset(), instanceMatrices.size());
+        amountOfDrawCalls++;
+    }
+}
+
+void InstancedRenderer::renderInstances(const std::vector<_3DM::AnimatedModel*>& models, Shader& shader) {
+    if (!initialized || models.empty()) {
+        return;
+    }
+
+    _3DM::AnimatedModel& firstModel = *models[0];
+
+    //The palettes of the instances follow the first one's, in the same order as the instance matrices.
+    glUniform1i(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::BonePaletteOffset), firstModel.getBonePaletteOffset());
+    glUniform1i(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::BonesPerInstance), firstModel.amountOfBones());
+
+    for (unsigned int i = 0; i < firstModel.amountOfMeshes(); i++) {
+        instanceMatrices.clear();
+
+        for (unsigned int j = 0; j < models.size(); j++) {
+            instanceMatrices.push_back(models[j]->getMeshTransformation(i));
+        }
+
+        if (!uploadInstanceMatrices()) {
+            continue;
+        }
+
+        firstModel.renderMeshInstanced(i, shader, instanceStream.getBufferObject(), instanceStream.getOffset(), instanceMatrices.size());
+        amountOfDrawCalls++;
+    }
+}
+
+bool InstancedRenderer::uploadInstanceMatrices() {
+    if (!instanceStream.isInitialized()) {
+        return false;
+    }
+
+    const GLsizeiptr bytes = sizeof(glm::mat4) * instanceMatrices.size();
+
+    //The stream doubles until it fits the biggest draw, so it only grows a few times.
+    if (bytes > instanceStream.getSectionSize()) {
+        GLsizeiptr sectionSize = instanceStream.getSectionSize();
+        while (sectionSize < bytes) {
+            sectionSize *= 2;
+        }
+
+        instanceStream.resize(sectionSize);
+    }
+
+    void* memory = instanceStream.allocate(bytes);
+
+    if (!memory) {
+        return false;
+    }
+
+    memcpy(memory, instanceMatrices.data(), bytes);
+    instanceStream.commit();
+
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef INSTANCED_RENDERER_H
+#define INSTANCED_RENDERER_H
+
+#include "AnimatedModel.h"
+#include "Debug.h"
+#include "Model.h"
+#include "OcclusionCuller.h"
+#include "Shader.h"
+#include "StreamingBuffer.h"
+#include <GL/glew.h>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <vector>
+
+/*!The InstancedRenderer draws groups of models loaded from the same file with one glDrawElementsInstanced call per mesh.
+
+The model matrices of every draw are written into their own range of a StreamingBuffer, so a draw never waits for the
+GPU to finish reading the matrices of an earlier one. Animated instances read their bones from the
+BonePaletteBuffer with gl_InstanceID, so their palettes must have been added one after another, in draw order.
+The shader should already be in use, with its uniforms supplied and the bone palettes bound.
+*/
+class InstancedRenderer {
+
+public:
+    InstancedRenderer() {}
+
+    InstancedRenderer(const InstancedRenderer&) = delete;
+    InstancedRenderer(InstancedRenderer&&)      = delete;
+    InstancedRenderer& operator=(const InstancedRenderer&) = delete;
+    InstancedRenderer& operator=(InstancedRenderer&&) = delete;
+
+    void initialize();
+
+    //!Renders every model in one draw per mesh. Every model must be able to instance with the first one.
+    //!If culler is not null, meshes that fail its occlusion test are left out of the draw.
+    void renderInstances(const std::vector<_3DM::Model*>& models, Shader& shader, const OcclusionCuller* culler);
+
+    //!Renders every animated model in one draw per mesh. Every model must be able to instance with the first one,
+    //!and the palette of every model must directly follow the palette of the model before it.
+    void renderInstances(const std::vector<_3DM::AnimatedModel*>& models, Shader& shader);
+
+    //!Amount of instanced draw calls since the last call to resetStatistics.
+    unsigned int getAmountOfDrawCalls() const { return amountOfDrawCalls; }
+    void resetStatistics() { amountOfDrawCalls = 0; }
+
+private:
+    //!The instances a draw can take before the instance stream grows.
+    static const size_t INITIAL_INSTANCES = 1024;
+
+    //!Writes instanceMatrices into the instance stream, growing it if needed. Returns false if they couldn't be written.
+    bool uploadInstanceMatrices();
+
+    std::vector<glm::mat4> instanceMatrices;
+
+    StreamingBuffer instanceStream;
+
+    unsigned int amountOfDrawCalls = 0;
+
+    bool initialized = false;
+};
+
+#endif
@@ -0,0 +1,319 @@
+#include "OcclusionCuller.h"
+#include "Debug.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#ifdef OCCLUSION_CULLER_USE_SSE
+#include <emmintrin.h>
+#endif
+
+OcclusionCuller::OcclusionCuller() {
+
+    unsigned int width  = DEPTH_BUFFER_WIDTH;
+    unsigned int height = DEPTH_BUFFER_HEIGHT;
+
+    //Every level after the first is half the size of the previous one, down to a single texel.
+    while (true) {
+        MipLevel level;
+        level.width  = width;
+        level.height = height;
+        level.depths = std::vector<float>(width * height, 1.0f);
+
+        mipLevels.push_back(level);
+
+        if (width == 1 && height == 1) {
+            break;
+        }
+
+        width  = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+}
+
+void OcclusionCuller::beginFrame(const glm::mat4& viewProjectionMatrix) {
+    viewProjection = viewProjectionMatrix;
+
+    std::fill(mipLevels[0].depths.begin(), mipLevels[0].depths.end(), 1.0f);
+
+    amountOfTestedBounds = 0;
+    amountOfCulledBounds = 0;
+}
+
+glm::vec3 OcclusionCuller::toScreenSpace(const glm::vec4& clipPosition) const {
+    const glm::vec3 ndc = glm::vec3(clipPosition) / clipPosition.w;
+
+    return glm::vec3(
+        (ndc.x * 0.5f + 0.5f) * static_cast<float>(DEPTH_BUFFER_WIDTH),
+        (ndc.y * 0.5f + 0.5f) * static_cast<float>(DEPTH_BUFFER_HEIGHT),
+        ndc.z * 0.5f + 0.5f);
+}
+
+void OcclusionCuller::rasterizeOccluder(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const glm::mat4& modelMatrix) {
+
+    const glm::mat4 modelViewProjection = viewProjection * modelMatrix;
+
+    for (unsigned int i = 0; i + 2 < indices.size(); i += 3) {
+
+        if (indices[i] >= vertices.size() || indices[i + 1] >= vertices.size() || indices[i + 2] >= vertices.size()) {
+            DBG_LOG("Occluder index goes out of bounds (OcclusionCuller.cpp rasterizeOccluder)\n");
+            return;
+        }
+
+        const glm::vec4 triangle[3] = {
+            modelViewProjection * glm::vec4(vertices[indices[i]], 1.0f),
+            modelViewProjection * glm::vec4(vertices[indices[i + 1]], 1.0f),
+            modelViewProjection * glm::vec4(vertices[indices[i + 2]], 1.0f)
+        };
+
+        //Distance to the near plane (-w <= z). Negative means the vertex is behind the near plane.
+        float distances[3] = {
+            triangle[0].z + triangle[0].w,
+            triangle[1].z + triangle[1].w,
+            triangle[2].z + triangle[2].w
+        };
+
+        if (distances[0] >= 0 && distances[1] >= 0 && distances[2] >= 0) {
+            rasterizeTriangle(toScreenSpace(triangle[0]), toScreenSpace(triangle[1]), toScreenSpace(triangle[2]));
+            continue;
+        }
+
+        if (distances[0] < 0 && distances[1] < 0 && distances[2] < 0) {
+            continue;
+        }
+
+        //Clip the triangle against the near plane. A triangle clipped by one plane has at most 4 vertices.
+        glm::vec3 clipped[4];
+        unsigned int amountClipped = 0;
+
+        for (unsigned int j = 0; j < 3; j++) {
+            const unsigned int next = (j + 1) % 3;
+
+            if (distances[j] >= 0) {
+                clipped[amountClipped++] = toScreenSpace(triangle[j]);
+            }
+
+            if ((distances[j] >= 0) != (distances[next] >= 0)) {
+                const float t            = distances[j] / (distances[j] - distances[next]);
+                clipped[amountClipped++] = toScreenSpace(triangle[j] + (triangle[next] - triangle[j]) * t);
+            }
+        }
+
+        for (unsigned int j = 2; j < amountClipped; j++) {
+            rasterizeTriangle(clipped[0], clipped[j - 1], clipped[j]);
+        }
+    }
+}
+
+void OcclusionCuller::rasterizeTriangle(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+
+    const glm::vec3 v0 = p0;
+    glm::vec3 v1       = p1;
+    glm::vec3 v2       = p2;
+
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+
+    if (std::abs(area) < FLT_EPSILON) {
+        return;
+    }
+
+    //Keep a consistent winding so every edge function is positive inside of the triangle.
+    if (area < 0) {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    const int width  = static_cast<int>(DEPTH_BUFFER_WIDTH);
+    const int height = static_cast<int>(DEPTH_BUFFER_HEIGHT);
+
+    const int minX = std::max(0, static_cast<int>(std::floor(std::min(v0.x, std::min(v1.x, v2.x)))));
+    const int minY = std::max(0, static_cast<int>(std::floor(std::min(v0.y, std::min(v1.y, v2.y)))));
+    const int maxX = std::min(width - 1, static_cast<int>(std::ceil(std::max(v0.x, std::max(v1.x, v2.x)))));
+    const int maxY = std::min(height - 1, static_cast<int>(std::ceil(std::max(v0.y, std::max(v1.y, v2.y)))));
+
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+
+    //Edge functions in the form of a * x + b * y + c. Edge n is opposite of vertex n.
+    const float a0 = v1.y - v2.y, b0 = v2.x - v1.x, c0 = v1.x * v2.y - v1.y * v2.x;
+    const float a1 = v2.y - v0.y, b1 = v0.x - v2.x, c1 = v2.x * v0.y - v2.y * v0.x;
+    const float a2 = v0.y - v1.y, b2 = v1.x - v0.x, c2 = v0.x * v1.y - v0.y * v1.x;
+
+    //Depth is linear in screen space, so it can be written as a plane equation as well.
+    const float inverseArea = 1.0f / area;
+    const float zA          = (a0 * v0.z + a1 * v1.z + a2 * v2.z) * inverseArea;
+    const float zB          = (b0 * v0.z + b1 * v1.z + b2 * v2.z) * inverseArea;
+    const float zC          = (c0 * v0.z + c1 * v1.z + c2 * v2.z) * inverseArea;
+
+    std::vector<float>& depths = mipLevels[0].depths;
+
+    //Pixels are processed in groups of 4, so start on a multiple of 4.
+    const int startX = minX & ~3;
+
+#ifdef OCCLUSION_CULLER_USE_SSE
+    const __m128 zero    = _mm_setzero_ps();
+    const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    for (int y = minY; y <= maxY; y++) {
+        const __m128 py = _mm_set1_ps(static_cast<float>(y) + 0.5f);
+
+        const __m128 rowEdge0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(b0), py), _mm_set1_ps(c0));
+        const __m128 rowEdge1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(b1), py), _mm_set1_ps(c1));
+        const __m128 rowEdge2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(b2), py), _mm_set1_ps(c2));
+        const __m128 rowDepth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(zB), py), _mm_set1_ps(zC));
+
+        for (int x = startX; x <= maxX; x += 4) {
+            const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+            const __m128 edge0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a0), px), rowEdge0);
+            const __m128 edge1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a1), px), rowEdge1);
+            const __m128 edge2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a2), px), rowEdge2);
+
+            const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+
+            if (_mm_movemask_ps(inside) == 0) {
+                continue;
+            }
+
+            float* pixels = &depths[y * width + x];
+
+            const __m128 depth   = _mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(zA), px), rowDepth), zero);
+            const __m128 current = _mm_loadu_ps(pixels);
+            const __m128 nearest = _mm_min_ps(current, depth);
+
+            _mm_storeu_ps(pixels, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+        }
+    }
+#else
+    for (int y = minY; y <= maxY; y++) {
+        const float py = static_cast<float>(y) + 0.5f;
+
+        for (int x = startX; x <= maxX; x += 4) {
+            for (int i = 0; i < 4; i++) {
+                const float px = static_cast<float>(x + i) + 0.5f;
+
+                if (a0 * px + b0 * py + c0 < 0 || a1 * px + b1 * py + c1 < 0 || a2 * px + b2 * py + c2 < 0) {
+                    continue;
+                }
+
+                float& pixel = depths[y * width + x + i];
+                pixel        = std::min(pixel, std::max(zA * px + zB * py + zC, 0.0f));
+            }
+        }
+    }
+#endif
+}
+
+void OcclusionCuller::buildHierarchy() {
+
+    for (unsigned int i = 1; i < mipLevels.size(); i++) {
+        const MipLevel& previous = mipLevels[i - 1];
+        MipLevel& current        = mipLevels[i];
+
+        for (unsigned int y = 0; y < current.height; y++) {
+            const unsigned int y0 = std::min(y * 2, previous.height - 1);
+            const unsigned int y1 = std::min(y * 2 + 1, previous.height - 1);
+
+            for (unsigned int x = 0; x < current.width; x++) {
+                const unsigned int x0 = std::min(x * 2, previous.width - 1);
+                const unsigned int x1 = std::min(x * 2 + 1, previous.width - 1);
+
+                //Keep the farthest depth so a texel never claims to hide more than the texels beneath it.
+                current.depths[y * current.width + x] = std::max(
+                    std::max(previous.depths[y0 * previous.width + x0], previous.depths[y0 * previous.width + x1]),
+                    std::max(previous.depths[y1 * previous.width + x0], previous.depths[y1 * previous.width + x1]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::isVisible(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelMatrix) const {
+    amountOfTestedBounds++;
+
+    const glm::mat4 modelViewProjection = viewProjection * modelMatrix;
+
+    glm::vec2 screenMin = glm::vec2(FLT_MAX);
+    glm::vec2 screenMax = glm::vec2(-FLT_MAX);
+    float nearestDepth  = FLT_MAX;
+
+    unsigned int amountBehindNearPlane = 0;
+
+    for (unsigned int i = 0; i < 8; i++) {
+        const glm::vec3 corner(
+            (i & 1) ? boundsMax.x : boundsMin.x,
+            (i & 2) ? boundsMax.y : boundsMin.y,
+            (i & 4) ? boundsMax.z : boundsMin.z);
+
+        const glm::vec4 clipPosition = modelViewProjection * glm::vec4(corner, 1.0f);
+
+        if (clipPosition.z < -clipPosition.w) {
+            amountBehindNearPlane++;
+            continue;
+        }
+
+        const glm::vec3 screenPosition = toScreenSpace(clipPosition);
+
+        screenMin    = glm::min(screenMin, glm::vec2(screenPosition));
+        screenMax    = glm::max(screenMax, glm::vec2(screenPosition));
+        nearestDepth = std::min(nearestDepth, screenPosition.z);
+    }
+
+    if (amountBehindNearPlane == 8) {
+        amountOfCulledBounds++;
+        return false;
+    }
+
+    //The bounds cross the near plane, we can't say anything useful about them.
+    if (amountBehindNearPlane > 0) {
+        return true;
+    }
+
+    const float width  = static_cast<float>(DEPTH_BUFFER_WIDTH);
+    const float height = static_cast<float>(DEPTH_BUFFER_HEIGHT);
+
+    //Outside of the screen or past the far plane.
+    if (screenMax.x < 0 || screenMax.y < 0 || screenMin.x >= width || screenMin.y >= height || nearestDepth > 1.0f) {
+        amountOfCulledBounds++;
+        return false;
+    }
+
+    const int x0 = std::max(0, static_cast<int>(screenMin.x));
+    const int y0 = std::max(0, static_cast<int>(screenMin.y));
+    const int x1 = std::min(static_cast<int>(DEPTH_BUFFER_WIDTH) - 1, static_cast<int>(screenMax.x));
+    const int y1 = std::min(static_cast<int>(DEPTH_BUFFER_HEIGHT) - 1, static_cast<int>(screenMax.y));
+
+    //Pick the level where the bounds cover about 2x2 texels.
+    unsigned int level = 0;
+    int size           = std::max(x1 - x0, y1 - y0);
+
+    while (size > 2 && level + 1 < mipLevels.size()) {
+        size >>= 1;
+        level++;
+    }
+
+    const MipLevel& mip = mipLevels[level];
+    float farthestDepth = 0.0f;
+
+    for (int y = y0 >> level; y <= (y1 >> level); y++) {
+        for (int x = x0 >> level; x <= (x1 >> level); x++) {
+            farthestDepth = std::max(farthestDepth, mip.depths[y * mip.width + x]);
+        }
+    }
+
+    if (nearestDepth - DEPTH_BIAS > farthestDepth) {
+        amountOfCulledBounds++;
+        return false;
+    }
+
+    return true;
+}
+
+float OcclusionCuller::getDepth(unsigned int mipLevel, unsigned int x, unsigned int y) const {
+    if (mipLevel >= mipLevels.size() || x >= mipLevels[mipLevel].width || y >= mipLevels[mipLevel].height) {
+        DBG_LOG("Index goes out of bounds (OcclusionCuller.cpp getDepth)\n");
+        return 1.0f;
+    }
+
+    return mipLevels[mipLevel].depths[y * mipLevels[mipLevel].width + x];
+}
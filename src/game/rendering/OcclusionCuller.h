@@ -0,0 +1,72 @@
+#ifndef OCCLUSION_CULLER_H
+#define OCCLUSION_CULLER_H
+
+#include <glm/glm.hpp>
+#include <stdint.h>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OCCLUSION_CULLER_USE_SSE
+#endif
+
+/*!The OcclusionCuller is a small software rasterizer used to skip meshes that are hidden behind large occluders.
+
+Every frame the occluders are rasterized into a low resolution depth buffer, a hierarchical-z mip chain is built
+from it (each texel storing the farthest depth beneath it) and screen space bounds are tested against that chain.
+It does not touch openGL, so it can be tested without a context.
+*/
+class OcclusionCuller {
+
+public:
+    //!Must be a multiple of 4 since the rasterizer processes 4 pixels at a time.
+    static const unsigned int DEPTH_BUFFER_WIDTH = 256;
+
+    static const unsigned int DEPTH_BUFFER_HEIGHT = 128;
+
+    OcclusionCuller();
+
+    //!Clears the depth buffer and sets the matrix used for both rasterizing and testing this frame.
+    void beginFrame(const glm::mat4& viewProjectionMatrix);
+
+    //!Rasterizes an indexed triangle list into the depth buffer. Triangles are clipped against the near plane.
+    void rasterizeOccluder(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const glm::mat4& modelMatrix);
+
+    //!Builds the hierarchical-z mip chain. Should be called after every occluder is rasterized and before testing.
+    void buildHierarchy();
+
+    //!Returns false if the local space bounds are outside of the screen or completely behind the rasterized occluders.
+    bool isVisible(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelMatrix) const;
+
+    //!Returns the depth stored at x, y of a mip level. Depths are in the range of 0 (near) to 1 (far).
+    float getDepth(unsigned int mipLevel, unsigned int x, unsigned int y) const;
+
+    unsigned int getAmountOfMipLevels() const { return static_cast<unsigned int>(mipLevels.size()); }
+    unsigned int getAmountOfTestedBounds() const { return amountOfTestedBounds; }
+    unsigned int getAmountOfCulledBounds() const { return amountOfCulledBounds; }
+
+private:
+    struct MipLevel {
+        unsigned int width  = 0;
+        unsigned int height = 0;
+        std::vector<float> depths;
+    };
+
+    //!Rasterizes a triangle that has already been converted to screen space. z is the depth in the range of 0 to 1.
+    void rasterizeTriangle(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2);
+
+    //!Converts a clip space position to screen space (x and y in pixels of the first mip level, z from 0 to 1).
+    glm::vec3 toScreenSpace(const glm::vec4& clipPosition) const;
+
+    //!Small bias applied to tested depths so surfaces lying on an occluder are not culled by it.
+    const float DEPTH_BIAS = 0.0005f;
+
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+
+    //!Level 0 is the rasterized depth buffer, every level after is half the size of the previous.
+    std::vector<MipLevel> mipLevels;
+
+    mutable unsigned int amountOfTestedBounds = 0;
+    mutable unsigned int amountOfCulledBounds = 0;
+};
+
+#endif
@@ -1,4 +1,8 @@
 #include "PointLightShadowMap.h"
+#include <algorithm>
+
+const unsigned int PointLightShadowMap::MAX_LIGHTS;
+const unsigned int PointLightShadowMap::MIN_RESOLUTION;
 
 void PointLightShadowMap::initialize() {
 
@@ -8,22 +12,34 @@ void PointLightShadowMap::initialize() {
                                                            SHADER_TYPE::Default,
                                                            "assets/shaders/point-light-depth-map.geom");
 
-    glGenTextures(1, &depthCubeMap);
+    glGenTextures(1, &depthAtlas);
+    glGenTextures(1, &staticDepthAtlas);
 
-    glGenFramebuffers(1, &depthMapFBO);
+    updateDepthMapResolution();
 
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+    initializeFramebuffer(depthMapFBO, depthAtlas);
+    initializeFramebuffer(staticDepthMapFBO, staticDepthAtlas);
 
-    updateDepthMapResolution();
+    glGenFramebuffers(1, &copyReadFBO);
+    glGenFramebuffers(1, &copyDrawFBO);
+
+    initialized = true;
+}
 
-    //Needs to be called after updateDepthMapResolution
-    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthCubeMap, 0);
+void PointLightShadowMap::initializeFramebuffer(GLuint& framebuffer, GLuint atlas) {
 
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glGenFramebuffers(1, &framebuffer);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    //Needs to be called after updateDepthMapResolution. Attaches every layer so the geometry shader can pick one with gl_Layer.
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, atlas, 0);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
@@ -35,7 +51,36 @@ void PointLightShadowMap::initialize() {
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    initialized = true;
+}
+
+void PointLightShadowMap::updateDepthMapResolution() {
+
+    if (DEPTH_MAP_HEIGHT > 0 && DEPTH_MAP_WIDTH > 0) {
+
+        allocateAtlas(depthAtlas);
+        allocateAtlas(staticDepthAtlas);
+
+        invalidateStaticCache();
+
+    } else {
+        DBG_LOG("The Depth Map Resolution Needs To Be Greater Than 0.\n");
+    }
+}
+
+void PointLightShadowMap::allocateAtlas(GLuint atlas) {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas);
+
+    glTexImage3D(
+        GL_TEXTURE_2D_ARRAY,
+        0,
+        GL_DEPTH_COMPONENT24, // GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT32 also should work but 24 is a good inbetween,
+        DEPTH_MAP_WIDTH,
+        DEPTH_MAP_HEIGHT,
+        MAX_LIGHTS * 6,
+        0,
+        GL_DEPTH_COMPONENT,
+        GL_FLOAT,
+        NULL);
 }
 
 PointLightShadowMap::~PointLightShadowMap() {
@@ -45,48 +90,249 @@ PointLightShadowMap::~PointLightShadowMap() {
 
     DBG_LOG("Freeing memory for Pointlight shadow map.\n");
 
-    glDeleteTextures(1, &depthCubeMap);
+    glDeleteTextures(1, &depthAtlas);
+    glDeleteTextures(1, &staticDepthAtlas);
     glDeleteFramebuffers(1, &depthMapFBO);
-    depthMapFBO  = 0;
-    depthCubeMap = 0;
-    initialized  = false;
+    glDeleteFramebuffers(1, &staticDepthMapFBO);
+    glDeleteFramebuffers(1, &copyReadFBO);
+    glDeleteFramebuffers(1, &copyDrawFBO);
+    depthMapFBO       = 0;
+    depthAtlas        = 0;
+    staticDepthMapFBO = 0;
+    staticDepthAtlas  = 0;
+    initialized       = false;
 }
 
-glm::mat4 PointLightShadowMap::getShadowTransformation(const glm::vec3& eye, const glm::vec3& up) {
-    return glm::mat4(shadowProjection * glm::lookAt(lightPosition, lightPosition + eye, up));
+void PointLightShadowMap::setLightPosition(unsigned int index, const glm::vec3& position) {
+    if (index >= MAX_LIGHTS) {
+        DBG_LOG("Only %u point lights can be shadowed (PointLightShadowMap.cpp setLightPosition)\n", MAX_LIGHTS);
+        return;
+    }
+
+    ShadowedLight& light = lights[index];
+
+    if (position == light.position && index < amountOfLights) {
+        return;
+    }
+
+    light.position = position;
+    updateTransformations(light);
+    invalidateLight(light);
 }
 
-void PointLightShadowMap::updateDepthMap() {
+void PointLightShadowMap::setAmountOfLights(unsigned int amount) {
+    amountOfLights = amount < MAX_LIGHTS ? amount : MAX_LIGHTS;
+}
+
+float PointLightShadowMap::getLightScale(unsigned int index) const {
+    if (index >= amountOfLights || lights[index].resolution == 0) {
+        return 1.0f;
+    }
 
-    shadowProjection = glm::perspective(FOV, aspect, nearPlane, farPlane);
+    return static_cast<float>(lights[index].resolution) / static_cast<float>(DEPTH_MAP_WIDTH);
+}
 
-    shadowTransforms[0] = getShadowTransformation(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
-    shadowTransforms[1] = getShadowTransformation(glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
-    shadowTransforms[2] = getShadowTransformation(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    shadowTransforms[3] = getShadowTransformation(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
-    shadowTransforms[4] = getShadowTransformation(glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
-    shadowTransforms[5] = getShadowTransformation(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+void PointLightShadowMap::invalidateStaticCache() {
+    for (unsigned int i = 0; i < MAX_LIGHTS; i++) {
+        invalidateLight(lights[i]);
+    }
+}
 
-    glViewport(0, 0, DEPTH_MAP_WIDTH, DEPTH_MAP_HEIGHT);
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+void PointLightShadowMap::invalidateLight(ShadowedLight& light) {
+    for (unsigned int i = 0; i < 6; i++) {
+        light.faceValid[i]   = false;
+        light.staticValid[i] = false;
+    }
+}
+
+glm::mat4 PointLightShadowMap::getShadowTransformation(const glm::vec3& position, const glm::vec3& eye, const glm::vec3& up) {
+    return glm::mat4(shadowProjection * glm::lookAt(position, position + eye, up));
+}
+
+void PointLightShadowMap::updateTransformations(ShadowedLight& light) {
+    light.transforms[0] = getShadowTransformation(light.position, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+    light.transforms[1] = getShadowTransformation(light.position, glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+    light.transforms[2] = getShadowTransformation(light.position, glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    light.transforms[3] = getShadowTransformation(light.position, glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+    light.transforms[4] = getShadowTransformation(light.position, glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+    light.transforms[5] = getShadowTransformation(light.position, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+}
+
+void PointLightShadowMap::scheduleFaces(Camera& camera) {
+
+    struct FaceCandidate {
+        float priority;
+        unsigned int light;
+        unsigned int face;
+    };
+
+    FaceCandidate candidates[MAX_LIGHTS * 6];
+    unsigned int amountOfCandidates = 0;
+
+    const float focalLength = (*camera.getProjectionMatrix())[1][1];
+
+    for (unsigned int i = 0; i < amountOfLights; i++) {
+        ShadowedLight& light = lights[i];
+
+        //How much of the screen's height the light's shadowed area covers, a light the camera is inside of covers all of it.
+        const float distance   = std::max(glm::length(light.position - camera.position), nearPlane);
+        const float screenSize = farPlane * focalLength / distance;
+
+        unsigned int resolution = DEPTH_MAP_WIDTH;
+        while (resolution / 2 >= MIN_RESOLUTION && static_cast<float>(resolution / 2) >= screenSize * DEPTH_MAP_WIDTH) {
+            resolution /= 2;
+        }
+
+        if (resolution != light.resolution) {
+            light.resolution = resolution;
+            invalidateLight(light);
+        }
+
+        light.importance = screenSize;
+
+        for (unsigned int j = 0; j < 6; j++) {
+            light.scheduled[j] = false;
+
+            //Faces that were never rendered at this position and resolution always go first.
+            FaceCandidate& candidate = candidates[amountOfCandidates++];
+            candidate.priority       = light.importance * static_cast<float>(light.staleFrames[j] + 1) + (light.faceValid[j] ? 0.0f : 1e6f);
+            candidate.light          = i;
+            candidate.face           = j;
+        }
+    }
+
+    std::sort(candidates, candidates + amountOfCandidates, [](const FaceCandidate& a, const FaceCandidate& b) {
+        return a.priority > b.priority;
+    });
+
+    for (unsigned int i = 0; i < amountOfCandidates; i++) {
+        ShadowedLight& light = lights[candidates[i].light];
+
+        if (i < faceBudget) {
+            light.scheduled[candidates[i].face]   = true;
+            light.staleFrames[candidates[i].face] = 0;
+        } else {
+            light.staleFrames[candidates[i].face]++;
+        }
+    }
+}
+
+bool PointLightShadowMap::hasScheduledFaces(unsigned int index) const {
+    if (index >= amountOfLights) {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < 6; i++) {
+        if (lights[index].scheduled[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+unsigned int PointLightShadowMap::supplyFaceUniforms(unsigned int index, const bool* faces) {
+    const ShadowedLight& light = lights[index];
+
+    glm::mat4 matrices[6];
+    GLint layers[6];
+    unsigned int amountOfFaces = 0;
+
+    for (unsigned int i = 0; i < 6; i++) {
+        if (!faces[i]) {
+            continue;
+        }
+
+        matrices[amountOfFaces] = light.transforms[i];
+        layers[amountOfFaces]   = static_cast<GLint>(index * 6 + i);
+        amountOfFaces++;
+    }
+
+    //Models pick the variant they're drawn with, so every variant needs the light's uniforms.
+    depthMapShader.forEachVariant([&](GLint programID) {
+        Shader::bindProgram(programID);
+
+        glUniformMatrix4fv(Shaders::getUniformLocation(programID, Shaders::UniformName::ShadowMatrices), amountOfFaces, GL_FALSE, glm::value_ptr(matrices[0]));
+        glUniform1iv(Shaders::getUniformLocation(programID, Shaders::UniformName::FaceLayers), amountOfFaces, layers);
+        glUniform1i(Shaders::getUniformLocation(programID, Shaders::UniformName::AmountOfFaces), amountOfFaces);
+        glUniform1f(Shaders::getUniformLocation(programID, Shaders::UniformName::FarPlane), farPlane);
+        glUniform3fv(Shaders::getUniformLocation(programID, Shaders::UniformName::LightPosition), 1, &light.position[0]);
+    });
+
+    return amountOfFaces;
+}
+
+void PointLightShadowMap::clearLayer(GLuint atlas, unsigned int layer) {
+    glBindFramebuffer(GL_FRAMEBUFFER, copyDrawFBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, atlas, 0, layer);
     glClear(GL_DEPTH_BUFFER_BIT);
-    glUseProgram(depthMapShader.getProgramID());
+}
+
+bool PointLightShadowMap::beginStaticPass(unsigned int index) {
+    if (index >= amountOfLights) {
+        DBG_LOG("This index goes out of bounds (PointLightShadowMap.cpp beginStaticPass)\n");
+        return false;
+    }
+
+    ShadowedLight& light = lights[index];
+
+    bool faces[6];
+    bool anyFace = false;
+
+    for (unsigned int i = 0; i < 6; i++) {
+        faces[i] = light.scheduled[i] && !light.staticValid[i];
+        anyFace  = anyFace || faces[i];
+    }
+
+    if (!anyFace) {
+        return false;
+    }
+
+    //Clearing the layered framebuffer would clear every light, so the outdated faces are cleared one at a time.
+    for (unsigned int i = 0; i < 6; i++) {
+        if (faces[i]) {
+            clearLayer(staticDepthAtlas, index * 6 + i);
+            light.staticValid[i] = true;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, staticDepthMapFBO);
+    glViewport(0, 0, light.resolution, light.resolution);
 
-    std::string loc = Shaders::getUniformName(Shaders::UniformName::ShadowMatrices) + std::string("[");
-    for (GLuint i = 0; i < 6; ++i) {
-        glUniformMatrix4fv(
-            glGetUniformLocation(
-                depthMapShader.getProgramID(),
-                (loc + std::to_string(i) + "]").c_str()),
-            1,
-            GL_FALSE,
-            glm::value_ptr(shadowTransforms[i]));
+    supplyFaceUniforms(index, faces);
+
+    return true;
+}
+
+//Blits are limited to a single layer, so every face is attached and copied on its own.
+void PointLightShadowMap::beginDynamicPass(unsigned int index) {
+    if (index >= amountOfLights) {
+        DBG_LOG("This index goes out of bounds (PointLightShadowMap.cpp beginDynamicPass)\n");
+        return;
+    }
+
+    ShadowedLight& light = lights[index];
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, copyReadFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, copyDrawFBO);
+
+    for (unsigned int i = 0; i < 6; i++) {
+        if (!light.scheduled[i]) {
+            continue;
+        }
+
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticDepthAtlas, 0, index * 6 + i);
+        glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthAtlas, 0, index * 6 + i);
+
+        glBlitFramebuffer(0, 0, light.resolution, light.resolution,
+                          0, 0, light.resolution, light.resolution,
+                          GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+        light.faceValid[i] = true;
     }
 
-    glUniform1f(Shaders::getUniformLocation(depthMapShader.getProgramID(), Shaders::UniformName::FarPlane), farPlane);
+    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+    glViewport(0, 0, light.resolution, light.resolution);
 
-    glUniform3fv(
-        Shaders::getUniformLocation(depthMapShader.getProgramID(), Shaders::UniformName::LightPosition),
-        1,
-        &lightPosition[0]);
+    supplyFaceUniforms(index, light.scheduled);
 }
@@ -1,5 +1,7 @@
 #ifndef POINT_LIGHT_SHADOW_MAP_H
 #define POINT_LIGHT_SHADOW_MAP_H
+#include "Camera.h"
+#include "Debug.h"
 #include "Locator.h"
 #include "Texture.h"
 #include <GL/glew.h>
@@ -8,6 +10,15 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
 
+/*!The PointLightShadowMap renders the scene's depth around every shadowed point light into one shadow atlas.
+
+The atlas is a depth texture array with six layers (one per cube face) for each light, sampled by the lit shaders
+with the light's index. Every light gets a resolution based on how large it is on screen, and only the most
+important faces, up to the face budget, are re-rendered each frame.
+
+Static casters are rendered into a second cached atlas that is only redrawn when a light moves or changes
+resolution. The cached depth is copied into the scheduled faces and only dynamic casters are drawn on top.
+*/
 class PointLightShadowMap {
 public:
     //!Keep in mind that the destructor will call glDelete on FBO's and textures generated if the shadow map was properly initialized.
@@ -19,14 +30,29 @@ public:
     PointLightShadowMap& operator=(const PointLightShadowMap&) = delete;
     PointLightShadowMap& operator=(PointLightShadowMap&&) = delete;
 
+    //!Must match MAX_SHADOWED_POINT_LIGHTS in the lit shaders.
+    static const unsigned int MAX_LIGHTS = 4;
+
+    //!The smallest resolution a light's faces are rendered at.
+    static const unsigned int MIN_RESOLUTION = 64;
+
     float FOV = glm::radians(90.0f);
 
-    GLuint getCubeMap() { return depthCubeMap; }
-    GLint getDepthMapShader() { return depthMapShader.getProgramID(); }
+    GLuint getShadowAtlas() { return depthAtlas; }
+    const Shader& getDepthMapShader() const { return depthMapShader; }
     GLfloat getFarPlane() { return farPlane; }
-    glm::vec3 getCurrentLightPosition() { return lightPosition; }
-    void setCurrentLightPosition(const glm::vec3& lightPos) { lightPosition = lightPos; }
 
+    //!Sets the position of the light using the atlas slot index. Moving a light invalidates all of its faces.
+    void setLightPosition(unsigned int index, const glm::vec3& position);
+
+    //!Sets how many lights are shadowed. Their positions should be supplied with setLightPosition.
+    void setAmountOfLights(unsigned int amount);
+    unsigned int getAmountOfLights() const { return amountOfLights; }
+
+    //!Resolution the light at index is rendered at, divided by the resolution of the atlas.
+    float getLightScale(unsigned int index) const;
+
+    //!The resolution of every layer of the atlas, which is the highest resolution a light can get.
     unsigned int getDepthMapWidth() const { return DEPTH_MAP_WIDTH; }
     unsigned int getDepthMapHeight() const { return DEPTH_MAP_HEIGHT; }
     void setDepthMapResolution(const unsigned int& width, const unsigned int& height) {
@@ -35,65 +61,88 @@ public:
         updateDepthMapResolution();
     }
 
-    GLuint getFBO() { return depthMapFBO; }
+    //!Amount of faces that can be re-rendered each frame, across every light.
+    void setFaceBudget(unsigned int budget) { faceBudget = budget; }
+    unsigned int getFaceBudget() const { return faceBudget; }
+
     void setShadowActive(bool t) { lightSupplied = t; }
     bool isActive() { return lightSupplied; }
 
+    //!Forces every face to be rendered again, such as when a new scene is loaded.
+    void invalidateStaticCache();
+
     void initialize();
-    void updateDepthMap();
 
-private:
-    void updateDepthMapResolution() {
-
-        if (DEPTH_MAP_HEIGHT > 0 && DEPTH_MAP_WIDTH > 0) {
-            aspect = static_cast<float>(DEPTH_MAP_WIDTH) / static_cast<float>(DEPTH_MAP_HEIGHT);
-
-            glBindTexture(GL_TEXTURE_CUBE_MAP, depthCubeMap);
-
-            for (GLuint i = 0; i < 6; ++i) {
-                glTexImage2D(
-                    GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                    0,
-                    GL_DEPTH_COMPONENT24, // GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT32 also should work but 24 is a good inbetween,
-                    DEPTH_MAP_WIDTH,
-                    DEPTH_MAP_HEIGHT,
-                    0,
-                    GL_DEPTH_COMPONENT,
-                    GL_FLOAT,
-                    NULL);
-            }
-
-        } else {
-            DBG_LOG("The Depth Map Resolution Needs To Be Greater Than 0.\n");
-        }
-    }
+    //!Picks the resolution of every light and the faces to re-render this frame. Should be called once per frame, before rendering.
+    void scheduleFaces(Camera& camera);
+
+    //!True if faces of the light at index were scheduled this frame.
+    bool hasScheduledFaces(unsigned int index) const;
+
+    //!Prepares rendering the static casters of the scheduled faces whose cached depth is outdated.
+    //!Returns false if no face needs them, in which case nothing should be rendered.
+    bool beginStaticPass(unsigned int index);
 
-    glm::mat4 getShadowTransformation(const glm::vec3& eye, const glm::vec3& up);
+    //!Copies the cached static depth into the scheduled faces and prepares rendering the dynamic casters on top.
+    void beginDynamicPass(unsigned int index);
 
-    glm::mat4 shadowTransforms[6] = {
-        glm::mat4(1.0f),
-        glm::mat4(1.0f),
-        glm::mat4(1.0f),
-        glm::mat4(1.0f),
-        glm::mat4(1.0f),
-        glm::mat4(1.0f)
+private:
+    struct ShadowedLight {
+        glm::vec3 position          = glm::vec3(0);
+        unsigned int resolution     = 0;
+        float importance            = 0.0f;
+        glm::mat4 transforms[6]     = {};
+        unsigned int staleFrames[6] = {};
+
+        //!Whether the face was rendered with the current position and resolution.
+        bool faceValid[6]   = {};
+        bool staticValid[6] = {};
+        bool scheduled[6]   = {};
     };
 
+    void updateDepthMapResolution();
+    void allocateAtlas(GLuint atlas);
+
+    //!Creates a framebuffer with atlas as its layered depth attachment.
+    void initializeFramebuffer(GLuint& framebuffer, GLuint atlas);
+
+    void invalidateLight(ShadowedLight& light);
+    void updateTransformations(ShadowedLight& light);
+
+    //!Points the geometry shader at the faces of the light that pass the filter and returns how many there are.
+    unsigned int supplyFaceUniforms(unsigned int index, const bool* faces);
+
+    void clearLayer(GLuint atlas, unsigned int layer);
+
+    glm::mat4 getShadowTransformation(const glm::vec3& position, const glm::vec3& eye, const glm::vec3& up);
+
+    ShadowedLight lights[MAX_LIGHTS];
+    unsigned int amountOfLights = 0;
+
+    //Six faces is roughly one light per frame.
+    unsigned int faceBudget = 6;
+
     //1024 is amazing / great quality
     unsigned int DEPTH_MAP_WIDTH  = 512;
     unsigned int DEPTH_MAP_HEIGHT = 512;
 
-    bool lightSupplied  = false;
-    GLfloat nearPlane   = .10f;
-    GLfloat farPlane    = 100.0f;
-    GLfloat aspect      = 1.0f;
-    GLuint depthMapFBO  = 0;
-    GLuint depthCubeMap = 0;
+    bool lightSupplied = false;
+    GLfloat nearPlane  = .10f;
+    GLfloat farPlane   = 100.0f;
+
+    glm::mat4 shadowProjection = glm::perspective(FOV, 1.0f, nearPlane, farPlane);
+
+    GLuint depthMapFBO = 0;
+    GLuint depthAtlas  = 0;
+
+    //Static casters are cached here, and copied face by face through the copy framebuffers.
+    GLuint staticDepthMapFBO = 0;
+    GLuint staticDepthAtlas  = 0;
+    GLuint copyReadFBO       = 0;
+    GLuint copyDrawFBO       = 0;
 
     Shader depthMapShader;
-    glm::vec3 lightPosition    = glm::vec3(0, 6, 0);
-    glm::mat4 shadowProjection = glm::perspective(FOV, aspect, nearPlane, farPlane);
-    bool initialized           = false;
+    bool initialized = false;
 };
 
 #endif // !DEPTH_MAP_H
@@ -1,23 +1,24 @@
 #include "Shader.h"
-void Shader::recompileShader(const Settings& currentSettings) {
+#include "Serialization.h"
+#include <cinttypes>
 
-    std::string vertexCode   = "";
-    std::string fragmentCode = "";
-    std::string geometryCode = "";
+namespace {
+    //Written at the start of every cached program, files of another version are compiled again.
+    const Serialization::FourBytes PROGRAM_CACHE_VERSION = 1;
 
-    if (getCode(vertexFilePath, fragmentFilePath, geometryFilePath, vertexCode, fragmentCode, geometryCode) == -1) {
-        DBG_LOG("There was an error reading this file. (Shader.cpp)\n");
-    }
+    std::string getProgramCachePath(uint64_t programKey) {
+        char fileName[32];
+        snprintf(fileName, sizeof(fileName), "%016" PRIx64 ".bin", programKey);
 
-    updateTagValues(currentSettings, fragmentCode);
+        return Shaders::PROGRAM_CACHE_DIRECTORY + fileName;
+    }
+}
 
-    createProgram(vertexCode, fragmentCode, geometryCode);
+void Shader::recompileShader(const Settings& currentSettings) {
 
-    glUseProgram(this->programID);
+    setSettingsDefines(currentSettings);
 
-    for (GLuint i = 0; i < currentSettings.getLightsPerEntity(); i++) {
-        glUniform1f(glGetUniformLocation(this->programID, ("pointLights[" + std::to_string(i) + "].linear").c_str()), 1.00f);
-    }
+    recompileShader();
 }
 
 Shader::Shader(const std::string& id, const Settings& currentSettings, const std::string& vertexPath, const std::string& fragmentPath, const SHADER_TYPE& type, const std::string& geometryPath) {
@@ -37,17 +38,10 @@ Shader::Shader(const std::string& id, const Settings& currentSettings, const std
         DBG_LOG("There was an error reading this file. (Shader.cpp)\n");
     }
 
-    updateTagValues(currentSettings, fragmentCode);
-
-    createProgram(vertexCode, fragmentCode, geometryCode);
-
-    //Set all of the lights to default value
+    //The lights are set to their default value once the programs linked.
+    setSettingsDefines(currentSettings);
 
-    glUseProgram(this->programID);
-
-    for (GLuint i = 0; i < currentSettings.getLightsPerEntity(); i++) {
-        glUniform1f(glGetUniformLocation(this->programID, ("pointLights[" + std::to_string(i) + "].linear").c_str()), 1.00f);
-    }
+    createVariants(vertexCode, fragmentCode, geometryCode);
 }
 
 void Shader::setPointLight(const Settings& currentSettings, const PointLight& light, unsigned int index) {
@@ -85,36 +79,17 @@ void Shader::setShininess(const float& shininess) {
     supply1fUniform(Shaders::getUniformName(Shaders::UniformName::MaterialShininess), shininess);
 }
 
-void Shader::updateTagValues(const Settings& currentSettings, std::string& fragmentCode) {
-
-    if (shaderType != SHADER_TYPE::Lit) {
-        return;
-    }
-
-    try {
+void Shader::setSettingsDefines(const Settings& currentSettings) {
 
-        updateTagValue(
-            Shaders::MAX_LIGHT_TAG,
-            std::to_string(currentSettings.getLightsPerEntity()),
-            fragmentCode);
+    settingsDefines = "#define AMOUNT_OF_POINT_LIGHTS " + std::to_string(currentSettings.getLightsPerEntity()) + "\n"
+        + "#define SHADOW_INTENSITY " + std::to_string(currentSettings.getShadowIntensity()) + "\n"
+        + "#define SHADOW_FILTERING " + std::to_string(currentSettings.getShadowFilterAmount()) + "\n";
 
-        updateTagValue(
-            Shaders::SHADOW_INTENSITY_TAG,
-            std::to_string(currentSettings.getShadowIntensity()),
-            fragmentCode);
-
-        updateTagValue(
-            Shaders::SHADOW_FILTERING_TAG,
-            std::to_string(currentSettings.getShadowFilterAmount()),
-            fragmentCode);
-
-    } catch (const std::exception& e) {
-        DBG_LOG("Exception e: %s\n", e.what());
-    }
+    defaultLights = currentSettings.getLightsPerEntity();
 }
 
 SHADER_TASK Shader::currentTask = SHADER_TASK::Normal_Render_Task;
-GLint Shader::shadersForTasks[static_cast<unsigned int>(SHADER_TASK::SHADER_TASK_MAX)];
+const Shader* Shader::shadersForTasks[static_cast<unsigned int>(SHADER_TASK::SHADER_TASK_MAX)];
 
 Shader::Shader(const std::string& id, const std::string& vertexPath, const std::string& fragmentPath, const SHADER_TYPE& type, const std::string& geometryPath) {
 
@@ -132,7 +107,7 @@ Shader::Shader(const std::string& id, const std::string& vertexPath, const std::
         DBG_LOG("There was an error reading this file. (Shader.cpp)\n");
     }
 
-    createProgram(vertexCode, fragmentCode, geometryCode);
+    createVariants(vertexCode, fragmentCode, geometryCode);
 }
 
 SHADER_TASK Shader::getShaderTask() {
@@ -145,87 +120,158 @@ GLint Shader::createAndCompileShader(int GLShaderType, const GLchar* const* code
     glShaderSource(shader, 1, code, NULL);
     glCompileShader(shader);
 
+    //The compile status is checked by finishProgram, asking for it here would wait for the compile.
+    return shader;
+}
+
+int Shader::getCode(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath, std::string& vertexCode, std::string& fragmentCode, std::string& geometryCode) {
+
+    if (vertexPath.empty()) {
+        DBG_LOG("No path for vertex shader\n");
+    }
+    if (fragmentPath.empty()) {
+        DBG_LOG("No path for fragment shader\n");
+    }
+
+    std::vector<std::string> includedFiles;
+
+    bool read = readShaderFile(vertexPath, vertexCode, includedFiles);
+
+    includedFiles.clear();
+    read &= readShaderFile(fragmentPath, fragmentCode, includedFiles);
+
+    if (!geometryPath.empty()) {
+        includedFiles.clear();
+        read &= readShaderFile(geometryPath, geometryCode, includedFiles);
+    }
+
 #ifdef DEBUG
-    GLint success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (success == false) {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+    if (vertexCode.empty()) {
+        DBG_LOG("No code for vertex shader: \n");
+        DBG_LOG(vertexPath.c_str());
+        DBG_LOG("\n");
+    }
+
+    if (fragmentCode.empty()) {
+        DBG_LOG("No code for fragment shader: \n");
+        DBG_LOG(fragmentPath.c_str());
+        DBG_LOG("\n");
+    }
 
-        DBG_LOG("Shader Compilation Failed. Error:\n");
-        DBG_LOG(infoLog);
+    if (geometryCode.empty() && !geometryPath.empty()) {
+        DBG_LOG("No code for geometry shader: \n");
+        DBG_LOG(geometryPath.c_str());
         DBG_LOG("\n");
     }
 #endif
 
-    return shader;
+    return read ? 0 : -1;
 }
 
-int Shader::getCode(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath, std::string& vertexCode, std::string& fragmentCode, std::string& geometryCode) {
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
+bool Shader::readShaderFile(const std::string& path, std::string& code, std::vector<std::string>& includedFiles) {
+    std::ifstream file(path);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    includedFiles.push_back(path);
+
+    const std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+
+    std::string line;
+
+    while (std::getline(file, line)) {
+        const size_t directiveStart = line.find_first_not_of(" \t");
 
-    vShaderFile.exceptions(std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::badbit);
+        if (directiveStart == std::string::npos || line.compare(directiveStart, 8, "#include") != 0) {
+            code += line;
+            code += '\n';
+            continue;
+        }
 
-    try {
-        std::stringstream vShaderStream;
-        std::stringstream fShaderStream;
+        const size_t nameStart = line.find('"', directiveStart);
+        const size_t nameEnd   = nameStart == std::string::npos ? std::string::npos : line.find('"', nameStart + 1);
 
-        if (vertexPath.empty()) {
-            DBG_LOG("No path for vertex shader\n");
+        if (nameEnd == std::string::npos) {
+            DBG_LOG("Malformed include in %s: %s (Shader.cpp readShaderFile)\n", path.c_str(), line.c_str());
+            continue;
         }
-        if (fragmentPath.empty()) {
-            DBG_LOG("No path for fragment shader\n");
+
+        const std::string includePath = directory + line.substr(nameStart + 1, nameEnd - nameStart - 1);
+
+        //Every file is included once, like it had an include guard.
+        if (std::find(includedFiles.begin(), includedFiles.end(), includePath) != includedFiles.end()) {
+            continue;
         }
 
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-
-        if (!geometryPath.empty()) {
-            std::ifstream gShaderFile;
-            gShaderFile.exceptions(std::ifstream::badbit);
-            gShaderFile.open(geometryPath);
-            std::stringstream gShaderStream;
-            gShaderStream << gShaderFile.rdbuf();
-            gShaderFile.close();
-            geometryCode = gShaderStream.str();
+        if (!readShaderFile(includePath, code, includedFiles)) {
+            DBG_LOG("Couldn't include %s in %s (Shader.cpp readShaderFile)\n", includePath.c_str(), path.c_str());
         }
+    }
 
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
+    return true;
+}
 
-        vShaderFile.close();
-        fShaderFile.close();
+Shaders::ShaderVariant Shader::readFeatures(const std::string& code) {
+    Shaders::ShaderVariant declared = 0;
 
-        vertexCode   = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+    size_t pragma = code.find(Shaders::FEATURES_PRAGMA);
 
-#ifdef DEBUG
-        if (vertexCode.empty()) {
-            DBG_LOG("No code for vertex shader: \n");
-            DBG_LOG(vertexPath.c_str());
-            DBG_LOG("\n");
-        }
+    while (pragma != std::string::npos) {
+        const size_t lineEnd = code.find('\n', pragma);
 
-        if (fragmentCode.empty()) {
-            DBG_LOG("No code for fragment shader: \n");
-            DBG_LOG(fragmentPath.c_str());
-            DBG_LOG("\n");
+        std::stringstream line(code.substr(pragma + Shaders::FEATURES_PRAGMA.size(), lineEnd - pragma - Shaders::FEATURES_PRAGMA.size()));
+        std::string name;
+
+        while (line >> name) {
+            bool known = false;
+
+            for (unsigned int i = 0; i < static_cast<unsigned int>(Shaders::SHADER_FEATURE::SHADER_FEATURE_MAX); i++) {
+                if (name == Shaders::FeatureNames[i]) {
+                    declared |= Shaders::getFeatureBit(static_cast<Shaders::SHADER_FEATURE>(i));
+                    known = true;
+                }
+            }
+
+            if (!known) {
+                DBG_LOG("Unknown shader feature %s (Shader.cpp readFeatures)\n", name.c_str());
+            }
         }
 
-        if (geometryCode.empty() && !geometryPath.empty()) {
-            DBG_LOG("No code for geometry shader: \n");
-            DBG_LOG(geometryPath.c_str());
-            DBG_LOG("\n");
+        pragma = code.find(Shaders::FEATURES_PRAGMA, lineEnd);
+    }
+
+    return declared;
+}
+
+std::string Shader::getVariantCode(const std::string& code, Shaders::ShaderVariant variant) const {
+    if (code.empty()) {
+        return code;
+    }
+
+    std::string defines = settingsDefines;
+
+    for (unsigned int i = 0; i < static_cast<unsigned int>(Shaders::SHADER_FEATURE::SHADER_FEATURE_MAX); i++) {
+        if (variant & Shaders::getFeatureBit(static_cast<Shaders::SHADER_FEATURE>(i))) {
+            defines += std::string("#define ") + Shaders::FeatureNames[i] + "\n";
         }
-#endif
+    }
 
-    } catch (std::ifstream::failure e) {
-        return -1;
+    //#version has to stay the first directive.
+    const size_t version = code.find("#version");
+
+    if (version == std::string::npos) {
+        return defines + code;
+    }
+
+    const size_t versionEnd = code.find('\n', version);
+
+    if (versionEnd == std::string::npos) {
+        return code + "\n" + defines;
     }
 
-    return 0;
+    return code.substr(0, versionEnd + 1) + defines + code.substr(versionEnd + 1);
 }
 
 void Shader::recompileShader() {
@@ -238,78 +284,360 @@ void Shader::recompileShader() {
         DBG_LOG("There was an error reading this file. (Shader.cpp)\n");
     }
 
-    createProgram(vertexCode, fragmentCode, geometryCode);
+    //Frees the shaders of programs that are still pending.
+    finishProgram();
+
+    createVariants(vertexCode, fragmentCode, geometryCode);
+    finishProgram();
 }
 
-void Shader::createProgram(const std::string& vShaderCode, const std::string& fShaderCode, const std::string& gShaderCode) {
-    const char* c_str;
+void Shader::setTransformFeedbackVaryings(const std::vector<std::string>& varyings) {
+    transformFeedbackVaryings = varyings;
 
-    GLint vertex   = createAndCompileShader(GL_VERTEX_SHADER, &(c_str = vShaderCode.c_str()));
-    GLint fragment = createAndCompileShader(GL_FRAGMENT_SHADER, &(c_str = fShaderCode.c_str()));
-    GLint geometry = 0;
+    recompileShader();
+}
+
+void Shader::createVariants(const std::string& vShaderCode, const std::string& fShaderCode, const std::string& gShaderCode) {
+    features = readFeatures(vShaderCode) | readFeatures(fShaderCode) | readFeatures(gShaderCode);
+
+    //Every variant is issued before any is waited for, so they compile together.
+    for (Shaders::ShaderVariant i = 0; i < Shaders::AMOUNT_OF_VARIANTS; i++) {
+        if ((i & features) != i) {
+            continue;
+        }
+
+        createProgram(variants[i], getVariantCode(vShaderCode, i), getVariantCode(fShaderCode, i), getVariantCode(gShaderCode, i));
+    }
+}
+
+void Shader::createProgram(Variant& variant, const std::string& vShaderCode, const std::string& fShaderCode, const std::string& gShaderCode) {
+    variant.finished   = false;
+    variant.programKey = getProgramKey(vShaderCode, fShaderCode, gShaderCode);
+
+    //Programs are relinked in place, so copies of this shader keep working after it's recompiled.
+    if (variant.programID == -1) {
+        variant.programID = glCreateProgram();
+    }
+
+    variant.loadedFromCache = loadCachedProgram(variant);
+
+    if (variant.loadedFromCache) {
+        return;
+    }
+
+    if (fShaderCode.empty() || vShaderCode.empty()) {
+        DBG_LOG("EMPTY SHADER (Shader.cpp ShaderBase::createProgram())\n");
+    }
+
+    const char* c_str;
 
-    this->programID = glCreateProgram();
+    variant.vertexShader   = createAndCompileShader(GL_VERTEX_SHADER, &(c_str = vShaderCode.c_str()));
+    variant.fragmentShader = createAndCompileShader(GL_FRAGMENT_SHADER, &(c_str = fShaderCode.c_str()));
+    variant.geometryShader = 0;
 
     if (!gShaderCode.empty()) {
-        geometry = createAndCompileShader(GL_GEOMETRY_SHADER, &(c_str = gShaderCode.c_str()));
-        glAttachShader(this->programID, geometry);
+        variant.geometryShader = createAndCompileShader(GL_GEOMETRY_SHADER, &(c_str = gShaderCode.c_str()));
+        glAttachShader(variant.programID, variant.geometryShader);
     }
 
-    glAttachShader(this->programID, vertex);
-    glAttachShader(this->programID, fragment);
+    glAttachShader(variant.programID, variant.vertexShader);
+    glAttachShader(variant.programID, variant.fragmentShader);
 
-    glLinkProgram(this->programID);
+    //Has to be set before linking.
+    if (!transformFeedbackVaryings.empty()) {
+        std::vector<const GLchar*> varyings;
+
+        for (const std::string& varying : transformFeedbackVaryings) {
+            varyings.push_back(varying.c_str());
+        }
+
+        glTransformFeedbackVaryings(variant.programID, static_cast<GLsizei>(varyings.size()), &varyings[0], GL_INTERLEAVED_ATTRIBS);
+    }
+
+    if (GLEW_ARB_get_program_binary) {
+        glProgramParameteri(variant.programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    glLinkProgram(variant.programID);
+}
+
+bool Shader::finishProgram() {
+    bool finishedAny = false;
+
+    for (Shaders::ShaderVariant i = 0; i < Shaders::AMOUNT_OF_VARIANTS; i++) {
+        Variant& variant = variants[i];
+
+        if (variant.finished) {
+            continue;
+        }
+
+        variant.finished = true;
+        finishedAny      = true;
+
+        //Only a program that was compiled has shaders, a cached one was checked when it was loaded.
+        if (variant.vertexShader != 0) {
+            GLint success;
+            glGetProgramiv(variant.programID, GL_LINK_STATUS, &success);
+
+            if (success) {
+                saveCachedProgram(variant);
+            }
 
 #ifdef DEBUG
-    GLint success;
-    glGetProgramiv(this->programID, GL_LINK_STATUS, &success);
-    if (!success) {
-        GLchar infoLog[512];
-        glGetProgramInfoLog(this->programID, 512, NULL, infoLog);
-        DBG_LOG("ERROR::SHADER::PROGRAM::LINKING_FAILED\n");
-        DBG_LOG(infoLog);
-        DBG_LOG("\n");
+            if (!success) {
+                GLchar infoLog[512];
+
+                const GLint shaders[] = { variant.vertexShader, variant.fragmentShader, variant.geometryShader };
+
+                for (GLint shader : shaders) {
+                    GLint compiled = true;
 
-        if (fShaderCode.empty() || vShaderCode.empty()) {
-            DBG_LOG("EMPTY SHADER (Shader.cpp ShaderBase::createProgram())\n");
+                    if (shader != 0) {
+                        glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+                    }
+
+                    if (!compiled) {
+                        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+
+                        DBG_LOG("Shader Compilation Failed. Error:\n");
+                        DBG_LOG(infoLog);
+                        DBG_LOG("\n");
+                    }
+                }
+
+                glGetProgramInfoLog(variant.programID, 512, NULL, infoLog);
+                DBG_LOG("ERROR::SHADER::PROGRAM::LINKING_FAILED %s, variant %u\n", identifier.c_str(), i);
+                DBG_LOG(infoLog);
+                DBG_LOG("\n");
+            }
+#endif
+
+            glDetachShader(variant.programID, variant.vertexShader);
+            glDetachShader(variant.programID, variant.fragmentShader);
+            glDeleteShader(variant.vertexShader);
+            glDeleteShader(variant.fragmentShader);
+
+            if (variant.geometryShader != 0) {
+                glDetachShader(variant.programID, variant.geometryShader);
+                glDeleteShader(variant.geometryShader);
+            }
+
+            variant.vertexShader   = 0;
+            variant.fragmentShader = 0;
+            variant.geometryShader = 0;
+        }
+
+        //Set all of the lights to default value
+        if (defaultLights > 0) {
+            bindProgram(variant.programID);
+
+            for (GLuint j = 0; j < defaultLights; j++) {
+                glUniform1f(glGetUniformLocation(variant.programID, ("pointLights[" + std::to_string(j) + "].linear").c_str()), 1.00f);
+            }
         }
     }
-#endif
 
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-    glDetachShader(this->programID, vertex);
-    glDetachShader(this->programID, fragment);
+    return finishedAny;
+}
 
-    if (!gShaderCode.empty()) {
-        glDeleteShader(geometry);
-        glDetachShader(this->programID, geometry);
+bool Shader::wasLoadedFromCache() const {
+    bool cached = true;
+
+    for (Shaders::ShaderVariant i = 0; i < Shaders::AMOUNT_OF_VARIANTS; i++) {
+        if ((i & features) == i) {
+            cached &= variants[i].loadedFromCache;
+        }
+    }
+
+    return cached;
+}
+
+void Shader::deletePrograms() {
+    for (Shaders::ShaderVariant i = 0; i < Shaders::AMOUNT_OF_VARIANTS; i++) {
+        if (variants[i].programID != -1) {
+            glDeleteProgram(variants[i].programID);
+            variants[i].programID = -1;
+        }
+    }
+}
+
+uint64_t Shader::getProgramKey(const std::string& vShaderCode, const std::string& fShaderCode, const std::string& gShaderCode) const {
+    std::string key = vShaderCode + '\0' + fShaderCode + '\0' + gShaderCode;
+
+    for (const std::string& varying : transformFeedbackVaryings) {
+        key += '\0' + varying;
     }
+
+    const GLenum driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+
+    for (GLenum name : driverStrings) {
+        const GLubyte* driverString = glGetString(name);
+
+        if (driverString) {
+            key += '\0';
+            key += reinterpret_cast<const char*>(driverString);
+        }
+    }
+
+    return AssetRegistry<Shader>::hashPath(key);
+}
+
+bool Shader::loadCachedProgram(Variant& variant) {
+    if (!GLEW_ARB_get_program_binary) {
+        return false;
+    }
+
+    std::ifstream iStream(getProgramCachePath(variant.programKey), std::ios::binary);
+
+    if (!iStream.is_open()) {
+        return false;
+    }
+
+    Serialization::FourBytes version = 0;
+    Serialization::FourBytes format  = 0;
+    Serialization::FourBytes length  = 0;
+
+    Serialization::readBytes(version, sizeof(version), iStream, false);
+    Serialization::readBytes(format, sizeof(format), iStream, false);
+    Serialization::readBytes(length, sizeof(length), iStream, false);
+
+    if (!iStream || version != PROGRAM_CACHE_VERSION || length == 0) {
+        return false;
+    }
+
+    std::vector<char> binary(length);
+    iStream.read(binary.data(), length);
+
+    if (!iStream) {
+        DBG_LOG("The cached program of %s is cut short (Shader.cpp loadCachedProgram)\n", identifier.c_str());
+        return false;
+    }
+
+    glProgramBinary(variant.programID, format, binary.data(), static_cast<GLsizei>(length));
+
+    GLint success;
+    glGetProgramiv(variant.programID, GL_LINK_STATUS, &success);
+
+    //The driver may reject binaries of an older build of itself even if it reports the same version,
+    //the program is then linked from source again.
+    return success;
+}
+
+void Shader::saveCachedProgram(const Variant& variant) {
+    if (!GLEW_ARB_get_program_binary) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(variant.programID, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum binaryFormat = 0;
+
+    glGetProgramBinary(variant.programID, length, NULL, &binaryFormat, binary.data());
+
+    std::ofstream oStream(getProgramCachePath(variant.programKey), std::ios::binary);
+
+    if (!oStream.is_open()) {
+        DBG_LOG("Couldn't write the cached program of %s (Shader.cpp saveCachedProgram)\n", identifier.c_str());
+        return;
+    }
+
+    Serialization::FourBytes version = PROGRAM_CACHE_VERSION;
+    Serialization::FourBytes format  = binaryFormat;
+    Serialization::FourBytes size    = static_cast<Serialization::FourBytes>(length);
+
+    Serialization::writeBytes(version, sizeof(version), oStream);
+    Serialization::writeBytes(format, sizeof(format), oStream);
+    Serialization::writeBytes(size, sizeof(size), oStream);
+    oStream.write(binary.data(), length);
 }
 
 void Shader::useProgram() {
+    bindProgram(getProgramID());
+}
+
+void Shader::bindProgram(GLint programID) {
     static GLint lastUsed = -1;
 
-    if (lastUsed != getProgramID()) {
-        glUseProgram(getProgramID());
-        lastUsed = getProgramID();
+    if (lastUsed != programID) {
+        glUseProgram(programID);
+        lastUsed = programID;
     }
 }
 
+//Lights and materials are only supplied when they change, so every variant gets them.
 void Shader::supplyVec3fUniform(const std::string& location, const glm::vec3& value) {
-    glUniform3f(
-        glGetUniformLocation(
-            this->programID,
-            location.c_str()),
-        value.x,
-        value.y,
-        value.z);
+    forEachVariant([&](GLint programID) {
+        bindProgram(programID);
+
+        glUniform3f(
+            glGetUniformLocation(
+                programID,
+                location.c_str()),
+            value.x,
+            value.y,
+            value.z);
+    });
+
+    useProgram();
 }
 
 void Shader::supply1fUniform(const std::string& location, const float& value) {
-    glUniform1f(
-        glGetUniformLocation(
-            this->programID,
-            location.c_str()),
-        value);
+    forEachVariant([&](GLint programID) {
+        bindProgram(programID);
+
+        glUniform1f(
+            glGetUniformLocation(
+                programID,
+                location.c_str()),
+            value);
+    });
+
+    useProgram();
+}
+
+std::chrono::steady_clock::time_point ShaderHandler::beginShader() {
+    if (!compilerThreadsSet) {
+        compilerThreadsSet = true;
+
+        //0xFFFFFFFF lets the driver pick how many threads it compiles on.
+        if (GLEW_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        } else if (GLEW_ARB_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        }
+    }
+
+    return std::chrono::steady_clock::now();
+}
+
+void ShaderHandler::finishPendingShaders() {
+    if (pendingShaders == 0) {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    unsigned int cached = 0;
+
+    shaderLibrary.forEach([&cached](ShaderHandle, Shader& shader) {
+        if (shader.finishProgram() && shader.wasLoadedFromCache()) {
+            cached++;
+        }
+    });
+
+    pendingTime += std::chrono::steady_clock::now() - start;
+
+    DBG_LOG("Built %u shaders in %.2f ms, %u of them from the program cache.\n",
+            pendingShaders,
+            std::chrono::duration<double, std::milli>(pendingTime).count(),
+            cached);
+
+    pendingShaders = 0;
+    pendingTime    = std::chrono::steady_clock::duration(0);
 }
@@ -1,5 +1,6 @@
 #ifndef LIT_SHADER_H
 #define LIT_SHADER_H
+#include "AssetRegistry.h"
 #include "Component.h"
 #include "Debug.h"
 #include "Lights.h"
@@ -8,6 +9,7 @@
 #include "Shaders.h"
 #include <GL/glew.h> // Include glew to get all the required OpenGL headers
 #include <algorithm>
+#include <chrono>
 #include <fstream> //Used for file streams
 #include <glm/vec3.hpp>
 #include <sstream> //used for string streams
@@ -26,7 +28,11 @@ public:
 
     static SHADER_TASK getShaderTask();
 
-    static void setShaderTaskShader(SHADER_TASK task, const GLint& id) { shadersForTasks[static_cast<unsigned int>(task)] = id; }
+    //!True during the shadow passes, whose draws only need positions, skinning and a model matrix.
+    static bool isDepthTask() { return currentTask != SHADER_TASK::Normal_Render_Task; }
+
+    //!Draws made during task use the variant of shader matching their own selected variant.
+    static void setShaderTaskShader(SHADER_TASK task, const Shader& shader) { shadersForTasks[static_cast<unsigned int>(task)] = &shader; }
     static void setShaderTask(SHADER_TASK task) { currentTask = task; }
 
     SHADER_TYPE getShaderType() { return shaderType; }
@@ -41,11 +47,39 @@ public:
         const std::string& geometryPath = "");
 
     GLint getProgramID() const {
-        return currentTask == SHADER_TASK::Normal_Render_Task ? programID : shadersForTasks[static_cast<unsigned int>(currentTask)];
+        if (currentTask == SHADER_TASK::Normal_Render_Task) {
+            return getVariantProgramID(selectedVariant);
+        }
+
+        const Shader* taskShader = shadersForTasks[static_cast<unsigned int>(currentTask)];
+
+        return taskShader ? taskShader->getVariantProgramID(selectedVariant) : -1;
+    }
+
+    //!Returns the program of the variant with the features of variant this shader declares, the others are ignored.
+    GLint getVariantProgramID(Shaders::ShaderVariant variant) const { return variants[variant & features].programID; }
+
+    //!The features this shader was declared with, see Shaders::SHADER_FEATURE.
+    Shaders::ShaderVariant getFeatures() const { return features; }
+
+    //!Picks the variant used by useProgram and getProgramID, set before every draw. Features this shader doesn't declare are ignored.
+    void selectVariant(Shaders::ShaderVariant variant) { selectedVariant = variant; }
+
+    //!Calls function(programID) for every variant, for uniforms that have to be the same in all of them.
+    template <typename Function>
+    void forEachVariant(Function function) const {
+        for (Shaders::ShaderVariant i = 0; i < Shaders::AMOUNT_OF_VARIANTS; i++) {
+            if ((i & features) == i) {
+                function(variants[i].programID);
+            }
+        }
     }
 
     void useProgram();
 
+    //!Binds programID unless it already is. Programs must be bound through here, so useProgram knows which one is.
+    static void bindProgram(GLint programID);
+
     void supplyVec3fUniform(const std::string& location, const glm::vec3& value);
 
     void supply1fUniform(const std::string& location, const float& value);
@@ -60,6 +94,7 @@ public:
         const SHADER_TYPE& type,
         const std::string& geometryPath = "");
 
+    //!Compiles every variant again with the settings' values. The program IDs stay the same, so copies of the shader see the change.
     void recompileShader(const Settings& currentSettings);
 
     //Must use shader before calling!!!!
@@ -79,24 +114,72 @@ public:
 
     std::string getIdentifier() const { return identifier; }
 
+    //!Relinks the program so the vertex shader's outputs named by varyings are captured, interleaved in the same order.
+    void setTransformFeedbackVaryings(const std::vector<std::string>& varyings);
+
+    /*!Waits for the programs issued by the constructor, checks that they linked and writes them to the program cache.
+
+    The constructor doesn't query anything about the programs, so drivers with KHR_parallel_shader_compile keep compiling
+    while the next shaders are issued. Returns false if there was nothing to finish.
+    */
+    bool finishProgram();
+
+    //!True if every variant was read from the program cache instead of being compiled.
+    bool wasLoadedFromCache() const;
+
+    //!Deletes the program of every variant.
+    void deletePrograms();
+
 private:
-    void updateTagValues(const Settings& currentSettings, std::string& fragmentCode);
+    //One compiled combination of the shader's features.
+    struct Variant {
+        GLint programID      = -1;
+        uint64_t programKey  = 0;
+        bool loadedFromCache = false;
 
-    void updateTagValue(const std::string& tag, const std::string& toAdd, std::string& stringToModify) {
-        std::string strtString = stringToModify.substr(stringToModify.find(tag));
-        std::string endString  = strtString.substr(0, strtString.find(Shaders::TAG_END));
-        stringToModify.replace(stringToModify.find(endString), endString.length(), tag + toAdd);
-    }
+        //Set by createProgram, cleared by finishProgram.
+        bool finished = true;
 
-    static GLint shadersForTasks[static_cast<unsigned int>(SHADER_TASK::SHADER_TASK_MAX)];
+        //The shaders of a program that is still linking, deleted by finishProgram.
+        GLint vertexShader   = 0;
+        GLint fragmentShader = 0;
+        GLint geometryShader = 0;
+    };
+
+    void setSettingsDefines(const Settings& currentSettings);
+
+    static const Shader* shadersForTasks[static_cast<unsigned int>(SHADER_TASK::SHADER_TASK_MAX)];
     static SHADER_TASK currentTask;
 
     GLint createAndCompileShader(int GLShaderType, const GLchar* const* code);
 
     int getCode(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath, std::string& vertexCode, std::string& fragmentCode, std::string& geometryCode);
-    void createProgram(const std::string& vShaderCode, const std::string& fShaderCode, const std::string& gShaderCode);
 
-    GLint programID = -1;
+    //Appends the file to code with every #include "file" line replaced by that file, relative to the one including it. Files in includedFiles are skipped.
+    bool readShaderFile(const std::string& path, std::string& code, std::vector<std::string>& includedFiles);
+
+    //Reads the features declared by the code's #pragma features lines.
+    static Shaders::ShaderVariant readFeatures(const std::string& code);
+
+    //Returns code with the defines of the variant and the settings added after its #version line.
+    std::string getVariantCode(const std::string& code, Shaders::ShaderVariant variant) const;
+
+    //Issues every variant of the features the code declares.
+    void createVariants(const std::string& vShaderCode, const std::string& fShaderCode, const std::string& gShaderCode);
+    void createProgram(Variant& variant, const std::string& vShaderCode, const std::string& fShaderCode, const std::string& gShaderCode);
+
+    //The key hashes the code after the variant's defines were added, the transform feedback varyings and the driver, so any of them changing compiles the program again.
+    uint64_t getProgramKey(const std::string& vShaderCode, const std::string& fShaderCode, const std::string& gShaderCode) const;
+    bool loadCachedProgram(Variant& variant);
+    void saveCachedProgram(const Variant& variant);
+
+    Variant variants[Shaders::AMOUNT_OF_VARIANTS];
+
+    Shaders::ShaderVariant features        = 0;
+    Shaders::ShaderVariant selectedVariant = 0;
+
+    //The values of the Settings the code is compiled with, empty for shaders made without them.
+    std::string settingsDefines;
 
     std::string vertexFilePath;
     std::string fragmentFilePath;
@@ -105,8 +188,15 @@ private:
     SHADER_TYPE shaderType = SHADER_TYPE::Default;
 
     std::string identifier = "";
+
+    std::vector<std::string> transformFeedbackVaryings;
+
+    //The point lights given their default values by finishProgram, only shaders made with the Settings have any.
+    GLuint defaultLights = 0;
 };
 
+typedef AssetHandle<Shader> ShaderHandle;
+
 class ShaderHandler {
 
 public:
@@ -117,13 +207,15 @@ public:
                       const SHADER_TYPE& type,
                       const std::string& geometryPath = "") {
 
-        Shader* shader = binarySearchShaders(id);
+        Shader* shader = shaderLibrary.get(shaderLibrary.find(id));
 
         if (shader != nullptr) {
             return *shader;
         }
 
-        return addNewShader(id, currentSettings, vertexPath, fragmentPath, type, geometryPath);
+        const std::chrono::steady_clock::time_point start = beginShader();
+
+        return addNewShader(id, new Shader(id, currentSettings, vertexPath, fragmentPath, type, geometryPath), start);
     }
     Shader& getShader(const std::string& id,
                       const std::string& vertexPath,
@@ -131,90 +223,57 @@ public:
                       const SHADER_TYPE& type,
                       const std::string& geometryPath = "") {
 
-        Shader* shader = binarySearchShaders(id);
+        Shader* shader = shaderLibrary.get(shaderLibrary.find(id));
 
         if (shader != nullptr) {
             return *shader;
         }
 
-        return addNewShader(id, vertexPath, fragmentPath, type, geometryPath);
-    }
-
-    ~ShaderHandler() {
-
-        for (unsigned int i = 0; i < shaderLibrary.size(); i++) {
+        const std::chrono::steady_clock::time_point start = beginShader();
 
-            DBG_LOG("Freeing memory for shader %s.\n", shaderLibrary.at(i)->getIdentifier().c_str());
-            //todo: move delete program to shader class.
-            glDeleteProgram(shaderLibrary.at(i)->getProgramID());
-            delete shaderLibrary.at(i);
-            shaderLibrary.at(i) = nullptr;
-        }
+        return addNewShader(id, new Shader(id, vertexPath, fragmentPath, type, geometryPath), start);
     }
 
-private:
-    Shader* binarySearchShaders(const std::string& key) {
+    //Returns the handle of a shader made by getShader, or an invalid handle if there is none.
+    ShaderHandle findShader(const std::string& id) const { return shaderLibrary.find(id); }
 
-        unsigned int mid   = 0;
-        unsigned int left  = 0;
-        unsigned int right = shaderLibrary.size();
+    //Returns nullptr if the handle is invalid.
+    Shader* getShader(ShaderHandle handle) const { return shaderLibrary.get(handle); }
 
-        while (left < right) {
-            mid = left + (right - left) / 2;
+    //Finishes every shader made since the last call, see Shader::finishProgram, and logs how long building them took.
+    //Called before rendering, so the shaders a scene asks for while it loads are all compiled together.
+    void finishPendingShaders();
 
-            if (key > shaderLibrary.at(mid)->getIdentifier()) {
-                left = mid + 1;
-            } else if (key < shaderLibrary.at(mid)->getIdentifier()) {
-                right = mid;
-            } else {
-                return shaderLibrary.at(mid);
-            }
-        }
-
-        return nullptr;
-    }
-    Shader& addNewShader(const std::string& id,
-                         const std::string& vertexPath,
-                         const std::string& fragmentPath,
-                         const SHADER_TYPE& type,
-                         const std::string& geometryPath) {
-
-        Shader* shader = new Shader(id, vertexPath, fragmentPath, type, geometryPath);
-
-        // Add shader to library
-        shaderLibrary.push_back(shader);
+    ~ShaderHandler() {
 
-        // sort the library so I can use a binary search.
-        std::sort(shaderLibrary.begin(),
-                  shaderLibrary.end(),
-                  [](Shader* a, Shader* b) // :)
-                  { return a->getIdentifier() < b->getIdentifier(); });
+        shaderLibrary.forEach([](ShaderHandle, Shader& shader) {
+            DBG_LOG("Freeing memory for shader %s.\n", shader.getIdentifier().c_str());
+            shader.deletePrograms();
+        });
 
-        return *shader;
+        shaderLibrary.clear();
     }
-    Shader& addNewShader(
-        const std::string& id,
-        const Settings& currentSettings,
-        const std::string& vertexPath,
-        const std::string& fragmentPath,
-        const SHADER_TYPE& type,
-        const std::string& geometryPath) {
 
-        Shader* shader = new Shader(id, currentSettings, vertexPath, fragmentPath, type, geometryPath);
+private:
+    //Lets the driver compile on several threads the first time it's called. Returns when the shader started being built.
+    std::chrono::steady_clock::time_point beginShader();
+
+    Shader& addNewShader(const std::string& id, Shader* shader, std::chrono::steady_clock::time_point start) {
 
         // Add shader to library
-        shaderLibrary.push_back(shader);
+        shaderLibrary.add(id, shader);
 
-        // sort the library so I can use a binary search.
-        std::sort(shaderLibrary.begin(),
-                  shaderLibrary.end(),
-                  [](Shader* a, Shader* b) // :)
-                  { return a->getIdentifier() < b->getIdentifier(); });
+        pendingShaders++;
+        pendingTime += std::chrono::steady_clock::now() - start;
 
         return *shader;
     }
 
-    std::vector<Shader*> shaderLibrary;
+    AssetRegistry<Shader> shaderLibrary;
+
+    bool compilerThreadsSet     = false;
+    unsigned int pendingShaders = 0;
+    std::chrono::steady_clock::duration pendingTime{ 0 };
 };
 
 #endif
@@ -1,13 +1,10 @@
 #ifndef SHADERS_H
 #define SHADERS_H
 #include <GL/glew.h>
+#include <stdint.h>
 #include <string>
 namespace Shaders {
 
-    const std::string MAX_LIGHT_TAG        = "/*MAL*/";
-    const std::string SHADOW_INTENSITY_TAG = "/*SI*/";
-    const std::string SHADOW_FILTERING_TAG = "/*SF*/";
-
     enum class SHADER_TYPE {
         Default         = 0,
         Lit             = 1,
@@ -23,16 +20,49 @@ namespace Shaders {
         SHADER_TASK_MAX            = 3
     };
 
-    //The end tag inside the shaders (#define xxxxx /*TAG*/value//)
-    const std::string TAG_END = "//";
+    //Keywords a shader can be compiled with. A shader file declares the ones it uses with #pragma features NAME NAME,
+    //every combination of them is compiled as a variant with #define NAME for each keyword in it.
+    enum class SHADER_FEATURE {
+        Animated           = 0,
+        Instanced          = 1,
+        Shadows            = 2,
+        SHADER_FEATURE_MAX = 3
+    };
+
+    static const char* FeatureNames[static_cast<int>(SHADER_FEATURE::SHADER_FEATURE_MAX)] = {
+        "ANIMATED",
+        "INSTANCED",
+        "SHADOWS"
+    };
+
+    //A bitmask of SHADER_FEATUREs, see getFeatureBit.
+    typedef uint32_t ShaderVariant;
+
+    const ShaderVariant AMOUNT_OF_VARIANTS = 1 << static_cast<unsigned int>(SHADER_FEATURE::SHADER_FEATURE_MAX);
+
+    const std::string FEATURES_PRAGMA = "#pragma features";
+
+    static ShaderVariant getFeatureBit(SHADER_FEATURE feature) {
+        return 1 << static_cast<unsigned int>(feature);
+    }
+
+    //Where linked programs are cached with glGetProgramBinary, one file per program.
+    const std::string PROGRAM_CACHE_DIRECTORY = "assets/shaders/cache/";
 
     //The location the depth map for omnidirectional shadows is going to be bound.
     // use by adding to GL_TEXTURE_0 (GL_TEXTURE0 + DEPTH_MAP_LOCATION_OMNIDIRECTIONAL)
     const unsigned short DEPTH_MAP_LOCATION_OMNIDIRECTIONAL = 6;
 
-    //The location the depth map for directional shadows is going to be bound.
-    // use by adding to GL_TEXTURE_0 (GL_TEXTURE0 + DEPTH_MAP_LOCATION_DIRECTIONAL)
-    const unsigned short DEPTH_MAP_LOCATION_DIRECTIONAL = 7;
+    //The location the bone palette texture buffer is going to be bound for instanced animated models.
+    // use by adding to GL_TEXTURE_0 (GL_TEXTURE0 + BONE_PALETTE_LOCATION)
+    const unsigned short BONE_PALETTE_LOCATION = 8;
+
+    //The location the depth map of the first directional shadow cascade is going to be bound, the others follow it.
+    // use by adding to GL_TEXTURE_0 (GL_TEXTURE0 + DEPTH_MAP_LOCATION_DIRECTIONAL + cascade)
+    const unsigned short DEPTH_MAP_LOCATION_DIRECTIONAL = 9;
+
+    //The binding point of the ParticleSpawn uniform block read by the particle update shader.
+    const unsigned short PARTICLE_SPAWN_BLOCK_BINDING = 0;
 
     enum class UniformName {
 
@@ -40,9 +70,9 @@ namespace Shaders {
         SpecularTexture = 1,
         NormalTexture   = 2,
 
-        BoneWeights         = 3,
-        BoneIDS             = 4,
-        BoneTransformations = 5,
+        BoneWeights       = 3,
+        BoneIDS           = 4,
+        BonePaletteOffset = 5,
 
         TextureCoordinates = 6,
         Position           = 7,
@@ -76,17 +106,29 @@ namespace Shaders {
         MaterialShininess  = 30,
         TimeMS             = 31,
         MultisampleCount   = 32,
-        UNIFORM_NAME_COUNT = 33
+        IsInstanced        = 33,
+        BonePalettes       = 34,
+        BonesPerInstance   = 35,
+
+        FaceLayers          = 36,
+        AmountOfFaces       = 37,
+        ShadowedPointLights = 38,
+        PointShadowScales   = 39,
+
+        LightSpaceMatrices = 40,
+        CascadeSplits      = 41,
+        RenderScale        = 42,
+        UNIFORM_NAME_COUNT = 43
 
     };
 
-    static const char* UniformNames[33] = {
+    static const char* UniformNames[static_cast<int>(UniformName::UNIFORM_NAME_COUNT)] = {
         "material.texture_diffuse",
         "material.texture_specular",
         "material.texture_normals",
         "boneWeights",
         "boneIds",
-        "boneTransformation",
+        "bonePaletteOffset",
         "textureCoords",
         "position",
         "model",
@@ -97,7 +139,7 @@ namespace Shaders {
         "lightPosition",
         "farPlane",
         "shadowMatrices",
-        "directionalShadowMap",
+        "directionalShadowMaps",
         "pointShadowMap",
         "isAnimated",
         "colorIn",
@@ -113,7 +155,17 @@ namespace Shaders {
         "material.specular",
         "material.shininess",
         "timeMS",
-        "MultisampleCount"
+        "MultisampleCount",
+        "isInstanced",
+        "bonePalettes",
+        "bonesPerInstance",
+        "faceLayers",
+        "amountOfFaces",
+        "amountOfShadowedPointLights",
+        "pointShadowScales",
+        "lightSpaceMatrices",
+        "cascadeSplits",
+        "renderScale"
     };
 
     enum class AttribName {
@@ -128,7 +180,10 @@ namespace Shaders {
         ParticleColor    = 7,
         Color            = 8,
 
-        AttribName_MAX = 9,
+        //A mat4 attribute, so it takes up 4 locations (9 - 12).
+        InstanceModelMatrix = 9,
+
+        AttribName_MAX = 13,
     };
 
     static const char* getUniformName(const UniformName& name) {
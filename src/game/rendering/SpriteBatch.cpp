@@ -0,0 +1,181 @@
+#include "SpriteBatch.h"
+
+void SpriteBatch::initialize() {
+    if (initialized) {
+        return;
+    }
+
+    vertexStream.initialize(MAX_SPRITES * VERTICES_PER_SPRITE * sizeof(SpriteVertex));
+
+    glGenVertexArrays(1, &vertexArrayObject);
+
+    glBindVertexArray(vertexArrayObject);
+    glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::Position));
+    glEnableVertexAttribArray(Shaders::getAttribLocation(Shaders::AttribName::TextureCoordinates));
+    glBindVertexArray(0);
+
+    vertices.reserve(MAX_SPRITES * VERTICES_PER_SPRITE);
+
+    initialized = true;
+}
+
+SpriteBatch::~SpriteBatch() {
+    uninitialize();
+}
+
+void SpriteBatch::uninitialize() {
+    if (!initialized) {
+        return;
+    }
+
+    glDeleteVertexArrays(1, &vertexArrayObject);
+    vertexArrayObject = 0;
+
+    vertexStream.release();
+
+    vertices.clear();
+    runs.clear();
+    currentShader = nullptr;
+    initialized   = false;
+}
+
+void SpriteBatch::begin(Shader& shader) {
+    if (currentShader && currentShader->getProgramID() != shader.getProgramID()) {
+        flush();
+    }
+
+    currentShader = &shader;
+}
+
+void SpriteBatch::draw(
+    const Texture& texture,
+    const glm::vec4& spriteOrientationInPixels,
+    const glm::vec2& positionInPixels,
+    const glm::vec2& scaleInPixels,
+    bool distanceField) {
+
+    if (!currentShader) {
+        DBG_LOG("Sprite drawn before begin was called (SpriteBatch.cpp draw)\n");
+        return;
+    }
+
+    if (vertices.size() + VERTICES_PER_SPRITE > MAX_SPRITES * VERTICES_PER_SPRITE) {
+        flush();
+    }
+
+    const float textureWidth  = static_cast<float>(texture.getWidth());
+    const float textureHeight = static_cast<float>(texture.getHeight());
+
+    const float left   = spriteOrientationInPixels.x / textureWidth;
+    const float bottom = spriteOrientationInPixels.y / textureHeight;
+    const float right  = left + spriteOrientationInPixels.z / textureWidth;
+    const float top    = bottom + spriteOrientationInPixels.w / textureHeight;
+
+    //Pixels are divided by the window size to get to clip space.
+    const float windowWidth  = static_cast<float>(GameInfo::getWindowWidth());
+    const float windowHeight = static_cast<float>(GameInfo::getWindowHeight());
+
+    const glm::vec2 center = positionInPixels / glm::vec2(windowWidth, windowHeight);
+    const glm::vec2 extent = scaleInPixels / glm::vec2(windowWidth, windowHeight);
+
+    const SpriteVertex topLeft     = { glm::vec3(center.x - extent.x, center.y + extent.y, -1.0f), glm::vec2(left, top) };
+    const SpriteVertex bottomLeft  = { glm::vec3(center.x - extent.x, center.y - extent.y, -1.0f), glm::vec2(left, bottom) };
+    const SpriteVertex topRight    = { glm::vec3(center.x + extent.x, center.y + extent.y, -1.0f), glm::vec2(right, top) };
+    const SpriteVertex bottomRight = { glm::vec3(center.x + extent.x, center.y - extent.y, -1.0f), glm::vec2(right, bottom) };
+
+    if (runs.empty() || runs.back().texture != texture.getTextureData() || runs.back().distanceField != distanceField) {
+        Run run;
+        run.texture       = texture.getTextureData();
+        run.firstVertex   = static_cast<GLint>(vertices.size());
+        run.distanceField = distanceField;
+        runs.push_back(run);
+    }
+
+    vertices.push_back(topLeft);
+    vertices.push_back(bottomLeft);
+    vertices.push_back(topRight);
+    vertices.push_back(topRight);
+    vertices.push_back(bottomLeft);
+    vertices.push_back(bottomRight);
+
+    runs.back().amountOfVertices += VERTICES_PER_SPRITE;
+    amountOfSprites++;
+}
+
+void SpriteBatch::end() {
+    flush();
+    currentShader = nullptr;
+}
+
+void SpriteBatch::flush() {
+    if (vertices.empty()) {
+        return;
+    }
+
+    if (!initialized) {
+        DBG_LOG("Sprite batch isn't initialized (SpriteBatch.cpp flush)\n");
+        vertices.clear();
+        runs.clear();
+        return;
+    }
+
+    const GLsizeiptr bytes = vertices.size() * sizeof(SpriteVertex);
+
+    glBindVertexArray(vertexArrayObject);
+
+    void* memory = vertexStream.allocate(bytes);
+    if (!memory) {
+        glBindVertexArray(0);
+        vertices.clear();
+        runs.clear();
+        return;
+    }
+
+    memcpy(memory, vertices.data(), bytes);
+    vertexStream.commit();
+
+    glVertexAttribPointer(Shaders::getAttribLocation(Shaders::AttribName::Position), 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (GLvoid*)vertexStream.getOffset());
+    glVertexAttribPointer(Shaders::getAttribLocation(Shaders::AttribName::TextureCoordinates), 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (GLvoid*)(vertexStream.getOffset() + sizeof(glm::vec3)));
+
+    glActiveTexture(GL_TEXTURE0);
+
+    GLboolean currentDepth;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &currentDepth);
+    glDepthMask(GL_FALSE);
+
+    Shader* boundShader = nullptr;
+
+    for (const Run& run : runs) {
+        //Without a distance field shader the atlas is drawn as it is, which looks blurry but still readable.
+        Shader* runShader = run.distanceField && distanceFieldShader ? distanceFieldShader : currentShader;
+
+        if (runShader != boundShader) {
+            prepareShader(*runShader);
+            boundShader = runShader;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, run.texture);
+        glDrawArrays(GL_TRIANGLES, run.firstVertex, run.amountOfVertices);
+        amountOfDrawCalls++;
+    }
+
+    glDepthMask(currentDepth);
+    glBindVertexArray(0);
+
+    vertices.clear();
+    runs.clear();
+}
+
+void SpriteBatch::prepareShader(Shader& shader) {
+    shader.useProgram();
+
+    //The vertices are already in clip space.
+    const glm::mat4 identity = glm::mat4(1.0f);
+    glUniformMatrix4fv(
+        Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::ModelMatrix),
+        1,
+        false,
+        glm::value_ptr(identity));
+
+    glUniform1i(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::DiffuseTexture), 0);
+}
@@ -0,0 +1,113 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "Debug.h"
+#include "GameInfo.h"
+#include "Shader.h"
+#include "Shaders.h"
+#include "StreamingBuffer.h"
+#include "Texture.h"
+#include <GL/glew.h>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <vector>
+
+/*!The SpriteBatch collects the gui quads of a frame (glyphs, sprites, buttons) and draws them with as few draws as possible.
+
+Sprites are transformed into clip space on the CPU and written into one vertex stream, so the shader's model matrix is
+set to identity once per flush instead of once per quad. Consecutive sprites that share a texture are drawn together.
+Sprites aren't reordered, since gui elements overlap and are drawn back to front.
+
+Usage: begin with the gui shader, draw every sprite, then end. Drawing with a different shader flushes the batch first.
+Sprites drawn from a signed distance field atlas (see SdfFont.h) are drawn with the distance field shader instead.
+*/
+class SpriteBatch {
+
+public:
+    //!Keep in mind that the destructor will call glDelete on the vertex array if the batch was properly initialized .
+    SpriteBatch() {}
+    ~SpriteBatch();
+
+    SpriteBatch(const SpriteBatch&) = delete;
+    SpriteBatch(SpriteBatch&&)      = delete;
+    SpriteBatch& operator=(const SpriteBatch&) = delete;
+    SpriteBatch& operator=(SpriteBatch&&) = delete;
+
+    //!The batch is flushed early if more sprites than this are drawn.
+    static const unsigned int MAX_SPRITES = 4096;
+
+    void initialize();
+
+    //!Deletes the vertex array and the vertex stream, initialize creates them again.
+    void uninitialize();
+
+    //!The shader sprites drawn with distanceField are drawn with, normally gui-shader.vert and gui-sdf.frag.
+    void setDistanceFieldShader(Shader& shader) { distanceFieldShader = &shader; }
+
+    //!Starts collecting sprites for shader. If the batch was started with another shader it is flushed first.
+    void begin(Shader& shader);
+
+    //!spriteOrientationInPixels is the x, y, width and height of the sprite in the texture. The position and scale are in pixels,
+    //!with the origin at the center of the window.
+    //!distanceField is true if the texture is a signed distance field atlas, it should be filtered with GL_LINEAR.
+    void draw(
+        const Texture& texture,
+        const glm::vec4& spriteOrientationInPixels,
+        const glm::vec2& positionInPixels,
+        const glm::vec2& scaleInPixels,
+        bool distanceField = false);
+
+    //!Draws every collected sprite.
+    void end();
+
+    //!Draw calls and sprites since the last resetStatistics.
+    unsigned int getAmountOfDrawCalls() const { return amountOfDrawCalls; }
+    unsigned int getAmountOfSprites() const { return amountOfSprites; }
+
+    void resetStatistics() {
+        amountOfDrawCalls = 0;
+        amountOfSprites   = 0;
+    }
+
+private:
+    //!      !!! Be careful changing it's contents !!!         : a VAO relies on it's format.
+    struct SpriteVertex {
+        glm::vec3 position;
+        glm::vec2 textureCoordinates;
+    };
+
+    //!Consecutive sprites drawn with the same texture and shader.
+    struct Run {
+        GLuint texture           = 0;
+        GLint firstVertex        = 0;
+        GLsizei amountOfVertices = 0;
+        bool distanceField       = false;
+    };
+
+    static const unsigned int VERTICES_PER_SPRITE = 6;
+
+    void flush();
+
+    //!Uses shader's program and sets the uniforms every sprite shares.
+    void prepareShader(Shader& shader);
+
+    std::vector<SpriteVertex> vertices;
+    std::vector<Run> runs;
+
+    Shader* currentShader       = nullptr;
+    Shader* distanceFieldShader = nullptr;
+
+    StreamingBuffer vertexStream;
+    GLuint vertexArrayObject = 0;
+
+    unsigned int amountOfDrawCalls = 0;
+    unsigned int amountOfSprites   = 0;
+
+    bool initialized = false;
+};
+
+#endif
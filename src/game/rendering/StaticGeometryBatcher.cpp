@@ -0,0 +1,269 @@
+#include "StaticGeometryBatcher.h"
+
+StaticGeometryBatcher::~StaticGeometryBatcher() {
+    clear();
+}
+
+void StaticGeometryBatcher::clear() {
+    for (unsigned int i = 0; i < batches.size(); i++) {
+        Batch& batch = batches[i];
+
+        if (!batch.built) {
+            continue;
+        }
+
+        glDeleteVertexArrays(1, &batch.vertexArrayObject);
+        glDeleteVertexArrays(1, &batch.depthVertexArrayObject);
+        glDeleteBuffers(1, &batch.vertexBufferObject);
+        glDeleteBuffers(1, &batch.positionBufferObject);
+        glDeleteBuffers(1, &batch.elementBufferObject);
+    }
+
+    batches.clear();
+    amountOfMergedMeshes = 0;
+}
+
+void StaticGeometryBatcher::addModel(_3DM::Model& model, Shader& shader, int32_t owner) {
+
+    for (unsigned int i = 0; i < model.amountOfMeshes(); i++) {
+        const std::vector<glm::vec3>& vertices = *model.getMeshVertices(i);
+        const std::vector<glm::vec3>& normals  = *model.getMeshNormals(i);
+        const std::vector<glm::vec2>& uvs      = *model.getMeshUVs(i);
+        const std::vector<uint32_t>& indices   = *model.getMeshIndices(i);
+
+        if (vertices.empty() || indices.empty()) {
+            continue;
+        }
+
+        Batch& batch = findBatch(shader, *model.getMeshTextures(i));
+
+        if (batch.built) {
+            DBG_LOG("Cannot add a model to a batch that was already built (StaticGeometryBatcher.cpp addModel)\n");
+            return;
+        }
+
+        const glm::mat4 transformation = model.getMeshTransformation(i);
+        const glm::mat3 normalMatrix   = glm::transpose(glm::inverse(glm::mat3(transformation)));
+        const uint32_t baseVertex      = static_cast<uint32_t>(batch.vertices.size());
+
+        SubRange range;
+        range.firstIndex = static_cast<uint32_t>(batch.indices.size());
+        range.indexCount = static_cast<uint32_t>(indices.size());
+        range.owner      = owner;
+
+        for (unsigned int j = 0; j < vertices.size(); j++) {
+            const glm::vec3 worldVertex = glm::vec3(transformation * glm::vec4(vertices[j], 1.0f));
+
+            range.boundsMin = j == 0 ? worldVertex : glm::min(range.boundsMin, worldVertex);
+            range.boundsMax = j == 0 ? worldVertex : glm::max(range.boundsMax, worldVertex);
+
+            batch.vertices.push_back(worldVertex);
+
+            //Models without normals or uvs (such as collision meshes) still need an entry for every vertex.
+            batch.normals.push_back(j < normals.size() ? glm::normalize(normalMatrix * normals[j]) : glm::vec3(0, 1, 0));
+            batch.uvs.push_back(j < uvs.size() ? uvs[j] : glm::vec2(0));
+        }
+
+        for (unsigned int j = 0; j < indices.size(); j++) {
+            batch.indices.push_back(baseVertex + indices[j]);
+        }
+
+        batch.subRanges.push_back(range);
+        amountOfMergedMeshes++;
+    }
+}
+
+StaticGeometryBatcher::Batch& StaticGeometryBatcher::findBatch(Shader& shader, const std::vector<_3DM::ModelTexture>& textures) {
+
+    for (unsigned int i = 0; i < batches.size(); i++) {
+        Batch& batch = batches[i];
+
+        if (batch.shader->getIdentifier() != shader.getIdentifier() || batch.shader->getShaderType() != shader.getShaderType()) {
+            continue;
+        }
+
+        if (batch.textures.size() != textures.size()) {
+            continue;
+        }
+
+        bool sameTextures = true;
+
+        for (unsigned int j = 0; j < textures.size(); j++) {
+            if (batch.textures[j].texture != textures[j].texture || batch.textures[j].uniformName != textures[j].uniformName) {
+                sameTextures = false;
+                break;
+            }
+        }
+
+        if (sameTextures) {
+            return batch;
+        }
+    }
+
+    Batch batch;
+    batch.shader   = &shader;
+    batch.textures = textures;
+
+    batches.push_back(batch);
+    return batches.back();
+}
+
+void StaticGeometryBatcher::build() {
+    for (unsigned int i = 0; i < batches.size(); i++) {
+        if (!batches[i].built) {
+            buildBatch(batches[i]);
+        }
+    }
+
+    glBindVertexArray(0);
+
+    DBG_LOG("Merged %u static meshes into %u batches.\n", amountOfMergedMeshes, amountOfBatches());
+}
+
+void StaticGeometryBatcher::buildBatch(Batch& batch) {
+
+    std::vector<_3DM::PackedVertex> packedVertices(batch.vertices.size());
+
+    for (unsigned int i = 0; i < batch.vertices.size(); i++) {
+        packedVertices[i] = _3DM::VertexFormat::packVertex(batch.vertices[i], batch.normals[i], batch.uvs[i]);
+    }
+
+    glGenVertexArrays(1, &batch.vertexArrayObject);
+    glBindVertexArray(batch.vertexArrayObject);
+
+    glGenBuffers(1, &batch.vertexBufferObject);
+    glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBufferObject);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_3DM::PackedVertex) * packedVertices.size(), &packedVertices[0], GL_STATIC_DRAW);
+    _3DM::VertexFormat::setVertexAttributes();
+
+    glGenBuffers(1, &batch.elementBufferObject);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.elementBufferObject);
+    batch.indexType = _3DM::VertexFormat::uploadIndices(batch.indices, batch.vertices.size());
+
+    batch.amountOfIndices = static_cast<uint32_t>(batch.indices.size());
+
+    glGenVertexArrays(1, &batch.depthVertexArrayObject);
+    glBindVertexArray(batch.depthVertexArrayObject);
+
+    glGenBuffers(1, &batch.positionBufferObject);
+    glBindBuffer(GL_ARRAY_BUFFER, batch.positionBufferObject);
+    _3DM::VertexFormat::uploadPositions(batch.vertices);
+    _3DM::VertexFormat::setDepthVertexAttributes();
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.elementBufferObject);
+
+    //The geometry lives on the GPU now, only the sub-ranges are needed to render.
+    std::vector<glm::vec3>().swap(batch.vertices);
+    std::vector<glm::vec3>().swap(batch.normals);
+    std::vector<glm::vec2>().swap(batch.uvs);
+    std::vector<uint32_t>().swap(batch.indices);
+
+    batch.built = true;
+}
+
+bool StaticGeometryBatcher::setOwnerEnabled(int32_t owner, bool enabled) {
+    bool changed = false;
+
+    for (unsigned int i = 0; i < batches.size(); i++) {
+        Batch& batch = batches[i];
+
+        for (unsigned int j = 0; j < batch.subRanges.size(); j++) {
+            SubRange& range = batch.subRanges[j];
+
+            if (range.owner != owner || range.enabled == enabled) {
+                continue;
+            }
+
+            range.enabled = enabled;
+            changed       = true;
+
+            if (enabled) {
+                batch.amountOfDisabledRanges--;
+            } else {
+                batch.amountOfDisabledRanges++;
+            }
+        }
+    }
+
+    return changed;
+}
+
+Shader* StaticGeometryBatcher::getBatchShader(unsigned int index) const {
+    if (index >= batches.size()) {
+        DBG_LOG("This index goes out of bounds (StaticGeometryBatcher.cpp getBatchShader)\n");
+        return nullptr;
+    }
+
+    return batches[index].shader;
+}
+
+void StaticGeometryBatcher::renderBatch(unsigned int index, const OcclusionCuller* culler) {
+    if (index >= batches.size() || !batches[index].built) {
+        DBG_LOG("This index goes out of bounds or the batch was never built (StaticGeometryBatcher.cpp renderBatch)\n");
+        return;
+    }
+
+    const Batch& batch   = batches[index];
+    const bool depthOnly = Shader::isDepthTask();
+
+    glBindVertexArray(depthOnly ? batch.depthVertexArrayObject : batch.vertexArrayObject);
+
+    //The vertices are already in world space.
+    const glm::mat4 identity = glm::mat4(1.0f);
+    glUniformMatrix4fv(Shaders::getUniformLocation(batch.shader->getProgramID(), Shaders::UniformName::ModelMatrix), 1, GL_FALSE, glm::value_ptr(identity));
+
+    if (!depthOnly) {
+        bindTextures(batch);
+    }
+
+    if (!culler && batch.amountOfDisabledRanges == 0) {
+        drawRange(batch, 0, batch.amountOfIndices);
+        glBindVertexArray(0);
+        return;
+    }
+
+    //Sub-ranges are stored back to back, so neighbouring visible ranges are drawn together.
+    uint32_t runStart = 0;
+    uint32_t runCount = 0;
+
+    for (unsigned int i = 0; i < batch.subRanges.size(); i++) {
+        const SubRange& range = batch.subRanges[i];
+
+        if (range.enabled && (!culler || culler->isVisible(range.boundsMin, range.boundsMax, identity))) {
+            if (runCount == 0) {
+                runStart = range.firstIndex;
+            }
+            runCount += range.indexCount;
+            continue;
+        }
+
+        if (runCount > 0) {
+            drawRange(batch, runStart, runCount);
+            runCount = 0;
+        }
+    }
+
+    if (runCount > 0) {
+        drawRange(batch, runStart, runCount);
+    }
+
+    glBindVertexArray(0);
+}
+
+void StaticGeometryBatcher::drawRange(const Batch& batch, uint32_t firstIndex, uint32_t indexCount) {
+    const size_t indexSize = batch.indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    glDrawElements(GL_TRIANGLES, indexCount, batch.indexType, reinterpret_cast<void*>(indexSize * firstIndex));
+    amountOfDrawCalls++;
+}
+
+void StaticGeometryBatcher::bindTextures(const Batch& batch) {
+    for (GLuint j = 0; j < batch.textures.size(); j++) {
+
+        glActiveTexture(GL_TEXTURE0 + j);
+
+        glUniform1i(glGetUniformLocation(batch.shader->getProgramID(), batch.textures[j].uniformName.c_str()), j);
+
+        glBindTexture(GL_TEXTURE_2D, TextureLocator::getService().getTextureData(batch.textures[j].texture));
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef STATIC_GEOMETRY_BATCHER_H
+#define STATIC_GEOMETRY_BATCHER_H
+
+#include "Debug.h"
+#include "Model.h"
+#include "OcclusionCuller.h"
+#include "Shader.h"
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+/*!The StaticGeometryBatcher merges the meshes of static models into as few draws as possible when a scene loads.
+
+Every mesh that shares a shader and textures with another is pre-transformed to world space and appended
+to the same vertex and index buffers, using the packed vertex format from VertexFormat.h. The index range of every
+source mesh is kept along with its world space bounds so meshes can still be occlusion culled, with neighbouring
+visible ranges drawn together.
+*/
+class StaticGeometryBatcher {
+
+public:
+    //!Keep in mind that the destructor will call glDelete on the buffers of every batch.
+    StaticGeometryBatcher() {}
+    ~StaticGeometryBatcher();
+
+    StaticGeometryBatcher(const StaticGeometryBatcher&) = delete;
+    StaticGeometryBatcher(StaticGeometryBatcher&&)      = delete;
+    StaticGeometryBatcher& operator=(const StaticGeometryBatcher&) = delete;
+    StaticGeometryBatcher& operator=(StaticGeometryBatcher&&) = delete;
+
+    //!Appends every mesh of the model to the batch matching its shader and textures.
+    //!The model should already be initialized so its textures are loaded. owner identifies its meshes for setOwnerEnabled.
+    void addModel(_3DM::Model& model, Shader& shader, int32_t owner);
+
+    //!Leaves every mesh added with owner out of the draws while it is disabled, such as while its entity is inactive.
+    //!Returns true if any mesh changed.
+    bool setOwnerEnabled(int32_t owner, bool enabled);
+
+    //!Uploads every batch to the GPU and frees the merged CPU side geometry. Should be called after every model is added.
+    void build();
+
+    //!Deletes every batch. Called when a new scene loads.
+    void clear();
+
+    unsigned int amountOfBatches() const { return static_cast<unsigned int>(batches.size()); }
+
+    //!Retrieves the shader the batch at index must be rendered with.
+    Shader* getBatchShader(unsigned int index) const;
+
+    //!Renders the batch at index. The shader should already be in use, with its uniforms supplied.
+    //!If culler is not null, meshes that fail its occlusion test are left out of the draw.
+    //!During a depth task only the positions are read and no textures are bound.
+    void renderBatch(unsigned int index, const OcclusionCuller* culler);
+
+    //!Amount of source meshes merged into the batches.
+    unsigned int getAmountOfMergedMeshes() const { return amountOfMergedMeshes; }
+
+    //!Amount of draw calls since the last call to resetStatistics.
+    unsigned int getAmountOfDrawCalls() const { return amountOfDrawCalls; }
+    void resetStatistics() { amountOfDrawCalls = 0; }
+
+private:
+    //!The part of a batch's index buffer that came from one source mesh.
+    struct SubRange {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        glm::vec3 boundsMin = glm::vec3(0);
+        glm::vec3 boundsMax = glm::vec3(0);
+        int32_t owner       = -1;
+        bool enabled        = true;
+    };
+
+    struct Batch {
+        Shader* shader = nullptr;
+        std::vector<_3DM::ModelTexture> textures;
+        std::vector<SubRange> subRanges;
+
+        //Only kept until the batch is built.
+        std::vector<glm::vec3> vertices;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> uvs;
+        std::vector<uint32_t> indices;
+
+        uint32_t amountOfIndices = 0;
+        GLenum indexType         = GL_UNSIGNED_INT;
+
+        //!While every range is enabled and nothing is culled, the batch is drawn with one draw.
+        unsigned int amountOfDisabledRanges = 0;
+
+        GLuint vertexArrayObject   = 0;
+        GLuint vertexBufferObject  = 0;
+        GLuint elementBufferObject = 0;
+
+        //Positions alone, for the depth passes.
+        GLuint depthVertexArrayObject = 0;
+        GLuint positionBufferObject   = 0;
+
+        bool built = false;
+    };
+
+    //!Retrieves the batch drawn with shader and textures, creating it if it doesn't exist yet.
+    Batch& findBatch(Shader& shader, const std::vector<_3DM::ModelTexture>& textures);
+
+    void buildBatch(Batch& batch);
+    void bindTextures(const Batch& batch);
+    void drawRange(const Batch& batch, uint32_t firstIndex, uint32_t indexCount);
+
+    std::vector<Batch> batches;
+
+    unsigned int amountOfMergedMeshes = 0;
+    unsigned int amountOfDrawCalls    = 0;
+};
+
+#endif
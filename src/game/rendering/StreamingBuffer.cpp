@@ -0,0 +1,165 @@
+#include "StreamingBuffer.h"
+
+const unsigned int StreamingBuffer::AMOUNT_OF_SECTIONS;
+const GLsizeiptr StreamingBuffer::ALIGNMENT;
+
+void StreamingBuffer::initialize(GLsizeiptr size) {
+    if (initialized) {
+        DBG_LOG("The streaming buffer is already initialized (StreamingBuffer.cpp initialize)\n");
+        return;
+    }
+
+    sectionSize = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    persistent  = GLEW_ARB_buffer_storage;
+
+    const GLsizeiptr bufferSize = sectionSize * AMOUNT_OF_SECTIONS;
+
+    glGenBuffers(1, &bufferObject);
+    glBindBuffer(GL_ARRAY_BUFFER, bufferObject);
+
+    if (persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glBufferStorage(GL_ARRAY_BUFFER, bufferSize, nullptr, flags);
+        mappedMemory = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferSize, flags));
+
+        //Immutable storage can't be respecified, so the unsynchronized path gets a new buffer.
+        if (!mappedMemory) {
+            DBG_LOG("Failed to persistently map the streaming buffer, mapping every write instead (StreamingBuffer.cpp initialize)\n");
+            glDeleteBuffers(1, &bufferObject);
+            glGenBuffers(1, &bufferObject);
+            glBindBuffer(GL_ARRAY_BUFFER, bufferObject);
+            persistent = false;
+        }
+    }
+
+    if (!persistent) {
+        glBufferData(GL_ARRAY_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    initialized = true;
+}
+
+StreamingBuffer::~StreamingBuffer() {
+    if (!initialized) {
+        return;
+    }
+
+    release();
+}
+
+void StreamingBuffer::resize(GLsizeiptr size) {
+    if (initialized) {
+        release();
+    }
+
+    initialize(size);
+}
+
+void StreamingBuffer::release() {
+    if (!initialized) {
+        return;
+    }
+
+    for (unsigned int i = 0; i < AMOUNT_OF_SECTIONS; i++) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+            fences[i] = nullptr;
+        }
+    }
+
+    //Deleting the buffer also unmaps it. Draws that still read from it keep its storage alive.
+    glDeleteBuffers(1, &bufferObject);
+
+    bufferObject   = 0;
+    mappedMemory   = nullptr;
+    offset         = 0;
+    head           = 0;
+    currentSection = 0;
+    mapped         = false;
+    initialized    = false;
+}
+
+void* StreamingBuffer::allocate(GLsizeiptr bytes) {
+    if (!initialized) {
+        DBG_LOG("Please initialize the streaming buffer before allocating from it (StreamingBuffer.cpp allocate)\n");
+        return nullptr;
+    }
+    if (bytes > sectionSize) {
+        DBG_LOG("The allocation is larger than a section of the streaming buffer (StreamingBuffer.cpp allocate)\n");
+        return nullptr;
+    }
+    if (mapped) {
+        commit();
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, bufferObject);
+
+    offset = (head + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    if (persistent) {
+        if (offset + bytes > sectionSize * (currentSection + 1)) {
+            nextSection();
+            offset = sectionSize * currentSection;
+        }
+
+        head   = offset + bytes;
+        mapped = true;
+
+        return mappedMemory + offset;
+    }
+
+    //The driver gives the buffer new storage once it is full, the draws reading the old storage keep it alive.
+    if (offset + bytes > sectionSize * AMOUNT_OF_SECTIONS) {
+        glBufferData(GL_ARRAY_BUFFER, sectionSize * AMOUNT_OF_SECTIONS, nullptr, GL_STREAM_DRAW);
+        offset = 0;
+    }
+
+    void* memory = glMapBufferRange(GL_ARRAY_BUFFER, offset, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+    if (!memory) {
+        DBG_LOG("Failed to map the streaming buffer (StreamingBuffer.cpp allocate)\n");
+        return nullptr;
+    }
+
+    head   = offset + bytes;
+    mapped = true;
+
+    return memory;
+}
+
+void StreamingBuffer::commit() {
+    if (!mapped) {
+        return;
+    }
+
+    //Persistent memory is coherent, so there is nothing to flush.
+    if (!persistent) {
+        glBindBuffer(GL_ARRAY_BUFFER, bufferObject);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    mapped = false;
+}
+
+void StreamingBuffer::nextSection() {
+    fences[currentSection] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    currentSection         = (currentSection + 1) % AMOUNT_OF_SECTIONS;
+
+    GLsync& fence = fences[currentSection];
+
+    if (!fence) {
+        return;
+    }
+
+    //Only stalls if the GPU is more than two sections behind.
+    GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (glClientWaitSync(fence, waitFlags, 1000000) == GL_TIMEOUT_EXPIRED) {
+        waitFlags = 0;
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
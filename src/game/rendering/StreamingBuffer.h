@@ -0,0 +1,84 @@
+#ifndef STREAMING_BUFFER_H
+#define STREAMING_BUFFER_H
+
+#include "Debug.h"
+#include <GL/glew.h>
+
+/*!The StreamingBuffer is a ring buffer for vertex data that is rewritten every frame.
+
+The buffer is split into three sections so the CPU can write into one while the GPU still reads from the others.
+If ARB_buffer_storage is available the whole buffer stays persistently mapped, and a fence guards every section so
+a section is only written once the GPU is done with it. Otherwise, or if the persistent map fails, each write maps a
+range unsynchronized, and the buffer is orphaned once it is full so the driver hands back fresh memory instead of
+stalling.
+
+Usage: allocate, write the data into the returned pointer, commit, then point the attributes at getOffset.
+*/
+class StreamingBuffer {
+
+public:
+    //!Keep in mind that the destructor will call glDelete on the buffer if it was properly initialized.
+    StreamingBuffer() {}
+    ~StreamingBuffer();
+
+    StreamingBuffer(const StreamingBuffer&) = delete;
+    StreamingBuffer(StreamingBuffer&&)      = delete;
+    StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+    StreamingBuffer& operator=(StreamingBuffer&&) = delete;
+
+    //!Creates the buffer. sectionSize is the most bytes a single allocation can take.
+    void initialize(GLsizeiptr sectionSize);
+
+    //!Recreates the buffer with bigger sections. Pointers returned by allocate are invalidated.
+    void resize(GLsizeiptr sectionSize);
+
+    //!Deletes the buffer and its fences. It can be initialized again afterwards.
+    void release();
+
+    //!Binds the buffer to GL_ARRAY_BUFFER and returns a pointer bytes can be written to, or nullptr if they don't fit.
+    //!The pointer is only valid until commit is called.
+    void* allocate(GLsizeiptr bytes);
+
+    //!Finishes writing the last allocation. The buffer is left bound to GL_ARRAY_BUFFER.
+    void commit();
+
+    //!Offset of the last allocation into the buffer, to be used with glVertexAttribPointer.
+    GLintptr getOffset() const { return offset; }
+
+    GLuint getBufferObject() const { return bufferObject; }
+
+    //!The most bytes a single allocation can take.
+    GLsizeiptr getSectionSize() const { return sectionSize; }
+
+    bool isInitialized() const { return initialized; }
+
+    //!True if the buffer is persistently mapped.
+    bool isPersistent() const { return persistent; }
+
+private:
+    static const unsigned int AMOUNT_OF_SECTIONS = 3;
+
+    //!Attribute offsets must be aligned, 16 bytes is enough for any of them.
+    static const GLsizeiptr ALIGNMENT = 16;
+
+    //!Fences the section in use and moves to the next one, waiting for the GPU if it still reads from it.
+    void nextSection();
+
+    GLuint bufferObject = 0;
+
+    GLsizeiptr sectionSize = 0;
+    GLintptr offset        = 0;
+    GLintptr head          = 0;
+
+    unsigned int currentSection = 0;
+
+    //!Only used when persistently mapped.
+    GLsync fences[AMOUNT_OF_SECTIONS] = {};
+    char* mappedMemory                = nullptr;
+
+    bool persistent  = false;
+    bool mapped      = false;
+    bool initialized = false;
+};
+
+#endif
@@ -100,6 +100,9 @@ void FixedUpdatingSystem::fixedUpdate(Engine::SystemVitals& sv) {
             case PARTICLE_TYPE::Fountain:
                 systems->fountainParticleSystem.fixedUpdateParticles(*particles);
                 break;
+            case PARTICLE_TYPE::GpuFountain:
+                systems->gpuParticleSystem.fixedUpdateParticles(*particles);
+                break;
             }
         }
 
@@ -132,7 +135,7 @@ bool FixedUpdatingSystem::updateGUI(const Time& time, Engine::SystemVitals& sv)
         }
 
         if (DisplayStatistics* stats = currentScene->getComponent<DisplayStatistics>(entity.id)) {
-            systems->displayStatisticsSystem.fixedUpdate(*stats, time, systems->guiResizingInfo);
+            systems->displayStatisticsSystem.fixedUpdate(*stats, time, sv.getGpuProfiler(), systems->guiResizingInfo);
         }
 
         return false;
@@ -155,23 +158,27 @@ void FixedUpdatingSystem::updateShadowMaps(Camera& currentCamera, Engine::System
         [&](const DirectionalLight& light) {
             if (light.isActive()) {
                 directionalLightDepthMap.setCurrentLightDirection(light.direction);
-                directionalLightDepthMap.updateDepthMap(currentCamera);
                 directionalLightDepthMap.setShadowActive(true);
                 return true; //perform on first light
             }
             return false;
         });
 
-    currentScene->performOperationsOnAllOfType<PointLight>(
-        [&](const PointLight& light) {
-            if (light.isActive()) {
-                pointLightDepthMap.setCurrentLightPosition(light.position);
-                pointLightDepthMap.setShadowActive(true);
-                pointLightDepthMap.updateDepthMap();
-                return true; //perform on first light
-            }
-            return false;
-        });
+    //Lights are given atlas slots in the same order RenderingSystem::initializeLights gives them shader indices.
+    const std::vector<PointLight*> pointLights = currentScene->getAllComponentsOfType<PointLight>();
+    const unsigned int lightsPerEntity         = sv.getSettings().getLightsPerEntity();
+    const unsigned int maxShadowedLights       = lightsPerEntity < PointLightShadowMap::MAX_LIGHTS ? lightsPerEntity : PointLightShadowMap::MAX_LIGHTS;
+    unsigned int amountOfShadowedLights        = 0;
+
+    for (unsigned int i = 0; i < pointLights.size() && amountOfShadowedLights < maxShadowedLights; i++) {
+        if (pointLights[i]->isActive()) {
+            pointLightDepthMap.setLightPosition(amountOfShadowedLights, pointLights[i]->position);
+            amountOfShadowedLights++;
+        }
+    }
+
+    pointLightDepthMap.setAmountOfLights(amountOfShadowedLights);
+    pointLightDepthMap.setShadowActive(amountOfShadowedLights > 0);
 }
 
 //!Set transforms of models to collision transforms
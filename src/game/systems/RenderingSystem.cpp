@@ -5,6 +5,9 @@ void RenderingSystem::initialize(Scene& scene, Engine::SystemVitals& sv, SubSyst
     systemVitals = &sv;
     systems      = &ssystems;
 
+    staticGeometry.clear();
+    staticOwners.clear();
+
     currentScene->loopEntities([&](const Scene::Entity& entity) {
         if (SkyBox* skyBox = currentScene->getComponent<SkyBox>(entity.id)) {
             systems->skyBoxSystem.init(*skyBox);
@@ -32,9 +35,49 @@ void RenderingSystem::initialize(Scene& scene, Engine::SystemVitals& sv, SubSyst
         return false;
     });
 
+    //These outlive scenes. Only the first scene load initializes them, later calls return right away.
+    instancedRenderer.initialize();
+    bonePalettes.initialize();
+    spriteBatch.initialize();
+
+    //Every scene starts at the best quality.
+    dynamicResolution.initialize(RenderTextureMS::getMaxMultisample());
+
+    debugTextShader = ShaderLocator::getService().getShader("ui", sv.getSettings(), "assets/shaders/gui-shader.vert", "assets/shaders/gui-shader.frag", SHADER_TYPE::GUI);
+
+    distanceFieldShader = ShaderLocator::getService().getShader("ui-sdf", sv.getSettings(), "assets/shaders/gui-shader.vert", "assets/shaders/gui-sdf.frag", SHADER_TYPE::GUI);
+    spriteBatch.setDistanceFieldShader(distanceFieldShader);
+
+    //The font is asked for again every scene, so the last scene's reference is given back first.
+    //Debug text is drawn at every distance, so it uses the distance field font, which stays sharp when scaled.
+    releaseDebugTextFont();
+    debugTextFont = &TextureLocator::getService().getTexture("assets/fonts/courier-new-sdf.png", GL_LINEAR);
+    debugTextString.initialize(sv.getSdfTextMap(), *debugTextFont);
+    debugTextString.setDistanceField(true);
+
+    initializeStaticGeometry();
+
+    //The new scene's static casters have to be rendered into the shadow caches again.
+    sv.getPointShadowMap().invalidateStaticCache();
+    sv.getDirectionalShadowMap().invalidateStaticCache();
+
     screenShader = ShaderLocator::getService().getShader("screen", "assets/shaders/render-texture.vert", "assets/shaders/render-texture-ms.frag", SHADER_TYPE::Default);
 }
 
+void RenderingSystem::uninitialize() {
+    releaseDebugTextFont();
+    spriteBatch.uninitialize();
+}
+
+void RenderingSystem::releaseDebugTextFont() {
+    if (!debugTextFont) {
+        return;
+    }
+
+    TextureLocator::getService().releaseTexture(debugTextFont->getHandle());
+    debugTextFont = nullptr;
+}
+
 void RenderingSystem::initializeLights(Shader& litShader, Engine::SystemVitals& sv) {
 
     Settings& currentSettings = sv.getSettings();
@@ -74,6 +117,61 @@ void RenderingSystem::initializeModels(Shader& shader, const int32_t& entity) {
     }
 }
 
+//Merges every static model into the static geometry batches. Models must be initialized first so their textures are loaded.
+void RenderingSystem::initializeStaticGeometry() {
+    currentScene->loopEntities([&](const Scene::Entity& entity) {
+        _3DM::Model* model = currentScene->getComponent<_3DM::Model>(entity.id);
+        Shader* shdr       = currentScene->getComponent<Shader>(entity.id);
+
+        if (!model || !shdr || !model->isStatic()) {
+            return false;
+        }
+
+        if (shdr->getShaderType() == SHADER_TYPE::Lit || shdr->getShaderType() == SHADER_TYPE::Default) {
+            staticGeometry.addModel(*model, *shdr, entity.id);
+
+            //Inactive entities are merged too, so they can be turned on later without rebuilding the batches.
+            StaticOwner owner;
+            owner.entity  = entity.id;
+            owner.enabled = true;
+            staticOwners.push_back(owner);
+        }
+
+        //The batches own a world space copy of the geometry now.
+        if (!model->isKeepingGeometry()) {
+            model->releaseGeometry();
+        }
+
+        return false;
+    });
+
+    staticGeometry.build();
+}
+
+void RenderingSystem::updateStaticGeometryOwners(Engine::SystemVitals& sv) {
+    bool changed = false;
+
+    for (unsigned int i = 0; i < staticOwners.size(); i++) {
+        StaticOwner& owner = staticOwners[i];
+        _3DM::Model* model = currentScene->getComponent<_3DM::Model>(owner.entity);
+
+        const bool active = model && currentScene->isEntityActive(owner.entity) && model->isActive();
+
+        if (active == owner.enabled) {
+            continue;
+        }
+
+        owner.enabled = active;
+        changed |= staticGeometry.setOwnerEnabled(owner.entity, active);
+    }
+
+    //The cached shadows still hold the meshes that changed.
+    if (changed) {
+        sv.getPointShadowMap().invalidateStaticCache();
+        sv.getDirectionalShadowMap().invalidateStaticCache();
+    }
+}
+
 void RenderingSystem::render(Engine::SystemVitals& sv) {
 
     /******************************************|
@@ -89,6 +187,7 @@ void RenderingSystem::render(Engine::SystemVitals& sv) {
     PhysicsWorld& physics                           = sv.getPhysicsWorld();
     GameState& gameState                            = sv.getGameState();
     RenderTextureMS& renderTexture                  = sv.getRenderTexture();
+    GpuProfiler& profiler                           = sv.getGpuProfiler();
 
     if (areVitalsNull()) {
         DBG_LOG("Vitals are null (RenderingSystem.cpp)\n");
@@ -102,7 +201,15 @@ void RenderingSystem::render(Engine::SystemVitals& sv) {
 
     const std::vector<Shader*> shaders = currentScene->getAllComponentsOfType<Shader>();
 
+    updateRenderResolution(sv);
+    profiler.beginFrame();
+
     Shader::setShaderTask(SHADER_TASK::Normal_Render_Task);
+
+    //Batches are grouped by the normal program, and are shared by every pass of the frame.
+    updateModelBatches();
+    updateStaticGeometryOwners(sv);
+    requestTextureSizes(*currentCamera);
     for (unsigned int i = 0; i < shaders.size(); i++) {
         if (shaders.at(i)->getShaderType() != SHADER_TYPE::Lit) {
             continue;
@@ -117,12 +224,23 @@ void RenderingSystem::render(Engine::SystemVitals& sv) {
 
         //Uses shader for depth when getProgramID is called.
         Shader::setShaderTask(SHADER_TASK::Omnidirectional_Depth_Task);
+        profiler.beginPass(GPU_PASS::PointShadows);
 
-        glViewport(0, 0, pointShadowMap.getDepthMapWidth(), pointShadowMap.getDepthMapHeight());
+        pointShadowMap.scheduleFaces(*currentCamera);
 
-        glBindFramebuffer(GL_FRAMEBUFFER, pointShadowMap.getFBO());
-        glClear(GL_DEPTH_BUFFER_BIT);
-        renderAll(*currentCamera, sv);
+        //Only the faces picked by the scheduler are rendered, and static casters only when their cached depth is outdated.
+        for (unsigned int i = 0; i < pointShadowMap.getAmountOfLights(); i++) {
+            if (!pointShadowMap.hasScheduledFaces(i)) {
+                continue;
+            }
+
+            if (pointShadowMap.beginStaticPass(i)) {
+                renderStaticGeometry(*currentCamera, sv);
+            }
+
+            pointShadowMap.beginDynamicPass(i);
+            renderModels(*currentCamera, sv);
+        }
     }
 
     //If the directional light depth map is active, render to it.
@@ -130,26 +248,46 @@ void RenderingSystem::render(Engine::SystemVitals& sv) {
 
         //Uses shader for depth when getProgramID is called.
         Shader::setShaderTask(SHADER_TASK::Directional_Depth_Task);
+        profiler.beginPass(GPU_PASS::DirectionalShadows);
 
-        glViewport(0, 0, directionalShadowMap.getDepthMapWidth(), directionalShadowMap.getDepthMapHeight());
+        directionalShadowMap.scheduleCascades(*currentCamera);
 
-        glBindFramebuffer(GL_FRAMEBUFFER, directionalShadowMap.getFBO());
-        glClear(GL_DEPTH_BUFFER_BIT);
-        renderAll(*currentCamera, sv);
+        //Casters outside of a cascade are skipped with the cascade's culler.
+        for (unsigned int i = 0; i < DirectionalLightShadowMap::AMOUNT_OF_CASCADES; i++) {
+            if (!directionalShadowMap.isCascadeScheduled(i)) {
+                continue;
+            }
+
+            cascadeCuller = &directionalShadowMap.getCascadeCuller(i);
+
+            if (directionalShadowMap.beginStaticPass(i)) {
+                renderStaticGeometry(*currentCamera, sv);
+            }
+
+            directionalShadowMap.beginDynamicPass(i);
+            renderModels(*currentCamera, sv);
+        }
+
+        cascadeCuller = nullptr;
     }
 
     //Use normal shaders
     Shader::setShaderTask(SHADER_TASK::Normal_Render_Task);
+    profiler.endPass();
+
+    updateOcclusionCulling(*currentCamera);
 
     //Render everything to texture.
     {
         glViewport(0, 0, renderTexture.getWidth(), renderTexture.getHeight());
 
+        profiler.beginPass(GPU_PASS::Main);
         glBindFramebuffer(GL_FRAMEBUFFER, renderTexture.getFBO());
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         renderAll(*currentCamera, sv);
 
         //Multisample :)
+        profiler.beginPass(GPU_PASS::MultisampleBlit);
         glBlitFramebuffer(0, 0,
                           renderTexture.getWidth(), renderTexture.getHeight(),
                           0, 0, renderTexture.getWidth(), renderTexture.getHeight(),
@@ -159,6 +297,7 @@ void RenderingSystem::render(Engine::SystemVitals& sv) {
     //Render texture to quad.
     {
         glViewport(0, 0, GameInfo::getWindowWidth(), GameInfo::getWindowHeight());
+        profiler.beginPass(GPU_PASS::ScreenResolve);
         //don't override getProgramID when it's called.
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glDisable(GL_DEPTH_TEST);
@@ -166,14 +305,57 @@ void RenderingSystem::render(Engine::SystemVitals& sv) {
 
         screenShader.useProgram();
         glUniform1i(Shaders::getUniformLocation(screenShader.getProgramID(), Shaders::UniformName::MultisampleCount), renderTexture.getCurrentMultisampleCount());
+        glUniform1f(Shaders::getUniformLocation(screenShader.getProgramID(), Shaders::UniformName::RenderScale), dynamicResolution.getScale());
         screenQuad.render2D(screenShader, renderTexture.getTextureID(), GL_TEXTURE_2D_MULTISAMPLE);
     }
+
+    profiler.endFrame();
+}
+
+void RenderingSystem::updateRenderResolution(Engine::SystemVitals& sv) {
+    RenderTextureMS& renderTexture = sv.getRenderTexture();
+    GpuProfiler& profiler          = sv.getGpuProfiler();
+    const Settings& settings       = sv.getSettings();
+
+    double frameMilliseconds = 0.0;
+    bool measured            = false;
+
+    //Without timer queries the CPU frame time has to do, even though it also counts time the GPU spent idle.
+    if (profiler.isInitialized()) {
+        measured          = profiler.collect();
+        frameMilliseconds = profiler.getFrameMilliseconds();
+    } else {
+        frameMilliseconds = sv.getTime().getMSPF();
+        measured          = frameMilliseconds > 0.0;
+    }
+
+    if (!settings.isDynamicResolutionEnabled()) {
+        dynamicResolution.reset();
+    } else if (measured) {
+        if (dynamicResolution.getTargetFrameRate() != settings.getTargetFrameRate()) {
+            dynamicResolution.setTargetFrameRate(settings.getTargetFrameRate());
+        }
+
+        dynamicResolution.update(frameMilliseconds);
+    }
+
+    const float scale          = dynamicResolution.getScale();
+    const unsigned int width   = std::max(1u, static_cast<unsigned int>(GameInfo::getWindowWidth() * scale + 0.5f));
+    const unsigned int height  = std::max(1u, static_cast<unsigned int>(GameInfo::getWindowHeight() * scale + 0.5f));
+    const unsigned int samples = dynamicResolution.getSamples();
+
+    //Also follows the window when it is resized.
+    if (width != renderTexture.getWidth() || height != renderTexture.getHeight() || samples != static_cast<unsigned int>(renderTexture.getCurrentMultisampleCount())) {
+        renderTexture.resize(width, height, samples);
+    }
 }
 
 void RenderingSystem::renderAll(Camera& currentCamera, Engine::SystemVitals& sv) {
 
-    renderDebugging(currentCamera, sv);
     renderModels(currentCamera, sv);
+    renderStaticGeometry(currentCamera, sv);
+    //After the geometry so overlay lines are drawn on top of it, and before the gui.
+    renderDebugging(currentCamera, sv);
     renderOthers(currentCamera, sv);
 }
 
@@ -192,54 +374,280 @@ void RenderingSystem::renderDebugging(Camera& currentCamera, Engine::SystemVital
 
     systems->dayNightCycleSystem.debugRender(physicsWorld);
     systems->debuggingSystem.executeDebugRendering(physicsWorld, *currentCamera.getViewMatrix(), *currentCamera.getProjectionMatrix());
+
+    if (physicsWorld.isDebugDrawing()) {
+        renderDebugText(physicsWorld.getDebugDrawer(), currentCamera);
+    }
+
+    //Debug drawing is immediate, whatever was added this frame is dropped even if it wasn't drawn.
+    physicsWorld.getDebugDrawer().clear();
 }
 
-void RenderingSystem::renderModels(Camera& currentCamera, Engine::SystemVitals& sv) {
+void RenderingSystem::renderDebugText(const Engine::DebugDrawer& debugDrawer, Camera& currentCamera) {
+    const std::vector<Engine::DebugText>& texts = debugDrawer.getTexts();
 
+    if (texts.empty()) {
+        return;
+    }
+
+    const glm::mat4 viewProjection = *currentCamera.getProjectionMatrix() * *currentCamera.getViewMatrix();
+    const glm::vec2 windowSize     = glm::vec2(GameInfo::getWindowWidth(), GameInfo::getWindowHeight());
+
+    spriteBatch.begin(debugTextShader);
+
+    for (const Engine::DebugText& debugText : texts) {
+        const glm::vec4 clipPosition = viewProjection * glm::vec4(debugText.position, 1.0f);
+
+        //Behind the camera.
+        if (clipPosition.w <= 0.0f) {
+            continue;
+        }
+
+        //Gui positions are in pixels, with the origin at the center of the screen.
+        debugTextString.setPosition(glm::vec2(clipPosition.x, clipPosition.y) / clipPosition.w * windowSize);
+        debugTextString.render(spriteBatch, debugText.text);
+    }
+
+    spriteBatch.end();
+}
+
+//Rebuilds the model batches and uploads the bone palettes of every animated model. Called once per frame, before any pass.
+void RenderingSystem::updateModelBatches() {
+
+    modelBatches.clear();
+
+    //Group models that share a shader and were loaded from the same file so they can be drawn instanced.
     currentScene->loopEntities([&](const Scene::Entity& entity) {
         if (!entity.isActive) {
             return false;
         }
 
-        ModelBase* modelToRender = nullptr;
-        bool isAnimated          = false;
+        Shader* shdr = currentScene->getComponent<Shader>(entity.id);
 
-        if (_3DM::Model* model = currentScene->getComponent<_3DM::Model>(entity.id)) {
-            modelToRender = model;
-
-        } else if (_3DM::AnimatedModel* animatedModel = currentScene->getComponent<_3DM::AnimatedModel>(entity.id)) {
-            modelToRender = animatedModel;
-            isAnimated    = true;
+        if (!shdr || (shdr->getShaderType() != SHADER_TYPE::Lit && shdr->getShaderType() != SHADER_TYPE::Default)) {
+            return false;
         }
 
-        if (!modelToRender) {
+        _3DM::Model* model                 = currentScene->getComponent<_3DM::Model>(entity.id);
+        _3DM::AnimatedModel* animatedModel = model ? nullptr : currentScene->getComponent<_3DM::AnimatedModel>(entity.id);
+
+        //Static models are drawn through the static geometry batches.
+        if ((!model && !animatedModel) || (model && model->isStatic())) {
             return false;
         }
 
-        if (Shader* shdr = currentScene->getComponent<Shader>(entity.id)) {
+        for (unsigned int i = 0; i < modelBatches.size(); i++) {
+            ModelBatch& batch = modelBatches[i];
 
-            if (shdr->getShaderType() == SHADER_TYPE::Lit) {
+            if (batch.shader->getProgramID() != shdr->getProgramID() || batch.shader->getShaderType() != shdr->getShaderType()) {
+                continue;
+            }
 
-                shdr->useProgram();
-                supplyLitShaderUniforms(*shdr, currentCamera, sv);
-                glUniform1i(Shaders::getUniformLocation(shdr->getProgramID(), Shaders::UniformName::IsModelAnimated), isAnimated);
+            if (model && !batch.models.empty() && batch.models[0]->canInstanceWith(*model)) {
+                batch.models.push_back(model);
+                return false;
+            }
 
-                modelToRender->renderAll(*shdr);
+            if (animatedModel && !batch.animatedModels.empty() && batch.animatedModels[0]->canInstanceWith(*animatedModel)) {
+                batch.animatedModels.push_back(animatedModel);
+                return false;
             }
+        }
+
+        ModelBatch batch;
+        batch.shader = shdr;
+
+        if (model) {
+            batch.models.push_back(model);
+        } else {
+            batch.animatedModels.push_back(animatedModel);
+        }
 
-            if (shdr->getShaderType() == SHADER_TYPE::Default) {
+        modelBatches.push_back(batch);
 
-                shdr->useProgram();
-                supplyDefaultShaderUniforms(*shdr, currentCamera, sv);
+        return false;
+    });
 
-                glUniform1i(Shaders::getUniformLocation(shdr->getProgramID(), Shaders::UniformName::IsModelAnimated), isAnimated);
+    //Palettes are added in batch order so the instances of a batch have contiguous palettes.
+    bonePalettes.clear();
 
-                modelToRender->renderAll(*shdr);
+    for (unsigned int i = 0; i < modelBatches.size(); i++) {
+        std::vector<_3DM::AnimatedModel*>& animatedModels = modelBatches[i].animatedModels;
+
+        for (unsigned int j = 0; j < animatedModels.size(); j++) {
+            animatedModels[j]->setBonePaletteOffset(bonePalettes.addPalette(animatedModels[j]->getBoneTransformations()));
+        }
+    }
+
+    bonePalettes.upload();
+}
+
+void RenderingSystem::requestTextureSizes(Camera& currentCamera) {
+
+    const glm::vec3 cameraPosition = glm::vec3(glm::inverse(*currentCamera.getViewMatrix())[3]);
+
+    //Pixels covered by one unit one unit away from the camera.
+    const float pixelsPerUnit = (*currentCamera.getProjectionMatrix())[1][1] * GameInfo::getWindowHeight() * 0.5f;
+
+    TextureHandler& textures = TextureLocator::getService();
+
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+
+    //Animated models have no bounds, their textures are never reported and stay at full resolution.
+    for (unsigned int i = 0; i < modelBatches.size(); i++) {
+        for (_3DM::Model* model : modelBatches[i].models) {
+            for (unsigned int j = 0; j < model->amountOfMeshes(); j++) {
+                if (!model->getMeshBounds(j, boundsMin, boundsMax)) {
+                    continue;
+                }
+
+                const glm::mat4 transformation = model->getMeshTransformation(j);
+                const glm::vec3 center         = glm::vec3(transformation * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+                const float radius             = glm::length(glm::mat3(transformation) * ((boundsMax - boundsMin) * 0.5f));
+                const float distance           = std::max(glm::length(center - cameraPosition) - radius, currentCamera.getNearPlane());
+
+                const float sizeInPixels = 2.0f * radius / distance * pixelsPerUnit;
+
+                for (const _3DM::ModelTexture& texture : *model->getMeshTextures(j)) {
+                    textures.requestTextureSize(texture.texture, sizeInPixels);
+                }
             }
         }
+    }
+}
 
-        return false;
-    });
+void RenderingSystem::renderModels(Camera& currentCamera, Engine::SystemVitals& sv) {
+
+    for (unsigned int i = 0; i < modelBatches.size(); i++) {
+        renderModelBatch(modelBatches[i], currentCamera, sv);
+    }
+}
+
+void RenderingSystem::renderStaticGeometry(Camera& currentCamera, Engine::SystemVitals& sv) {
+
+    const OcclusionCuller* culler = getActiveCuller();
+
+    for (unsigned int i = 0; i < staticGeometry.amountOfBatches(); i++) {
+        Shader& shdr = *staticGeometry.getBatchShader(i);
+
+        shdr.selectVariant(getShadowVariant(sv));
+        shdr.useProgram();
+        supplyModelShaderUniforms(shdr, currentCamera, sv);
+
+        staticGeometry.renderBatch(i, culler);
+    }
+}
+
+void RenderingSystem::renderModelBatch(ModelBatch& batch, Camera& currentCamera, Engine::SystemVitals& sv) {
+
+    Shader& shdr                   = *batch.shader;
+    const bool isAnimated          = !batch.animatedModels.empty();
+    const size_t amountOfInstances = isAnimated ? batch.animatedModels.size() : batch.models.size();
+
+    Shaders::ShaderVariant variant = getShadowVariant(sv);
+
+    if (isAnimated) {
+        variant |= Shaders::getFeatureBit(Shaders::SHADER_FEATURE::Animated);
+    }
+    if (amountOfInstances > 1) {
+        variant |= Shaders::getFeatureBit(Shaders::SHADER_FEATURE::Instanced);
+    }
+
+    shdr.selectVariant(variant);
+    shdr.useProgram();
+    supplyModelShaderUniforms(shdr, currentCamera, sv);
+
+    if (isAnimated) {
+        bonePalettes.bind(shdr);
+    }
+
+    if (amountOfInstances == 1) {
+        if (isAnimated) {
+            renderModel(*batch.animatedModels[0], shdr);
+        } else {
+            renderModel(*batch.models[0], shdr);
+        }
+        return;
+    }
+
+    if (isAnimated) {
+        instancedRenderer.renderInstances(batch.animatedModels, shdr);
+        return;
+    }
+
+    instancedRenderer.renderInstances(batch.models, shdr, getActiveCuller());
+}
+
+Shaders::ShaderVariant RenderingSystem::getShadowVariant(Engine::SystemVitals& sv) const {
+    if (sv.getPointShadowMap().isActive() || sv.getDirectionalShadowMap().isActive()) {
+        return Shaders::getFeatureBit(Shaders::SHADER_FEATURE::Shadows);
+    }
+
+    return 0;
+}
+
+const OcclusionCuller* RenderingSystem::getActiveCuller() const {
+    switch (Shader::getShaderTask()) {
+    case SHADER_TASK::Normal_Render_Task:
+        return occlusionCullingActive ? &occlusionCuller : nullptr;
+    case SHADER_TASK::Directional_Depth_Task:
+        return cascadeCuller;
+    default:
+        return nullptr;
+    }
+}
+
+void RenderingSystem::renderModel(ModelBase& model, Shader& shader) {
+
+    const OcclusionCuller* culler = getActiveCuller();
+
+    //Animated models have no static bounds to test.
+    if (!culler || model.isAnimatedModel()) {
+        model.renderAll(shader);
+        return;
+    }
+
+    _3DM::Model& staticModel = static_cast<_3DM::Model&>(model);
+
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+
+    for (unsigned int i = 0; i < staticModel.amountOfMeshes(); i++) {
+        if (!staticModel.getMeshBounds(i, boundsMin, boundsMax)) {
+            continue;
+        }
+
+        if (culler->isVisible(boundsMin, boundsMax, staticModel.getMeshTransformation(i))) {
+            staticModel.renderSingleMesh(i, shader);
+        }
+    }
+}
+
+void RenderingSystem::updateOcclusionCulling(Camera& currentCamera) {
+
+    const std::vector<Occluder*> occluders = currentScene->getAllComponentsOfType<Occluder>();
+
+    occlusionCullingActive = false;
+    occlusionCuller.beginFrame(*currentCamera.getProjectionMatrix() * *currentCamera.getViewMatrix());
+
+    for (unsigned int i = 0; i < occluders.size(); i++) {
+        _3DM::Model* model = occluders[i]->getModel();
+
+        if (!occluders[i]->isActive() || !model || !currentScene->isEntityActive(occluders[i]->getEntityID())) {
+            continue;
+        }
+
+        for (unsigned int j = 0; j < model->amountOfMeshes(); j++) {
+            occlusionCuller.rasterizeOccluder(*model->getMeshVertices(j), *model->getMeshIndices(j), occluders[i]->getModelMatrix());
+        }
+
+        occlusionCullingActive = true;
+    }
+
+    if (occlusionCullingActive) {
+        occlusionCuller.buildHierarchy();
+    }
 }
 
 // Render Particles and GUI
@@ -282,23 +690,26 @@ void RenderingSystem::renderOthers(Camera& currentCamera, Engine::SystemVitals&
         Shader* shader = currentScene->getComponent<Shader>(stats->getEntityID());
 
         if (shader && shader->getShaderType() == SHADER_TYPE::GUI) {
-            shader->useProgram();
-            systems->displayStatisticsSystem.render(*shader, *stats);
+            spriteBatch.begin(*shader);
+            systems->displayStatisticsSystem.render(spriteBatch, *stats);
         }
     }
 
     //Only one per scene
     PauseMenu* menu = currentScene->getFirstActiveComponentOfType<PauseMenu>();
-    if (stats) {
+    if (menu) {
 
         Shader* shader = currentScene->getComponent<Shader>(menu->getEntityID());
 
         if (shader && shader->getShaderType() == SHADER_TYPE::GUI) {
-            shader->useProgram();
-            systems->pauseMenuSystem.render(*shader, *menu);
+            spriteBatch.begin(*shader);
+            systems->pauseMenuSystem.render(spriteBatch, *menu);
         }
     }
 
+    //Every gui element of the frame is drawn here, in as few draws as the textures allow.
+    spriteBatch.end();
+
     //Only one per scene
     DirectionalShadowDebugger* dirShadowDbgr = currentScene->getFirstActiveComponentOfType<DirectionalShadowDebugger>();
     if (dirShadowDbgr) {
@@ -321,6 +732,9 @@ void RenderingSystem::renderParticles(Particles& particles, Camera& currentCamer
             case PARTICLE_TYPE::Fountain:
                 systems->fountainParticleSystem.renderParticles(*thisShader, particles);
                 break;
+            case PARTICLE_TYPE::GpuFountain:
+                systems->gpuParticleSystem.renderParticles(*thisShader, particles);
+                break;
             }
         }
     }
@@ -331,6 +745,8 @@ Shader* RenderingSystem::prepareShader(const int32_t& entity, Camera& currentCam
 
     if (thisShader = currentScene->getComponent<Shader>(entity)) {
 
+        thisShader->selectVariant(getShadowVariant(sv));
+
         if (thisShader->getShaderType() == SHADER_TYPE::Default) {
             if (currentScene->isEntityActive(entity)) {
                 thisShader->useProgram();
@@ -351,6 +767,20 @@ Shader* RenderingSystem::prepareShader(const int32_t& entity, Camera& currentCam
     return nullptr;
 }
 
+void RenderingSystem::supplyModelShaderUniforms(Shader& shader, Camera& currentCamera, Engine::SystemVitals& sv) {
+
+    //The shadow maps set the light's matrices on the depth shader themselves, and depth draws need nothing else.
+    if (Shader::isDepthTask()) {
+        return;
+    }
+
+    if (shader.getShaderType() == SHADER_TYPE::Lit) {
+        supplyLitShaderUniforms(shader, currentCamera, sv);
+    } else {
+        supplyDefaultShaderUniforms(shader, currentCamera, sv);
+    }
+}
+
 void RenderingSystem::supplyDefaultShaderUniforms(Shader& shader, Camera& currentCamera, Engine::SystemVitals& sv) {
 
     const GLint& programID = shader.getProgramID();
@@ -375,19 +805,42 @@ void RenderingSystem::supplyLitShaderUniforms(Shader& shader, Camera& currentCam
 
     if (pointLightDepthMap.isActive()) {
 
+        GLfloat scales[PointLightShadowMap::MAX_LIGHTS];
+
+        for (unsigned int i = 0; i < PointLightShadowMap::MAX_LIGHTS; i++) {
+            scales[i] = pointLightDepthMap.getLightScale(i);
+        }
+
         glUniform1f(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::FarPlane), pointLightDepthMap.getFarPlane());
-        glUniform3fv(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::LightPosition), 1, &pointLightDepthMap.getCurrentLightPosition()[0]);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, pointLightDepthMap.getCubeMap());
+        glUniform1i(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::ShadowedPointLights), pointLightDepthMap.getAmountOfLights());
+        glUniform1fv(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::PointShadowScales), PointLightShadowMap::MAX_LIGHTS, scales);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, pointLightDepthMap.getShadowAtlas());
 
     } else {
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        glUniform1i(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::ShadowedPointLights), 0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
     }
 
-    glUniformMatrix4fv(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::LightSpaceMatrix), 1, GL_FALSE, glm::value_ptr(*directionalLightDepthMap.getLightSpaceMatrix()));
-    glUniform1i(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::DirectionalShadowMap), Shaders::DEPTH_MAP_LOCATION_DIRECTIONAL);
+    const unsigned int cascades = DirectionalLightShadowMap::AMOUNT_OF_CASCADES;
+
+    glm::mat4 lightSpaceMatrices[cascades];
+    GLfloat splits[cascades];
+    GLint textureUnits[cascades];
+
+    for (unsigned int i = 0; i < cascades; i++) {
+        lightSpaceMatrices[i] = *directionalLightDepthMap.getLightSpaceMatrix(i);
+        textureUnits[i]       = Shaders::DEPTH_MAP_LOCATION_DIRECTIONAL + i;
+
+        //Without a directional light nothing is shadowed.
+        splits[i] = directionalLightDepthMap.isActive() ? directionalLightDepthMap.getCascadeSplit(i) : 0.0f;
+
+        glActiveTexture(GL_TEXTURE0 + textureUnits[i]);
+        glBindTexture(GL_TEXTURE_2D, directionalLightDepthMap.getDepthMap(i));
+    }
 
-    glActiveTexture(GL_TEXTURE0 + Shaders::DEPTH_MAP_LOCATION_DIRECTIONAL);
-    glBindTexture(GL_TEXTURE_2D, directionalLightDepthMap.getDepthMap());
+    glUniformMatrix4fv(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::LightSpaceMatrices), cascades, GL_FALSE, glm::value_ptr(lightSpaceMatrices[0]));
+    glUniform1fv(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::CascadeSplits), cascades, splits);
+    glUniform1iv(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::DirectionalShadowMap), cascades, textureUnits);
 }
 
 void RenderingSystem::supplyParticleShaderUniforms(Shader& particleShader, Camera& currentCamera, Engine::SystemVitals& sv) {
@@ -1,18 +1,25 @@
 #ifndef RENDERING_SYSTEM_H
 #define RENDERING_SYSTEM_H
 
+#include "BonePaletteBuffer.h"
 #include "Camera.h"
 #include "DirectionalLightShadowMap.h"
+#include "DynamicResolution.h"
 #include "GuiButton.h"
 #include "GuiSprite.h"
 #include "GuiString.h"
+#include "InstancedRenderer.h"
 #include "MainSystemBase.h"
 #include "Model.h"
+#include "OcclusionCuller.h"
+#include "Occluder.h"
 #include "PointLightShadowMap.h"
 #include "Quad.h"
 #include "RenderTexture.h"
 #include "Scene.h"
 #include "Shader.h"
+#include "SpriteBatch.h"
+#include "StaticGeometryBatcher.h"
 
 using _3DM::AnimatedModel;
 using _3DM::Model;
@@ -24,21 +31,71 @@ public:
     void initialize(Scene& scene, Engine::SystemVitals& systemVitals, SubSystems& ssystems) override;
     void render(Engine::SystemVitals& systemVitals);
 
+    //!Gives back the assets the system holds on to between scenes. Called before the GL context is destroyed.
+    void uninitialize();
+
 private:
+    //!Models that share a shader and can be drawn with one instanced draw per mesh.
+    struct ModelBatch {
+        Shader* shader = nullptr;
+        std::vector<_3DM::Model*> models;
+        std::vector<_3DM::AnimatedModel*> animatedModels;
+    };
+
     void
     renderAll(Camera& currentCamera, Engine::SystemVitals& sv);
     void renderDebugging(Camera& currentCamera, Engine::SystemVitals& sv);
+    //!Draws the debug drawer's text where its positions are on screen.
+    void renderDebugText(const Engine::DebugDrawer& debugDrawer, Camera& currentCamera);
+    //!Renders the dynamic models. These are the only shadow casters redrawn every frame.
     void renderModels(Camera& currentCamera, Engine::SystemVitals& sv);
     void renderOthers(Camera& currentCamera, Engine::SystemVitals& sv);
     void renderParticles(Particles& particles, Camera& currentCamera, Engine::SystemVitals& sv);
 
+    //!Rasterizes every active Occluder in the scene and rebuilds the occlusion culler's hierarchy.
+    void updateOcclusionCulling(Camera& currentCamera);
+
+    //!Renders the model. Meshes of static models that fail the occlusion test are skipped.
+    void renderModel(ModelBase& model, Shader& shader);
+
+    //!The culler that applies to the current shader task, or nullptr if nothing should be culled.
+    const OcclusionCuller* getActiveCuller() const;
+
+    //!The Shadows feature while any shadow map is active, lit shaders skip sampling them otherwise.
+    Shaders::ShaderVariant getShadowVariant(Engine::SystemVitals& sv) const;
+
+    //!Groups the active models into batches and uploads the bone palettes of the animated ones.
+    void updateModelBatches();
+
+    //!Reports how big the textures of the dynamic models are on screen, so the TextureHandler streams the mip levels they need.
+    void requestTextureSizes(Camera& currentCamera);
+
+    //!Renders a batch of models, instanced if there is more than one model in the batch.
+    void renderModelBatch(ModelBatch& batch, Camera& currentCamera, Engine::SystemVitals& sv);
+
+    //!Renders the merged static models. Meshes that fail the occlusion test are skipped.
+    void renderStaticGeometry(Camera& currentCamera, Engine::SystemVitals& sv);
+
+    //!Feeds the last frame time to the dynamic resolution and resizes the render texture to the resolution it picked, or to the window.
+    void updateRenderResolution(Engine::SystemVitals& sv);
+
+    void releaseDebugTextFont();
+
     void initializeLights(Shader& litShader, Engine::SystemVitals& sv);
     void initializeModels(Shader& shader, const int32_t& entity);
+    void initializeStaticGeometry();
+
+    //!Turns the merged meshes of static entities off while the entity or its model is inactive.
+    //!Invalidates the static shadow caches if any of them changed.
+    void updateStaticGeometryOwners(Engine::SystemVitals& sv);
 
     //!Prepares and retrieves the first shader found in scene that is associated with entity.
     //!*Does use program.
     Shader* prepareShader(const int32_t& entity, Camera& currentCamera, Engine::SystemVitals& sv);
 
+    //!Supplies the lit or default uniforms for the shader of a model batch or static geometry batch. Does nothing during depth tasks.
+    void supplyModelShaderUniforms(Shader& shader, Camera& currentCamera, Engine::SystemVitals& sv);
+
     void supplyLitShaderUniforms(Shader& shader, Camera& currentCamera, Engine::SystemVitals& sv);
 
     void supplyDefaultShaderUniforms(Shader& shader, Camera& currentCamera, Engine::SystemVitals& sv);
@@ -50,5 +107,50 @@ private:
 
     //! The shader used for the screenQuad.
     Shader screenShader;
+
+    //! Used to skip meshes hidden behind occluders during the normal render task.
+    OcclusionCuller occlusionCuller;
+
+    //! True if there were occluders to rasterize this frame.
+    bool occlusionCullingActive = false;
+
+    //! The culler of the directional shadow cascade being rendered.
+    const OcclusionCuller* cascadeCuller = nullptr;
+
+    //! Used to draw models loaded from the same file with one draw per mesh.
+    InstancedRenderer instancedRenderer;
+
+    //! Rebuilt every frame. Kept as a member to reuse its memory.
+    std::vector<ModelBatch> modelBatches;
+
+    //! The bones of every animated model, uploaded once per frame and read by every pass.
+    BonePaletteBuffer bonePalettes;
+
+    //! Static models merged by shader and textures when the scene loads.
+    StaticGeometryBatcher staticGeometry;
+
+    struct StaticOwner {
+        int32_t entity = -1;
+        bool enabled   = true;
+    };
+
+    //! The entities merged into staticGeometry, and whether their meshes are drawn.
+    std::vector<StaticOwner> staticOwners;
+
+    //! Collects the gui of the frame so it is drawn with a few draws instead of one per quad.
+    SpriteBatch spriteBatch;
+
+    //! Picks the resolution and samples of the render texture.
+    DynamicResolution dynamicResolution;
+
+    //! Draws the gui text of signed distance field fonts, for the sprite batch.
+    Shader distanceFieldShader;
+
+    //! Used to draw the debug drawer's text.
+    Shader debugTextShader;
+    GuiString debugTextString = GuiString(256);
+
+    //! The reference to the debug text's font taken in initialize.
+    Texture* debugTextFont = nullptr;
 };
 #endif
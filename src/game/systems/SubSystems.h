@@ -33,6 +33,7 @@ struct SubSystems {
     DebuggingSystem debuggingSystem;
     DefaultParticleSystem defaultParticleSystem;
     FountainParticleSystem fountainParticleSystem;
+    GpuParticleSystem gpuParticleSystem;
     DirectionalShadowDebuggerSystem directionalShadowDebuggerSystem;
 
 private:
@@ -50,6 +51,7 @@ private:
         &debuggingSystem,
         &defaultParticleSystem,
         &fountainParticleSystem,
+        &gpuParticleSystem,
         &directionalShadowDebuggerSystem
     };
 };
@@ -72,6 +72,9 @@ void UpdatingSystem::update() {
             case PARTICLE_TYPE::Fountain:
                 systems->fountainParticleSystem.updateParticles(*particles);
                 break;
+            case PARTICLE_TYPE::GpuFountain:
+                systems->gpuParticleSystem.updateParticles(*particles);
+                break;
             }
         }
 
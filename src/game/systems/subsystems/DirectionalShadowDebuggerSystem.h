@@ -10,7 +10,7 @@ public:
     void render(DirectionalShadowDebugger& dbgr, const DirectionalLightShadowMap& shadowMap) {
 
         dbgr.depthShader.useProgram();
-        dbgr.depthQuad.render3D(dbgr.depthShader, shadowMap.getDepthMap(), dbgr.quadTransform);
+        dbgr.depthQuad.render3D(dbgr.depthShader, shadowMap.getDepthMap(0), dbgr.quadTransform);
     }
 };
 
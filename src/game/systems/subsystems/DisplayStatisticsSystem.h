@@ -3,13 +3,15 @@
 #define DISPLAY_STATISTICS_SYSTEM_H
 
 #include "DisplayStatistics.h"
+#include "GpuProfiler.h"
+#include "Locator.h"
 #include "SystemBase.h"
 
 class DisplayStatisticsSystem : public SystemBase {
 
 public:
     //TODO: Passing System GUIResizingInformation to a System? What is this?!
-    void fixedUpdate(DisplayStatistics& ds, const Time& time, GUIResizingInformation& guiInfo) {
+    void fixedUpdate(DisplayStatistics& ds, const Time& time, const GpuProfiler& profiler, GUIResizingInformation& guiInfo) {
 
         float unit = guiInfo.getWidthUnit();
 
@@ -21,22 +23,60 @@ public:
             ds.lastUnit = unit;
         }
 
-        double mspf     = floor(100 * time.getMSPF()) / 100;
-        std::string str = std::to_string(mspf);
-        str.erase(str.find_last_not_of('0') + 1, std::string::npos);
+        double mspf = floor(100 * time.getMSPF()) / 100;
 
-        ds.currentMSPF = "MSPF: " + str;
+        const TextureHandler& textures = TextureLocator::getService();
+        const double residentMB        = floor(10.0 * textures.getResidentBytes() / (1024 * 1024)) / 10;
+        const double requestedMB       = floor(10.0 * textures.getRequestedBytes() / (1024 * 1024)) / 10;
+        const double gpuMS             = profiler.isInitialized() ? floor(100 * profiler.getAverageFrameMilliseconds()) / 100 : -1.0;
 
-        if (ds.lastFPS != time.getFPS()) {
-            ds.lastFPS    = time.getFPS();
-            ds.currentFPS = "\nFPS: " + std::to_string(ds.lastFPS);
+        if (ds.lastMSPF == mspf && ds.lastFPS == time.getFPS() && ds.lastResidentMB == residentMB && ds.lastRequestedMB == requestedMB && ds.lastGpuMS == gpuMS) {
+            return;
         }
 
-        ds.guiString.setString(ds.currentMSPF + ds.currentFPS);
+        ds.lastMSPF        = mspf;
+        ds.lastFPS         = time.getFPS();
+        ds.lastResidentMB  = residentMB;
+        ds.lastRequestedMB = requestedMB;
+        ds.lastGpuMS       = gpuMS;
+
+        int length = clampLength(snprintf(ds.text, sizeof(ds.text), "MSPF: %.2f", mspf), sizeof(ds.text));
+
+        //Trailing zeros of the MSPF are trimmed, like std::to_string's output was.
+        while (length > 0 && ds.text[length - 1] == '0') {
+            length--;
+        }
+
+        length += snprintf(ds.text + length, sizeof(ds.text) - length, "\nFPS: %d\nTEX: %.1f/%.1f MB", ds.lastFPS, residentMB, requestedMB);
+        length = clampLength(length, sizeof(ds.text));
+
+        //The GPU time of the frame, followed by its point shadow, directional shadow, main, blit and resolve passes.
+        if (gpuMS >= 0.0) {
+            snprintf(ds.text + length, sizeof(ds.text) - length, "\nGPU: %.2f (%.2f %.2f %.2f %.2f %.2f)", gpuMS,
+                     profiler.getAveragePassMilliseconds(GPU_PASS::PointShadows),
+                     profiler.getAveragePassMilliseconds(GPU_PASS::DirectionalShadows),
+                     profiler.getAveragePassMilliseconds(GPU_PASS::Main),
+                     profiler.getAveragePassMilliseconds(GPU_PASS::MultisampleBlit),
+                     profiler.getAveragePassMilliseconds(GPU_PASS::ScreenResolve));
+        }
+
+        ds.guiString.setString(ds.text);
+    }
+
+    void render(SpriteBatch& batch, DisplayStatistics& ds) {
+        ds.guiString.render(batch);
     }
 
-    void render(Shader& shader, DisplayStatistics& ds) {
-        ds.guiString.render(shader);
+private:
+    //!snprintf returns the length the text would have had, which is past the end of the buffer if it was cut short.
+    static int clampLength(int length, size_t bufferSize) {
+        const int maxLength = static_cast<int>(bufferSize) - 1;
+
+        if (length < 0) {
+            return 0;
+        }
+
+        return length < maxLength ? length : maxLength;
     }
 };
 
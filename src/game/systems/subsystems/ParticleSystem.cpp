@@ -1,5 +1,14 @@
 #include "ParticleSystem.h"
 
+#ifdef PARTICLE_SYSTEM_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+const unsigned int DefaultParticleSystem::PARTICLES_PER_JOB;
+constexpr float GpuParticleSystem::CPU_COMPARISON_TOLERANCE;
+
+WorkerPool DefaultParticleSystem::workers;
+
 //Rendering logic
 void DefaultParticleSystem::renderParticles(Shader& shader, Particles& particles) {
 
@@ -15,12 +24,48 @@ void DefaultParticleSystem::renderParticles(Shader& shader, Particles& particles
         return;
     }
 
-    std::vector<Particle>& particleV = particles.particles;
-
     glBindVertexArray(particles.vertexArrayObject);
 
-    glBindBuffer(GL_ARRAY_BUFFER, particles.instanceBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, particles.renderingSize * sizeof(Particle), &particleV[0], GL_DYNAMIC_DRAW);
+    //Only what the shader reads is written, straight into the buffer.
+    ParticleInstance* instances = static_cast<ParticleInstance*>(particles.instanceStream.allocate(particles.renderingSize * sizeof(ParticleInstance)));
+    if (!instances) {
+        glBindVertexArray(0);
+        return;
+    }
+
+    for (int i = 0; i < particles.renderingSize; i++) {
+        instances[i].position = glm::vec3(particles.positionsX[i], particles.positionsY[i], particles.positionsZ[i]);
+        instances[i].size     = particles.sizes[i];
+        instances[i].color    = glm::vec4(particles.colorsR[i], particles.colorsG[i], particles.colorsB[i], particles.colorsA[i]);
+    }
+
+    particles.instanceStream.commit();
+
+    const GLintptr offset = particles.instanceStream.getOffset();
+
+    glVertexAttribPointer(
+        Shaders::getAttribLocation(Shaders::AttribName::ParticlePosition),
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(ParticleInstance),
+        (GLvoid*)(offset + offsetof(ParticleInstance, position)));
+
+    glVertexAttribPointer(
+        Shaders::getAttribLocation(Shaders::AttribName::ParticleScale),
+        1,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(ParticleInstance),
+        (GLvoid*)(offset + offsetof(ParticleInstance, size)));
+
+    glVertexAttribPointer(
+        Shaders::getAttribLocation(Shaders::AttribName::ParticleColor),
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(ParticleInstance),
+        (GLvoid*)(offset + offsetof(ParticleInstance, color)));
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, particles.getTexture()->getTextureData());
@@ -38,7 +83,6 @@ void DefaultParticleSystem::renderParticles(Shader& shader, Particles& particles
 
 //Ran every fixed frame
 void DefaultParticleSystem::fixedUpdateParticles(Particles& particles) {
-    std::vector<Particle>& particlesV = particles.particles;
 
     //Lets say we want 60 particles per second - pps
 
@@ -52,54 +96,67 @@ void DefaultParticleSystem::fixedUpdateParticles(Particles& particles) {
 
     if (particlesToSpawn > 0) {
 
-        while (particlesToSpawn > 0) {
+        Particle particle;
 
-            if (particles.renderingSize < static_cast<int>(particlesV.size())) {
+        while (particlesToSpawn > 0 && particles.renderingSize < static_cast<int>(particles.getCapacity())) {
 
-                //Get the last particle
-                setParticleToDefault(particlesV[particles.renderingSize], particles);
-                particlesV[particles.renderingSize].lifeTime -= GameInfo::fixedDeltaTime;
+            setParticleToDefault(particle, particles);
+            particle.lifeTime -= GameInfo::fixedDeltaTime;
 
-                particles.renderingSize++;
+            particles.setParticle(particles.renderingSize, particle);
+            particles.renderingSize++;
 
-                particlesToSpawn--;
-
-            } else {
-                break;
-            }
+            particlesToSpawn--;
         }
         particles.newparticles = 0;
     }
-    if (particles.renderingSize > static_cast<int>(particles.particles.size())) {
-        DBG_LOG("DefaultParticleSystem::fixedUpdateParticles renderingSize overflow.\n");
-        particles.renderingSize = particles.particles.size();
-    }
 
-    for (int i = 0; i < particles.renderingSize; i++) {
-        particlesV[i].lifeTime -= GameInfo::fixedDeltaTime;
+    std::vector<float>& lifeTimes = particles.lifeTimes;
+
+    //Dead particles are replaced by the last live one, which is checked next.
+    for (int i = 0; i < particles.renderingSize;) {
+        lifeTimes[i] -= GameInfo::fixedDeltaTime;
 
-        if (particlesV[i].lifeTime <= 0) {
-            hh::swapVal(particlesV[i], particlesV[particles.renderingSize - 1]);
-            particles.renderingSize--;
+        if (lifeTimes[i] <= 0) {
+            particles.removeParticle(i);
+        } else {
+            i++;
         }
     }
 }
 
-//Rand every frame
+//Ran every frame
 void DefaultParticleSystem::updateParticles(Particles& particles) {
-    std::vector<Particle>& particlesV = particles.particles;
 
-    for (int i = 0; i < particles.renderingSize; i++) {
-        performParticleCalculations(particlesV[i], particles);
+    const unsigned int amountOfParticles = static_cast<unsigned int>(particles.renderingSize);
+    const float dt                       = GameInfo::getDeltaTime();
+
+    if (amountOfParticles <= PARTICLES_PER_JOB) {
+        performParticleCalculations(particles, 0, amountOfParticles, dt);
+        return;
     }
+
+    //Large emitters are split into one range per thread, rounded up to a multiple of 4 for the SIMD loops.
+    const unsigned int amountOfJobs    = std::min(WorkerPool::getAmountOfThreads(), (amountOfParticles + PARTICLES_PER_JOB - 1) / PARTICLES_PER_JOB);
+    const unsigned int particlesPerJob = ((amountOfParticles + amountOfJobs - 1) / amountOfJobs + 3) & ~3u;
+
+    workers.run(amountOfJobs, [this, &particles, amountOfParticles, particlesPerJob, dt](unsigned int job) {
+        const unsigned int begin = job * particlesPerJob;
+        const unsigned int end   = std::min(begin + particlesPerJob, amountOfParticles);
+
+        //Rounding the ranges up can leave the last one empty.
+        if (begin < end) {
+            performParticleCalculations(particles, begin, end, dt);
+        }
+    });
 }
 
 //Sets the default position of the particle. Used when a particles is instantiated.
 void DefaultParticleSystem::setParticleToDefault(Particle& particle, Particles& particles) {
 
-    float dt = GameInfo::getDeltaTime();
+    XorShiftRandom& random = particles.random;
 
-    particle.speed = glm::vec3(std::rand() % 10 - 5, std::rand() % 10 - 5, std::rand() % 10 - 5);
+    particle.speed = glm::vec3(random.range(-5, 5), random.range(-5, 5), random.range(-5, 5));
 
     particle.position = particles.emmisionPosition;
     particle.color    = particles.defaultColor;
@@ -108,19 +165,56 @@ void DefaultParticleSystem::setParticleToDefault(Particle& particle, Particles&
 }
 
 //Generally calculations are overridden
-void DefaultParticleSystem::performParticleCalculations(Particle& particle, Particles& particles) {
-    particle.speed += GameInfo::getDeltaTime();
-    particle.position += particle.speed * GameInfo::getDeltaTime();
+void DefaultParticleSystem::performParticleCalculations(Particles& particles, unsigned int begin, unsigned int end, float dt) {
+    float* speedsX    = &particles.speedsX[0];
+    float* speedsY    = &particles.speedsY[0];
+    float* speedsZ    = &particles.speedsZ[0];
+    float* positionsX = &particles.positionsX[0];
+    float* positionsY = &particles.positionsY[0];
+    float* positionsZ = &particles.positionsZ[0];
+
+    unsigned int i = begin;
+
+#ifdef PARTICLE_SYSTEM_USE_SSE
+    const __m128 deltaTime = _mm_set1_ps(dt);
+
+    for (; i + 4 <= end; i += 4) {
+        const __m128 speedX = _mm_add_ps(_mm_loadu_ps(speedsX + i), deltaTime);
+        const __m128 speedY = _mm_add_ps(_mm_loadu_ps(speedsY + i), deltaTime);
+        const __m128 speedZ = _mm_add_ps(_mm_loadu_ps(speedsZ + i), deltaTime);
+
+        _mm_storeu_ps(speedsX + i, speedX);
+        _mm_storeu_ps(speedsY + i, speedY);
+        _mm_storeu_ps(speedsZ + i, speedZ);
+
+        _mm_storeu_ps(positionsX + i, _mm_add_ps(_mm_loadu_ps(positionsX + i), _mm_mul_ps(speedX, deltaTime)));
+        _mm_storeu_ps(positionsY + i, _mm_add_ps(_mm_loadu_ps(positionsY + i), _mm_mul_ps(speedY, deltaTime)));
+        _mm_storeu_ps(positionsZ + i, _mm_add_ps(_mm_loadu_ps(positionsZ + i), _mm_mul_ps(speedZ, deltaTime)));
+    }
+#endif
+
+    //Whatever doesn't fit in groups of 4.
+    for (; i < end; i++) {
+        speedsX[i] += dt;
+        speedsY[i] += dt;
+        speedsZ[i] += dt;
+
+        positionsX[i] += speedsX[i] * dt;
+        positionsY[i] += speedsY[i] * dt;
+        positionsZ[i] += speedsZ[i] * dt;
+    }
 }
 
 //Fountain particle stuff:
 //------------------------
 void FountainParticleSystem::setParticleToDefault(Particle& particle, Particles& particles) {
 
+    XorShiftRandom& random = particles.random;
+
     particle.speed = glm::vec3(
-        hh::getRandomRange(-5, 5),
-        hh::getRandomRange(10 - 2, 10),
-        hh::getRandomRange(-5, 5));
+        random.range(-5, 5),
+        random.range(10 - 2, 10),
+        random.range(-5, 5));
 
     particle.position = particles.emmisionPosition;
     particle.color    = particles.defaultColor;
@@ -128,15 +222,288 @@ void FountainParticleSystem::setParticleToDefault(Particle& particle, Particles&
     particle.lifeTime = particles.defaultLifeTime;
 }
 
-void FountainParticleSystem::performParticleCalculations(Particle& particle, Particles& particles) {
+void FountainParticleSystem::performParticleCalculations(Particles& particles, unsigned int begin, unsigned int end, float dt) {
+    float* speedsX    = &particles.speedsX[0];
+    float* speedsY    = &particles.speedsY[0];
+    float* speedsZ    = &particles.speedsZ[0];
+    float* positionsX = &particles.positionsX[0];
+    float* positionsY = &particles.positionsY[0];
+    float* positionsZ = &particles.positionsZ[0];
+    float* weights    = &particles.weights[0];
+    float* colorsA    = &particles.colorsA[0];
+    float* sizes      = &particles.sizes[0];
+
+    //Wind and gravity are the same for every particle, only the weight differs.
+    const glm::vec3 acceleration = (particles.currentWorldSettings->getWind() + particles.currentWorldSettings->getGravity()) * dt * 0.5f;
+    const float weightScale      = -dt * 0.5f;
+    const float fall             = dt * 5;
+    const float fade             = dt / particles.defaultLifeTime * particles.defaultColor.a;
+    const float growth           = dt * .4f;
+
+    unsigned int i = begin;
+
+#ifdef PARTICLE_SYSTEM_USE_SSE
+    const __m128 deltaTime     = _mm_set1_ps(dt);
+    const __m128 accelerationX = _mm_set1_ps(acceleration.x);
+    const __m128 accelerationY = _mm_set1_ps(acceleration.y);
+    const __m128 accelerationZ = _mm_set1_ps(acceleration.z);
+    const __m128 weightScales  = _mm_set1_ps(weightScale);
+    const __m128 falls         = _mm_set1_ps(fall);
+    const __m128 fades         = _mm_set1_ps(fade);
+    const __m128 growths       = _mm_set1_ps(growth);
+    const __m128 zero          = _mm_setzero_ps();
+
+    for (; i + 4 <= end; i += 4) {
+        const __m128 speedX = _mm_add_ps(_mm_loadu_ps(speedsX + i), accelerationX);
+        const __m128 speedY = _mm_add_ps(_mm_loadu_ps(speedsY + i), _mm_add_ps(accelerationY, _mm_mul_ps(_mm_loadu_ps(weights + i), weightScales)));
+        const __m128 speedZ = _mm_add_ps(_mm_loadu_ps(speedsZ + i), accelerationZ);
+
+        _mm_storeu_ps(positionsX + i, _mm_add_ps(_mm_loadu_ps(positionsX + i), _mm_mul_ps(speedX, deltaTime)));
+        _mm_storeu_ps(positionsY + i, _mm_add_ps(_mm_loadu_ps(positionsY + i), _mm_mul_ps(speedY, deltaTime)));
+        _mm_storeu_ps(positionsZ + i, _mm_add_ps(_mm_loadu_ps(positionsZ + i), _mm_mul_ps(speedZ, deltaTime)));
+
+        _mm_storeu_ps(speedsX + i, speedX);
+        _mm_storeu_ps(speedsY + i, _mm_sub_ps(speedY, falls));
+        _mm_storeu_ps(speedsZ + i, speedZ);
+
+        _mm_storeu_ps(colorsA + i, _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(colorsA + i), fades), zero));
+        _mm_storeu_ps(sizes + i, _mm_add_ps(_mm_loadu_ps(sizes + i), growths));
+    }
+#endif
+
+    //Whatever doesn't fit in groups of 4.
+    for (; i < end; i++) {
+        speedsX[i] += acceleration.x;
+        speedsY[i] += acceleration.y + weights[i] * weightScale;
+        speedsZ[i] += acceleration.z;
+
+        positionsX[i] += speedsX[i] * dt;
+        positionsY[i] += speedsY[i] * dt;
+        positionsZ[i] += speedsZ[i] * dt;
+
+        speedsY[i] -= fall;
+        colorsA[i] = std::max(colorsA[i] - fade, 0.0f);
+        sizes[i] += growth;
+    }
+}
+
+//GPU fountain particle stuff:
+//----------------------------
+GpuParticleSystem::~GpuParticleSystem() {
+    if (!initialized) {
+        return;
+    }
+
+    glDeleteBuffers(1, &spawnBlockBuffer);
+}
+
+void GpuParticleSystem::initializeUpdateShader() {
+    initialized = true;
+
+    updateShader = &ShaderLocator::getService().getShader("particleupdate", "assets/shaders/particle-update.vert", "assets/shaders/empty.frag", SHADER_TYPE::Particle);
+    updateShader->setTransformFeedbackVaryings({ "position_o", "size_o", "speed_o", "lifeTime_o", "color_o" });
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(updateShader->getProgramID(), GL_LINK_STATUS, &linked);
+
+    const GLuint blockIndex = glGetUniformBlockIndex(updateShader->getProgramID(), "ParticleSpawn");
+
+    if (!linked || blockIndex == GL_INVALID_INDEX) {
+        DBG_LOG("The particle update shader could not be created, falling back to the cpu (ParticleSystem.cpp GpuParticleSystem::initializeUpdateShader)\n");
+        return;
+    }
+
+    glUniformBlockBinding(updateShader->getProgramID(), blockIndex, Shaders::PARTICLE_SPAWN_BLOCK_BINDING);
+
+    glGenBuffers(1, &spawnBlockBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, spawnBlockBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(SpawnBlock), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    available = true;
+}
+
+void GpuParticleSystem::fixedUpdateParticles(Particles& particles) {
+    if (!available) {
+        FountainParticleSystem::fixedUpdateParticles(particles);
+    }
+
+    //Particles are spawned and killed by the update shader.
+}
+
+void GpuParticleSystem::updateParticles(Particles& particles) {
+    if (!initialized) {
+        initializeUpdateShader();
+
+#ifdef DEBUG
+        //The update shader mirrors FountainParticleSystem by hand, this catches the two drifting apart.
+        if (available && particles.currentWorldSettings) {
+            compareWithCpu(*particles.currentWorldSettings, 1234u);
+        }
+#endif
+    }
+    if (!available) {
+        FountainParticleSystem::updateParticles(particles);
+        return;
+    }
+    if (particles.areVitalsNull()) {
+        return;
+    }
+
+    particles.initializeGpuState();
+
+    const float dt              = GameInfo::getDeltaTime();
+    const unsigned int capacity = particles.getCapacity();
+
+    particles.newparticles += dt * particles.particlesPerSecond;
+
+    const unsigned int amountToSpawn = std::min(static_cast<unsigned int>(particles.newparticles), capacity);
+    particles.newparticles -= amountToSpawn;
+
+    const SpawnBlock spawn = createSpawnBlock(particles, dt, amountToSpawn, particles.random.next());
+
+    particles.gpuSpawnCursor = (particles.gpuSpawnCursor + amountToSpawn) % capacity;
+
+    stepGpuState(particles, spawn);
+}
+
+GpuParticleSystem::SpawnBlock GpuParticleSystem::createSpawnBlock(const Particles& particles, float dt, unsigned int amountToSpawn, uint32_t seed) const {
+    const Settings& worldSettings = *particles.currentWorldSettings;
+
+    SpawnBlock spawn;
+    spawn.emission        = glm::vec4(particles.emmisionPosition, particles.defaultLifeTime);
+    spawn.spawnColor      = particles.defaultColor;
+    spawn.acceleration    = glm::vec4((worldSettings.getWind() + worldSettings.getGravity()) * 0.5f, dt);
+    spawn.spawnParameters = glm::vec4(particles.defaultScale, particles.defaultColor.a / particles.defaultLifeTime, 0, 0);
+    spawn.spawnSlots      = glm::uvec4(particles.gpuSpawnCursor, amountToSpawn, particles.getCapacity(), seed);
+
+    return spawn;
+}
+
+void GpuParticleSystem::stepGpuState(Particles& particles, const SpawnBlock& spawn) {
+    glBindBuffer(GL_UNIFORM_BUFFER, spawnBlockBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(SpawnBlock), &spawn);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shaders::PARTICLE_SPAWN_BLOCK_BINDING, spawnBlockBuffer);
+
+    const unsigned int source      = particles.currentGpuState;
+    const unsigned int destination = 1 - source;
+
+    updateShader->useProgram();
+
+    //Every particle goes through the vertex shader once, and is written into the other buffer.
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(particles.gpuUpdateArrays[source]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, particles.gpuStateBuffers[destination]);
+
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, particles.getCapacity());
+    glEndTransformFeedback();
+
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    particles.currentGpuState = destination;
+}
+
+float GpuParticleSystem::compareWithCpu(const Settings& worldSettings, uint32_t seed, unsigned int steps, float dt) {
+    if (!initialized) {
+        initializeUpdateShader();
+    }
+    if (!available) {
+        DBG_LOG("The particle update shader isn't available, there is nothing to compare (ParticleSystem.cpp GpuParticleSystem::compareWithCpu)\n");
+        return -1.0f;
+    }
+
+    //Not a multiple of 4, so the CPU's scalar loop is compared too.
+    const unsigned int amountOfParticles = 1001;
+
+    Particles particles(amountOfParticles);
+    particles.initialize(worldSettings);
+    particles.initializeGpuState();
+    particles.setSeed(seed);
 
-    float dt = GameInfo::getDeltaTime();
-    particle.speed += (particles.currentWorldSettings->getWind() + particles.currentWorldSettings->getGravity() + glm::vec3(0, -particle.weight, 0)) * dt * 0.5f;
-    particle.position += particle.speed * dt;
-    particle.speed.y -= dt * 5;
-    particle.color.a -= dt / particles.defaultLifeTime * particles.defaultColor.a;
-    if (particle.color.a < 0) {
-        particle.color.a = 0;
+    //Every particle has to be alive at the end, the CPU doesn't age them outside of fixed updates.
+    particles.setDefaultLifeTime(steps * dt + 1.0f);
+
+    //The particles are spawned on the CPU, the update shader's own random spawns can't be reproduced there.
+    std::vector<GpuParticle> gpuParticles(amountOfParticles);
+    Particle particle;
+
+    for (unsigned int i = 0; i < amountOfParticles; i++) {
+        setParticleToDefault(particle, particles);
+
+        //The update shader doesn't read weights.
+        particle.weight = 0.0f;
+
+        particles.setParticle(i, particle);
+
+        gpuParticles[i].position = particle.position;
+        gpuParticles[i].size     = particle.size;
+        gpuParticles[i].speed    = particle.speed;
+        gpuParticles[i].lifeTime = particle.lifeTime;
+        gpuParticles[i].color    = particle.color;
     }
-    particle.size += dt * .4f;
+
+    particles.renderingSize = amountOfParticles;
+
+    const GLsizeiptr bytes = gpuParticles.size() * sizeof(GpuParticle);
+
+    glBindBuffer(GL_ARRAY_BUFFER, particles.gpuStateBuffers[particles.currentGpuState]);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, &gpuParticles[0]);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    const SpawnBlock spawn = createSpawnBlock(particles, dt, 0, seed);
+
+    for (unsigned int i = 0; i < steps; i++) {
+        stepGpuState(particles, spawn);
+        FountainParticleSystem::performParticleCalculations(particles, 0, amountOfParticles, dt);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, particles.gpuStateBuffers[particles.currentGpuState]);
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, bytes, &gpuParticles[0]);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    float largestDistance = 0.0f;
+
+    for (unsigned int i = 0; i < amountOfParticles; i++) {
+        largestDistance = std::max(largestDistance, glm::distance(gpuParticles[i].position, particles.getParticle(i).position));
+    }
+
+    if (largestDistance > CPU_COMPARISON_TOLERANCE) {
+        DBG_LOG("The GPU fountain drifted %f away from the CPU fountain after %u steps (ParticleSystem.cpp GpuParticleSystem::compareWithCpu)\n", largestDistance, steps);
+    } else {
+        DBG_LOG("The GPU fountain matches the CPU fountain within %f after %u steps.\n", largestDistance, steps);
+    }
+
+    return largestDistance;
+}
+
+void GpuParticleSystem::renderParticles(Shader& shader, Particles& particles) {
+    if (!available) {
+        FountainParticleSystem::renderParticles(shader, particles);
+        return;
+    }
+    if (!particles.gpuStateInitialized) {
+        return;
+    }
+    if (!particles.getTexture()) {
+        DBG_LOG("Particle Texture Is Null! Cannot Render Particles! (ParticleSystem.cpp GpuParticleSystem::renderParticles) \n");
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, particles.getTexture()->getTextureData());
+    glUniform1i(Shaders::getUniformLocation(shader.getProgramID(), Shaders::UniformName::DiffuseTexture), 0);
+
+    GLboolean currentDepth;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &currentDepth);
+
+    //The live particles are spread across the whole buffer, dead ones have a size of 0.
+    glDepthMask(GL_FALSE);
+    glBindVertexArray(particles.gpuRenderArrays[particles.currentGpuState]);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, particles.getCapacity());
+    glDepthMask(currentDepth);
+
+    glBindVertexArray(0);
 }
@@ -3,8 +3,14 @@
 
 #include "Particles.h"
 #include "SystemBase.h"
+#include "WorkerPool.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define PARTICLE_SYSTEM_USE_SSE
+#endif
 
 //The base particle system.
+//Particles are updated in ranges, 4 at a time with SSE, and emitters with many particles are split across the worker pool.
 class DefaultParticleSystem : public SystemBase {
 
 public:
@@ -12,17 +18,80 @@ public:
     virtual void fixedUpdateParticles(Particles& particlesWrapper);
     virtual void updateParticles(Particles& particlesWrapper);
 
+    //!Emitters with more live particles than this are updated on several threads. Must be a multiple of 4.
+    static const unsigned int PARTICLES_PER_JOB = 16384;
+
 protected:
     virtual void setParticleToDefault(Particle& particle, Particles& particles);
-    virtual void performParticleCalculations(Particle& particle, Particles& particles);
+
+    //!Updates the particles from begin up to (not including) end. Ranges shorter than 4 particles skip the SIMD loop.
+    //!Called from several threads at once with separate ranges, so it must only write to the particles in its range.
+    virtual void performParticleCalculations(Particles& particles, unsigned int begin, unsigned int end, float dt);
+
+private:
+    //!Splits the large emitters. Shared by every particle system, which are all updated from the main thread.
+    //!Its threads are only started once an emitter grows past PARTICLES_PER_JOB.
+    static WorkerPool workers;
 };
 
 //A fountain particle system.
 class FountainParticleSystem : public DefaultParticleSystem {
 
-private:
+protected:
     void setParticleToDefault(Particle& particle, Particles& particles) override;
-    void performParticleCalculations(Particle& particle, Particles& particles) override;
+    void performParticleCalculations(Particles& particles, unsigned int begin, unsigned int end, float dt) override;
+};
+
+//A fountain simulated on the GPU. The particles stay in GPU buffers and are advanced by a vertex shader with transform feedback,
+//so the CPU only supplies a small uniform block per emitter every frame. FountainParticleSystem is its CPU reference,
+//and is used instead if the update shader can't be created.
+class GpuParticleSystem : public FountainParticleSystem {
+
+public:
+    //!Keep in mind that the destructor will call glDelete on the spawn buffer if the system was properly initialized.
+    GpuParticleSystem() {}
+    ~GpuParticleSystem();
+
+    GpuParticleSystem(const GpuParticleSystem&) = delete;
+    GpuParticleSystem(GpuParticleSystem&&)      = delete;
+    GpuParticleSystem& operator=(const GpuParticleSystem&) = delete;
+    GpuParticleSystem& operator=(GpuParticleSystem&&) = delete;
+
+    void renderParticles(Shader& shader, Particles& particles) override;
+    void fixedUpdateParticles(Particles& particlesWrapper) override;
+    void updateParticles(Particles& particlesWrapper) override;
+
+    //!Most a particle may drift from its CPU reference in compareWithCpu.
+    static constexpr float CPU_COMPARISON_TOLERANCE = 0.001f;
+
+    //!Checks the update shader against FountainParticleSystem. Both step the same particles, spawned on the CPU from seed,
+    //!for steps frames of dt seconds. Returns the largest distance between the two positions of a particle, or a negative
+    //!value if the update shader isn't available. Uses its own emitter, so the scene's emitters aren't disturbed.
+    float compareWithCpu(const Settings& worldSettings, uint32_t seed, unsigned int steps = 120, float dt = 1.0f / 60.0f);
+
+private:
+    //!Must match the ParticleSpawn block in particle-update.vert (std140).
+    struct SpawnBlock {
+        glm::vec4 emission;
+        glm::vec4 spawnColor;
+        glm::vec4 acceleration;
+        glm::vec4 spawnParameters;
+        glm::uvec4 spawnSlots;
+    };
+
+    //!Loads the update shader and creates the spawn buffer. Sets available to false if the shader fails to link.
+    void initializeUpdateShader();
+
+    SpawnBlock createSpawnBlock(const Particles& particles, float dt, unsigned int amountToSpawn, uint32_t seed) const;
+
+    //!Advances every particle of the emitter by one frame, from its current buffer into the other.
+    void stepGpuState(Particles& particles, const SpawnBlock& spawn);
+
+    Shader* updateShader    = nullptr;
+    GLuint spawnBlockBuffer = 0;
+
+    bool available   = false;
+    bool initialized = false;
 };
 
 #endif
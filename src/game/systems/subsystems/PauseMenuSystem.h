@@ -37,12 +37,12 @@ public:
         }
     }
 
-    void render(Shader& shader, PauseMenu& menu) {
+    void render(SpriteBatch& batch, PauseMenu& menu) {
         if (menu.isShowing) {
             menu.str.setVerticalPadding(-16);
             menu.str.setPosition(glm::vec2(GameInfo::getWindowWidth() - menu.str.getWidthOfString() * 2, GameInfo::getWindowHeight()));
-            menu.resumeButton.render(shader);
-            menu.str.render(shader, "Paused\n:D");
+            menu.resumeButton.render(batch);
+            menu.str.render(batch, "Paused\n:D");
         }
     }
 };
@@ -1,8 +1,348 @@
 #include "gtest/gtest.h"
 #include "engine/main/Application.h"
+#include "AssetRegistry.h"
+#include "DynamicResolution.h"
+#include "OcclusionCuller.h"
+#include "ParticleSystem.h"
+#include "SdfFont.h"
+#include "TextureContainer.h"
+#include "VertexFormat.h"
+#include "XorShiftRandom.h"
+#include <glm/gtc/matrix_transform.hpp>
 
 //Testing scene
 TEST(example, add) {
+}
 
+//Camera at the origin looking down -z with a wall covering the screen at z = -10.
+static void rasterizeTestWall(OcclusionCuller& culler) {
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+    const glm::mat4 view       = glm::lookAt(glm::vec3(0, 0, 0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
 
-}
\ No newline at end of file
+    const std::vector<glm::vec3> vertices { glm::vec3(-50, -50, -10), glm::vec3(50, -50, -10), glm::vec3(50, 50, -10), glm::vec3(-50, 50, -10) };
+    const std::vector<uint32_t> indices { 0, 1, 2, 0, 2, 3 };
+
+    culler.beginFrame(projection * view);
+    culler.rasterizeOccluder(vertices, indices, glm::mat4(1.0f));
+    culler.buildHierarchy();
+}
+
+TEST(occlusionCuller, culls_bounds_behind_occluder) {
+    OcclusionCuller culler;
+    rasterizeTestWall(culler);
+
+    EXPECT_FALSE(culler.isVisible(glm::vec3(-1, -1, -21), glm::vec3(1, 1, -19), glm::mat4(1.0f)));
+    EXPECT_TRUE(culler.isVisible(glm::vec3(-1, -1, -6), glm::vec3(1, 1, -4), glm::mat4(1.0f)));
+
+    //Bounds that straddle the occluder are partially in front of it.
+    EXPECT_TRUE(culler.isVisible(glm::vec3(-1, -1, -11), glm::vec3(1, 1, -9), glm::mat4(1.0f)));
+
+    EXPECT_EQ(culler.getAmountOfTestedBounds(), 3u);
+    EXPECT_EQ(culler.getAmountOfCulledBounds(), 1u);
+}
+
+TEST(occlusionCuller, culls_bounds_outside_of_screen) {
+    OcclusionCuller culler;
+    rasterizeTestWall(culler);
+
+    EXPECT_FALSE(culler.isVisible(glm::vec3(-1, -1, 4), glm::vec3(1, 1, 6), glm::mat4(1.0f)));
+    EXPECT_FALSE(culler.isVisible(glm::vec3(200, -1, -6), glm::vec3(202, 1, -4), glm::mat4(1.0f)));
+
+    //Crossing the near plane is always visible.
+    EXPECT_TRUE(culler.isVisible(glm::vec3(-1, -1, -1), glm::vec3(1, 1, 1), glm::mat4(1.0f)));
+}
+
+TEST(occlusionCuller, hierarchy_keeps_farthest_depth) {
+    OcclusionCuller culler;
+    rasterizeTestWall(culler);
+
+    const unsigned int lastLevel = culler.getAmountOfMipLevels() - 1;
+
+    EXPECT_LT(culler.getDepth(0, 0, 0), 1.0f);
+    EXPECT_NEAR(culler.getDepth(lastLevel, 0, 0), culler.getDepth(0, 0, 0), 0.0001f);
+
+    //Nothing rasterized means nothing is hidden.
+    culler.beginFrame(glm::mat4(1.0f));
+    culler.buildHierarchy();
+
+    EXPECT_FLOAT_EQ(culler.getDepth(lastLevel, 0, 0), 1.0f);
+    EXPECT_TRUE(culler.isVisible(glm::vec3(-0.5f), glm::vec3(0.5f), glm::mat4(1.0f)));
+}
+
+TEST(vertexFormat, octahedral_normals_round_trip) {
+    const glm::vec3 normals[] = { glm::vec3(0, 1, 0), glm::vec3(0, 0, -1), glm::normalize(glm::vec3(-1, 2, -3)), glm::normalize(glm::vec3(0.3f, -0.2f, 0.9f)) };
+
+    for (const glm::vec3& normal : normals) {
+        const glm::vec3 decoded = _3DM::VertexFormat::decodeOctahedral(_3DM::VertexFormat::encodeOctahedral(normal));
+
+        EXPECT_NEAR(decoded.x, normal.x, 0.0001f);
+        EXPECT_NEAR(decoded.y, normal.y, 0.0001f);
+        EXPECT_NEAR(decoded.z, normal.z, 0.0001f);
+    }
+}
+
+TEST(vertexFormat, packed_weights_add_up_to_one) {
+    _3DM::AnimatedMesh animatedMesh;
+    animatedMesh.mesh.vertices.push_back(glm::vec3(0));
+    animatedMesh.weights.push_back(glm::vec4(0.333f, 0.333f, 0.334f, 0));
+    animatedMesh.boneIDs.push_back(glm::vec4(3, 7, 63, 0));
+
+    std::vector<_3DM::PackedAnimatedVertex> packedVertices;
+    _3DM::VertexFormat::packVertices(animatedMesh, packedVertices);
+
+    ASSERT_EQ(packedVertices.size(), 1u);
+
+    const _3DM::PackedAnimatedVertex& vertex = packedVertices[0];
+    EXPECT_EQ(vertex.weights[0] + vertex.weights[1] + vertex.weights[2] + vertex.weights[3], 255);
+    EXPECT_EQ(vertex.boneIDs[2], 63);
+
+    EXPECT_TRUE(_3DM::VertexFormat::canUseShortIndices(0xFFFF));
+    EXPECT_FALSE(_3DM::VertexFormat::canUseShortIndices(0x10000));
+}
+
+TEST(xorShiftRandom, same_seed_gives_same_sequence) {
+    XorShiftRandom a(42);
+    XorShiftRandom b(42);
+
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(a.next(), b.next());
+    }
+
+    //A seed of 0 would only ever return 0.
+    XorShiftRandom zero(0);
+    EXPECT_NE(zero.next(), 0u);
+}
+
+TEST(xorShiftRandom, range_stays_in_bounds) {
+    XorShiftRandom random(7);
+
+    for (int i = 0; i < 10000; i++) {
+        const float value = random.range(-5.0f, 5.0f);
+
+        EXPECT_GE(value, -5.0f);
+        EXPECT_LT(value, 5.0f);
+    }
+}
+
+TEST(sdfFont, distances_are_signed_from_the_edge) {
+    //A 4x4 square in the middle of a 12x12 image.
+    SdfFont::Image coverage;
+    coverage.width  = 12;
+    coverage.height = 12;
+    coverage.pixels.assign(144, 0);
+
+    for (uint32_t y = 4; y < 8; y++) {
+        for (uint32_t x = 4; x < 8; x++) {
+            coverage.pixels[y * 12 + x] = 255;
+        }
+    }
+
+    const std::vector<float> distances = SdfFont::computeSignedDistances(coverage);
+
+    EXPECT_FLOAT_EQ(distances[4 * 12 + 4], 0.5f);
+    EXPECT_FLOAT_EQ(distances[5 * 12 + 5], 1.5f);
+    EXPECT_FLOAT_EQ(distances[5 * 12 + 3], -0.5f);
+    EXPECT_FLOAT_EQ(distances[5 * 12 + 0], -3.5f);
+}
+
+TEST(sdfFont, atlas_keeps_glyph_sizes) {
+    SdfFont::Image coverage;
+    coverage.width  = 16;
+    coverage.height = 16;
+    coverage.pixels.assign(256, 255);
+
+    Glyph glyph;
+    glyph.x         = 2;
+    glyph.xMax      = 9;
+    glyph.y         = 0;
+    glyph.yMax      = 12;
+    glyph.character = 'a';
+
+    SdfFont::AtlasSettings settings;
+    settings.spread     = 2;
+    settings.atlasWidth = 32;
+
+    std::vector<Glyph> glyphs;
+    const SdfFont::Image atlas = SdfFont::buildAtlas(coverage, { glyph }, settings, glyphs);
+
+    ASSERT_EQ(glyphs.size(), 1u);
+    EXPECT_EQ(glyphs[0].getWidth(), glyph.getWidth());
+    EXPECT_EQ(glyphs[0].getHeight(), glyph.getHeight());
+    EXPECT_EQ(atlas.height, 16u);
+
+    //The padding is outside the glyph and its inside is inside.
+    const uint32_t insideRow = atlas.height - glyphs[0].yMax + glyphs[0].getHeight() / 2;
+    EXPECT_LT(atlas.pixels[insideRow * atlas.width], 128);
+    EXPECT_GT(atlas.pixels[insideRow * atlas.width + glyphs[0].x + glyphs[0].getWidth() / 2], 128);
+}
+
+TEST(textureContainer, mip_chain_is_compressed_down_to_one_pixel) {
+    //Solid red, which BC1 stores exactly.
+    std::vector<uint8_t> pixels(8 * 4 * 4);
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        pixels[i + 0] = 255;
+        pixels[i + 3] = 255;
+    }
+
+    TextureContainer::CookSettings settings;
+    settings.format = TextureContainer::FORMAT::BC1;
+
+    const TextureContainer::CookedTexture cooked = TextureContainer::cook(pixels.data(), 8, 4, settings);
+
+    ASSERT_EQ(cooked.levels.size(), 4u);
+    EXPECT_EQ(cooked.levels[0].size, 16u);
+    EXPECT_EQ(cooked.levels[3].width, 1u);
+    EXPECT_EQ(cooked.levels[3].height, 1u);
+    EXPECT_EQ(cooked.levels[3].size, 8u);
+
+    const uint8_t* block = &cooked.data[cooked.levels[3].offset];
+    EXPECT_EQ(block[0] | block[1] << 8, 0xf800);
+}
+
+TEST(textureContainer, written_texture_reads_back) {
+    std::vector<uint8_t> pixels(16 * 16 * 4, 128);
+
+    TextureContainer::CookSettings settings;
+    settings.format = TextureContainer::FORMAT::BC3;
+
+    const TextureContainer::CookedTexture cooked = TextureContainer::cook(pixels.data(), 16, 16, settings);
+    ASSERT_TRUE(TextureContainer::write("texture-container-test.ltex", cooked));
+
+    TextureContainer::CookedTexture read;
+    ASSERT_TRUE(TextureContainer::read("texture-container-test.ltex", read));
+    std::remove("texture-container-test.ltex");
+
+    EXPECT_EQ(read.format, TextureContainer::FORMAT::BC3);
+    ASSERT_EQ(read.levels.size(), cooked.levels.size());
+
+    for (size_t i = 0; i < read.levels.size(); i++) {
+        EXPECT_EQ(read.levels[i].width, cooked.levels[i].width);
+        EXPECT_TRUE(std::equal(
+            cooked.data.begin() + cooked.levels[i].offset,
+            cooked.data.begin() + cooked.levels[i].offset + cooked.levels[i].size,
+            read.data.begin() + read.levels[i].offset));
+    }
+
+    EXPECT_EQ(TextureContainer::getCookedLocation("assets/images/a.png"), "assets/images/a.ltex");
+}
+
+TEST(assetRegistry, freed_handles_stay_invalid) {
+    AssetRegistry<int> registry;
+
+    const AssetHandle<int> first = registry.add("first", new int(1));
+    registry.acquire(first);
+
+    EXPECT_EQ(registry.find("first"), first);
+    EXPECT_FALSE(registry.find("second").isValid());
+    EXPECT_EQ(*registry.get(first), 1);
+
+    EXPECT_EQ(registry.freeUnreferenced(), 0u);
+    registry.release(first);
+    EXPECT_EQ(registry.freeUnreferenced(), 1u);
+
+    //The second asset reuses the slot, the old handle must not resolve to it.
+    const AssetHandle<int> second = registry.add("second", new int(2));
+
+    EXPECT_NE(first, second);
+    EXPECT_EQ(registry.get(first), nullptr);
+    EXPECT_EQ(*registry.get(second), 2);
+    EXPECT_EQ(registry.size(), 1u);
+}
+
+TEST(assetRegistry, adding_a_path_twice_keeps_the_first_asset) {
+    AssetRegistry<int> registry;
+
+    const AssetHandle<int> first = registry.add("first", new int(1));
+
+    EXPECT_EQ(registry.add("first", new int(2)), first);
+    EXPECT_EQ(*registry.get(first), 1);
+    EXPECT_EQ(registry.size(), 1u);
+
+    EXPECT_EQ(registry.freeUnreferenced(), 1u);
+    EXPECT_FALSE(registry.find("first").isValid());
+}
+
+TEST(dynamicResolution, settles_under_budget_without_oscillating) {
+    DynamicResolution resolution;
+    resolution.initialize(8);
+    resolution.setTargetFrameRate(60.0f);
+
+    //A GPU that needs twice the budget at full quality, with the frame time following the amount of pixels and samples.
+    const auto frameTime = [&resolution]() {
+        const double cost = resolution.getScale() * resolution.getScale() * (1.0 + 0.25 * (resolution.getSamples() - 1));
+        return 33.0 * cost / 2.75;
+    };
+
+    for (int i = 0; i < 1000; i++) {
+        resolution.update(frameTime());
+    }
+
+    const unsigned int settledLevel = resolution.getLevel();
+
+    EXPECT_GT(settledLevel, 0u);
+    EXPECT_LT(frameTime(), 1000.0 / 60.0);
+
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_FALSE(resolution.update(frameTime()));
+    }
+
+    //Once the load is gone the full quality comes back.
+    for (int i = 0; i < 3000; i++) {
+        resolution.update(5.0);
+    }
+
+    EXPECT_EQ(resolution.getLevel(), 0u);
+    EXPECT_EQ(resolution.getSamples(), 8u);
+    EXPECT_FLOAT_EQ(resolution.getScale(), 1.0f);
+}
+
+//Exposes the fountain's kernel. Ranges shorter than 4 particles are only updated by the scalar loop.
+class FountainKernelProbe : public FountainParticleSystem {
+
+public:
+    void update(Particles& particles, unsigned int begin, unsigned int end, float dt) {
+        performParticleCalculations(particles, begin, end, dt);
+    }
+};
+
+TEST(particleSystem, simd_fountain_matches_scalar_fountain) {
+    const Settings settings = Settings(glm::vec3(0, -9.8f, 0), glm::vec3(1.5f, 0, -0.5f));
+
+    //Not a multiple of 4, so the SIMD loop leaves particles to the scalar loop.
+    const unsigned int amountOfParticles = 1001;
+    const float dt                       = 1.0f / 60.0f;
+
+    FountainKernelProbe probe;
+    Particles simd(amountOfParticles);
+    Particles scalar(amountOfParticles);
+
+    //Both emitters start from the same seed, so they spawn the same particles.
+    for (Particles* particles : { &simd, &scalar }) {
+        particles->setSeed(1234u);
+        particles->setWorldSettings(settings);
+        particles->setDefaultLifeTime(5);
+        particles->setParticlesPerSecond(amountOfParticles * 60);
+        probe.fixedUpdateParticles(*particles);
+    }
+
+    ASSERT_EQ(simd.getAmountOfParticles(), static_cast<int>(amountOfParticles));
+    ASSERT_EQ(scalar.getAmountOfParticles(), static_cast<int>(amountOfParticles));
+
+    for (int step = 0; step < 30; step++) {
+        probe.update(simd, 0, amountOfParticles, dt);
+
+        for (unsigned int i = 0; i < amountOfParticles; i++) {
+            probe.update(scalar, i, i + 1, dt);
+        }
+    }
+
+    for (unsigned int i = 0; i < amountOfParticles; i++) {
+        const Particle a = simd.getParticle(i);
+        const Particle b = scalar.getParticle(i);
+
+        EXPECT_NEAR(glm::distance(a.position, b.position), 0.0f, 1e-4f);
+        EXPECT_NEAR(glm::distance(a.speed, b.speed), 0.0f, 1e-4f);
+        EXPECT_NEAR(a.color.a, b.color.a, 1e-5f);
+        EXPECT_NEAR(a.size, b.size, 1e-5f);
+    }
+}
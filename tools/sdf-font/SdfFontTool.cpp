@@ -0,0 +1,112 @@
+#define SDL_MAIN_HANDLED
+
+#include "SdfFont.h"
+#include "TextMap.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <cstdio>
+#include <cstdlib>
+
+//Builds a signed distance field font from a bitmap font, see SdfFont.h.
+//
+//Usage: sdf_font_tool <input.FontDat> <input.png> <output.FontDat> <output.png> [spread] [downscale] [atlas width]
+//
+//The input atlas should be rendered downscale times bigger than the output, the bigger it is the smoother the edges.
+//The output png is white, the distance is stored in alpha. Load it with GL_LINEAR filtering and draw it with gui-sdf.frag.
+int main(int argc, char* argv[]) {
+
+    if (argc < 5) {
+        printf("Usage: %s <input.FontDat> <input.png> <output.FontDat> <output.png> [spread] [downscale] [atlas width]\n", argv[0]);
+        return 1;
+    }
+
+    SdfFont::AtlasSettings settings;
+
+    if (argc > 5) {
+        settings.spread = static_cast<uint32_t>(atoi(argv[5]));
+    }
+    if (argc > 6) {
+        settings.downscale = static_cast<uint32_t>(atoi(argv[6]));
+    }
+    if (argc > 7) {
+        settings.atlasWidth = static_cast<uint32_t>(atoi(argv[7]));
+    }
+
+    TextMap textMap;
+    textMap.createMap(argv[1]);
+
+    if (textMap.getGlyphs().empty()) {
+        printf("No glyphs were read from %s\n", argv[1]);
+        return 1;
+    }
+
+    SDL_Surface* loaded = IMG_Load(argv[2]);
+    if (!loaded) {
+        printf("Couldn't load %s: %s\n", argv[2], IMG_GetError());
+        return 1;
+    }
+
+    SDL_Surface* source = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+
+    if (!source) {
+        printf("Couldn't convert %s: %s\n", argv[2], SDL_GetError());
+        return 1;
+    }
+
+    //The glyphs' coverage is read from the alpha channel.
+    SdfFont::Image coverage;
+    coverage.width  = static_cast<uint32_t>(source->w);
+    coverage.height = static_cast<uint32_t>(source->h);
+    coverage.pixels.resize(coverage.width * coverage.height);
+
+    SDL_LockSurface(source);
+    for (uint32_t y = 0; y < coverage.height; y++) {
+        const Uint8* row = static_cast<const Uint8*>(source->pixels) + y * source->pitch;
+
+        for (uint32_t x = 0; x < coverage.width; x++) {
+            coverage.pixels[y * coverage.width + x] = row[x * 4 + 3];
+        }
+    }
+    SDL_UnlockSurface(source);
+    SDL_FreeSurface(source);
+
+    std::vector<Glyph> glyphs;
+    const SdfFont::Image atlas = SdfFont::buildAtlas(coverage, textMap.getGlyphs(), settings, glyphs);
+
+    SDL_Surface* output = SDL_CreateRGBSurfaceWithFormat(0, atlas.width, atlas.height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!output) {
+        printf("Couldn't create the atlas: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_LockSurface(output);
+    for (uint32_t y = 0; y < atlas.height; y++) {
+        Uint8* row = static_cast<Uint8*>(output->pixels) + y * output->pitch;
+
+        for (uint32_t x = 0; x < atlas.width; x++) {
+            row[x * 4 + 0] = 255;
+            row[x * 4 + 1] = 255;
+            row[x * 4 + 2] = 255;
+            row[x * 4 + 3] = atlas.pixels[y * atlas.width + x];
+        }
+    }
+    SDL_UnlockSurface(output);
+
+    const bool savedImage = IMG_SavePNG(output, argv[4]) == 0;
+    SDL_FreeSurface(output);
+
+    if (!savedImage) {
+        printf("Couldn't save %s: %s\n", argv[4], IMG_GetError());
+        return 1;
+    }
+
+    if (!SdfFont::writeFontDat(argv[3], glyphs)) {
+        printf("Couldn't write %s\n", argv[3]);
+        return 1;
+    }
+
+    printf("Wrote %u glyphs into a %ux%u atlas.\n", static_cast<unsigned int>(glyphs.size()), atlas.width, atlas.height);
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+#define SDL_MAIN_HANDLED
+
+#include "TextureContainer.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+//Cooks an image into a .ltex texture, see TextureContainer.h. Run for every png by the cook_textures target.
+//
+//Usage: texture_cooker <input.png> <output.ltex> [--format=auto|bc1|bc3|bc5|rgba] [--no-mips]
+//
+//auto picks bc5 for normal maps (the file name contains "normal"), bc3 for images with any transparency and bc1 otherwise.
+int main(int argc, char* argv[]) {
+
+    if (argc < 3) {
+        printf("Usage: %s <input.png> <output.ltex> [--format=auto|bc1|bc3|bc5|rgba] [--no-mips]\n", argv[0]);
+        return 1;
+    }
+
+    std::string format = "auto";
+    TextureContainer::CookSettings settings;
+
+    for (int i = 3; i < argc; i++) {
+        if (strncmp(argv[i], "--format=", 9) == 0) {
+            format = argv[i] + 9;
+        } else if (strcmp(argv[i], "--no-mips") == 0) {
+            settings.generateMips = false;
+        } else {
+            printf("Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    SDL_Surface* loaded = IMG_Load(argv[1]);
+    if (!loaded) {
+        printf("Couldn't load %s: %s\n", argv[1], IMG_GetError());
+        return 1;
+    }
+
+    SDL_Surface* source = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+
+    if (!source) {
+        printf("Couldn't convert %s: %s\n", argv[1], SDL_GetError());
+        return 1;
+    }
+
+    const uint32_t width  = static_cast<uint32_t>(source->w);
+    const uint32_t height = static_cast<uint32_t>(source->h);
+
+    //Rows are kept from the top, the same order the png loader uploads them in.
+    std::vector<uint8_t> pixels(width * height * 4);
+    bool transparent = false;
+
+    SDL_LockSurface(source);
+    for (uint32_t y = 0; y < height; y++) {
+        const Uint8* row = static_cast<const Uint8*>(source->pixels) + y * source->pitch;
+
+        memcpy(&pixels[y * width * 4], row, width * 4);
+
+        for (uint32_t x = 0; x < width && !transparent; x++) {
+            transparent = row[x * 4 + 3] != 255;
+        }
+    }
+    SDL_UnlockSurface(source);
+    SDL_FreeSurface(source);
+
+    if (format == "auto") {
+        const std::string input = argv[1];
+
+        if (input.find("normal") != std::string::npos || input.find("Normal") != std::string::npos) {
+            format = "bc5";
+        } else {
+            format = transparent ? "bc3" : "bc1";
+        }
+    }
+
+    if (format == "bc1") {
+        settings.format = TextureContainer::FORMAT::BC1;
+    } else if (format == "bc3") {
+        settings.format = TextureContainer::FORMAT::BC3;
+    } else if (format == "bc5") {
+        settings.format = TextureContainer::FORMAT::BC5;
+    } else if (format == "rgba") {
+        settings.format = TextureContainer::FORMAT::RGBA8;
+    } else {
+        printf("Unknown format %s\n", format.c_str());
+        return 1;
+    }
+
+    const TextureContainer::CookedTexture cooked = TextureContainer::cook(pixels.data(), width, height, settings);
+
+    if (!TextureContainer::write(argv[2], cooked)) {
+        printf("Couldn't write %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("Cooked %s as %s, %u levels, %u bytes.\n",
+           argv[1],
+           format.c_str(),
+           static_cast<unsigned int>(cooked.levels.size()),
+           static_cast<unsigned int>(cooked.data.size()));
+
+    return 0;
+}